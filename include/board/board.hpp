@@ -20,6 +20,7 @@
 #include "game_state.hpp"
 #include "move.hpp"
 #include "precomputed_move_data.hpp"
+#include "precomputed_eval_data.hpp"
 
 /**
  * @brief Board
@@ -227,6 +228,30 @@ public:
         return move.type() == MoveType::EN_PASSANT || (!is_empty(move.square_to()));
     }
 
+    /**
+     * @brief in_check
+     * 
+     * calculate if the king of the side to move is attacked.
+     * 
+     * @return True if the side to move is in check
+     * 
+     */
+    bool in_check() const;
+
+    /**
+     * @brief move_gives_check
+     * 
+     * calculate if a move attacks the enemy king, direct checks, discovered checks by sliders and castling checks.
+     * 
+     * @note in castling moves only the rook can give check, from its destination square.
+     * 
+     * @param[in] move chess move, must be legal in the position.
+     * 
+     * @return True if the move gives check
+     * 
+     */
+    bool move_gives_check(Move move) const;
+
     /**
      * @brief load_fen
      * 
@@ -309,6 +334,24 @@ public:
      */
     constexpr inline uint8_t get_piece_counter(Piece piece) const { return game_state.get_piece_counter(piece); }
 
+    /**
+     * @brief material + PST score of the position, updated in every put_piece and remove_piece
+     * 
+     * @note use middlegame_score and endgame_score to unpack the score.
+     * 
+     * @return (int32_t) packed middlegame and endgame score, positive if white is better.
+     * 
+     */
+    constexpr inline int32_t get_pst_score() const { return game_state.pst_score(); }
+
+    /**
+     * @brief sum of the phase weights of the pieces in the board, updated in every put_piece and remove_piece
+     * 
+     * @return (int) game phase, MAX_GAME_PHASE or more in the middlegame and 0 in the endgame.
+     * 
+     */
+    constexpr inline int get_game_phase() const { return game_state.game_phase(); }
+
     /**
      * @brief recalculates all the attack bitboards for each piece in the position
      */
@@ -476,6 +519,11 @@ constexpr inline void Board::put_piece(Piece piece, Square square)
     bitboard_color[static_cast<int>(piece_color)] |= mask;
 
     bitboard_all |= mask;
+
+    game_state.add_pst_score(PrecomputedEvalData::get_piece_score(piece, square) -
+                             PrecomputedEvalData::get_piece_score(previous_piece, square));
+    game_state.set_game_phase(game_state.game_phase() + PrecomputedEvalData::get_phase_weight(piece) -
+                              PrecomputedEvalData::get_phase_weight(previous_piece));
 }
 
 /**
@@ -493,8 +541,12 @@ constexpr inline void Board::remove_piece(Square square)
     assert(square.is_valid());
 
     const uint64_t mask = square.mask();
+    const Piece piece = get_piece(square);
+
+    game_state.add_pst_score(-PrecomputedEvalData::get_piece_score(piece, square));
+    game_state.set_game_phase(game_state.game_phase() - PrecomputedEvalData::get_phase_weight(piece));
 
-    bitboard_piece[static_cast<int>(get_piece(square))] &= ~mask;
+    bitboard_piece[static_cast<int>(piece)] &= ~mask;
     array_piece[square] = Piece::EMPTY;
     bitboard_all &= ~mask;
     bitboard_color[static_cast<int>(ChessColor::WHITE)] &= ~mask;
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file batch_evaluation.hpp
+ * @brief batch evaluation services.
+ *
+ * Material and PST evaluation of many positions at once, for offline labelling of positions.
+ *
+ * https://www.chessprogramming.org/Tapered_Eval
+ * https://www.chessprogramming.org/Population_Count
+ *
+ */
+
+#include "board.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CompactPosition
+ *
+ * Bitboards of the pieces of a position, without the game state.
+ *
+ */
+struct CompactPosition
+{
+    /**
+     * @brief bitboard of each piece, indexed by Piece from W_PAWN to B_KING
+     */
+    uint64_t pieces[NUM_CHESS_PIECES - 1];
+
+    /**
+     * @brief from_board(const Board&)
+     *
+     * @param[in] board chess position.
+     *
+     * @return (CompactPosition) bitboards of the pieces of the board.
+     *
+     */
+    static inline CompactPosition from_board(const Board& board)
+    {
+        CompactPosition position;
+
+        for (int piece = 0; piece < NUM_CHESS_PIECES - 1; piece++) {
+            position.pieces[piece] = board.get_bitboard_piece(static_cast<Piece>(piece));
+        }
+
+        return position;
+    }
+};
+
+/**
+ * @brief BatchEvaluation
+ *
+ * Tapered material and PST evaluation of arrays of positions, the same score the board updates incrementally.
+ *
+ * With AVX-512 the positions are evaluated in groups of BATCH_LANES: each piece bitboard is used as the lane mask
+ * that adds the PST row of the piece, and the scores and game phases (popcounts of the piece bitboards) of the group
+ * are tapered together, one position per 32 bit lane. Without AVX-512 the positions are evaluated one at a time.
+ *
+ * @note the pawn structure, king safety, material imbalance and endgame terms of evaluate_position are not included.
+ *
+ */
+class BatchEvaluation
+{
+public:
+    /**
+     * @brief positions tapered together by the SIMD kernel
+     */
+    static constexpr size_t BATCH_LANES = 16U;
+
+    /**
+     * @brief evaluate(const CompactPosition*, size_t, int*)
+     *
+     * Evaluate an array of positions.
+     *
+     * @param[in] positions positions to evaluate.
+     * @param[in] count number of positions.
+     * @param[out] evaluations evaluation of each position, positive if white is better.
+     *
+     */
+    static void evaluate(const CompactPosition* positions, size_t count, int* evaluations);
+
+    /**
+     * @brief evaluate(const CompactPosition&)
+     *
+     * Evaluate one position, reference of the batch kernel.
+     *
+     * @param[in] position position to evaluate.
+     *
+     * @return (int) evaluation, positive if white is better.
+     *
+     */
+    static int evaluate(const CompactPosition& position);
+
+    BatchEvaluation() = delete;
+    ~BatchEvaluation() = delete;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * @file endgame.hpp
+ * @brief endgame evaluation declaration.
+ *
+ * Specialized evaluation and scaling functions of known endgames, selected by the material table.
+ *
+ * https://www.chessprogramming.org/Endgame
+ * https://www.chessprogramming.org/KPK
+ *
+ */
+
+#include "board.hpp"
+
+/**
+ * @brief evaluation of a won endgame, above any normal evaluation and below the mate scores
+ */
+constexpr int KNOWN_WIN = 10000;
+
+/**
+ * @brief scale factor that keeps the endgame evaluation, the scale factors go from 0 (draw) to 64
+ */
+constexpr int SCALE_FACTOR_NORMAL = 64;
+
+/**
+ * @brief scale factor of a drawn endgame
+ */
+constexpr int SCALE_FACTOR_DRAW = 0;
+
+/**
+ * @brief evaluation of a known endgame, positive if white is better
+ */
+using EndgameEvaluation = int (*)(const Board& board);
+
+/**
+ * @brief scale factor of the endgame evaluation of a known endgame, from 0 (draw) to 64 (no scaling)
+ */
+using ScaleFunction = int (*)(const Board& board);
+
+/**
+ * @brief evaluate_KXK(const Board&)
+ *
+ * Lone king against mating material (KRK, KQK, ...), push the lone king to the edge and the kings together.
+ *
+ * @tparam strong side with the mating material.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KXK(const Board& board);
+
+/**
+ * @brief evaluate_KBNK(const Board&)
+ *
+ * King, bishop and knight against king, push the lone king to a corner of the color of the bishop.
+ *
+ * @tparam strong side with the bishop and the knight.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KBNK(const Board& board);
+
+/**
+ * @brief evaluate_KPK(const Board&)
+ *
+ * King and pawn against king, exact result from the KPK bitbase.
+ *
+ * @tparam strong side with the pawn.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better, 0 if the position is a draw.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KPK(const Board& board);
+
+/**
+ * @brief scale_opposite_bishops(const Board&)
+ *
+ * Only bishops and pawns with one bishop each side, the bishops of opposite colors are drawish.
+ *
+ * @param[in] board chess position.
+ *
+ * @return (int) scale factor.
+ *
+ */
+int scale_opposite_bishops(const Board& board);
+
+/**
+ * @brief kpk_probe(Square, Square, Square, ChessColor)
+ *
+ * Probe the KPK bitbase, white has the king and the pawn.
+ *
+ * @param[in] white_king white king square.
+ * @param[in] pawn white pawn square.
+ * @param[in] black_king black king square.
+ * @param[in] side_to_move side to move.
+ *
+ * @return true if white wins, false if the position is a draw.
+ *
+ */
+bool kpk_probe(Square white_king, Square pawn, Square black_king, ChessColor side_to_move);
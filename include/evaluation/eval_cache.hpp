@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file eval_cache.hpp
+ * @brief evaluation cache declaration.
+ *
+ * Static evaluations cached by the zobrist key of the position.
+ *
+ * https://www.chessprogramming.org/Evaluation_Hash_Table
+ *
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief EvalCache
+ *
+ * Evaluation cache of one search thread. The same positions are evaluated again in the quiescence search
+ * through transpositions and in every iteration of the iterative deepening, the cache returns the
+ * evaluation without evaluating the position again.
+ *
+ * The caches are kept in a TablePool, so the short lived threads of the search reuse the caches.
+ *
+ * @note use EvalCache::thread_cache() to get the cache of the calling thread.
+ *
+ */
+class EvalCache
+{
+public:
+    /**
+     * @brief number of entries in each cache, power of two
+     */
+    static constexpr uint32_t NUM_ENTRIES = 1U << 14;
+
+    /**
+     * @brief thread_cache()
+     *
+     * @return (EvalCache&) evaluation cache of the calling thread.
+     *
+     */
+    static EvalCache& thread_cache();
+
+    /**
+     * @brief probe(uint64_t, int&)
+     *
+     * Get the evaluation of the position if it is in the cache.
+     *
+     * @param[in] zobrist_key zobrist key of the position.
+     * @param[out] eval evaluation of the position, only written on hit.
+     *
+     * @return true if the evaluation is in the cache.
+     *
+     */
+    inline bool probe(uint64_t zobrist_key, int& eval)
+    {
+        const Entry& entry = entries[zobrist_key & (NUM_ENTRIES - 1U)];
+
+        // only this thread writes the counters, no need for atomic increments
+        probeCount.store(probeCount.load(std::memory_order_relaxed) + 1ULL, std::memory_order_relaxed);
+
+        if (entry.key != zobrist_key || !entry.valid) {
+            return false;
+        }
+
+        hitCount.store(hitCount.load(std::memory_order_relaxed) + 1ULL, std::memory_order_relaxed);
+        eval = entry.eval;
+        return true;
+    }
+
+    /**
+     * @brief store(uint64_t, int)
+     *
+     * Store the evaluation of the position, replaces the entry with the same index.
+     *
+     * @param[in] zobrist_key zobrist key of the position.
+     * @param[in] eval evaluation of the position.
+     *
+     */
+    inline void store(uint64_t zobrist_key, int eval)
+    {
+        entries[zobrist_key & (NUM_ENTRIES - 1U)] = Entry{zobrist_key, eval, true};
+    }
+
+    /**
+     * @brief clear_stats()
+     *
+     * Reset the probes and hits of all the caches.
+     *
+     * @note must not be called while a search is running.
+     *
+     */
+    static void clear_stats();
+
+    /**
+     * @brief probes()
+     *
+     * @return (uint64_t) probes of all the caches since the last clear_stats.
+     *
+     */
+    static uint64_t probes();
+
+    /**
+     * @brief hits()
+     *
+     * @return (uint64_t) hits of all the caches since the last clear_stats, each hit is an evaluation saved.
+     *
+     */
+    static uint64_t hits();
+
+    EvalCache();
+
+    EvalCache(const EvalCache&) = delete;
+    EvalCache& operator=(const EvalCache&) = delete;
+
+private:
+    struct Entry
+    {
+        uint64_t key = 0ULL;
+        int eval = 0;
+        bool valid = false;
+    };
+
+    std::vector<Entry> entries;
+
+    // written only by the thread that holds the cache, read by the uci thread for the stats
+    std::atomic<uint64_t> probeCount{0ULL};
+    std::atomic<uint64_t> hitCount{0ULL};
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file eval_weights.hpp
+ * @brief handcrafted evaluation weights.
+ *
+ * Tunable weights of the handcrafted evaluation, indexed by EvalWeight (precomputed_eval_data.hpp).
+ *
+ * @note generated by the EvalTuner tool (src/tools/eval_tuner.cpp), tune the weights again after changing
+ * the evaluation terms.
+ *
+ */
+
+// clang-format off
+
+inline constexpr int EVAL_WEIGHTS[] = {
+    // PST_MIDDLEGAME_WEIGHTS PAWN
+       0,    0,    0,    0,    0,    0,    0,    0,
+      50,   50,   50,   50,   50,   50,   50,   50,
+      10,   10,   20,   30,   30,   20,   10,   10,
+       5,    5,   10,   25,   25,   10,    5,    5,
+       0,    0,    0,   20,   20,    0,   -5,    0,
+       5,   -5,  -10,    0,    0,  -10,   -5,    5,
+       5,   10,   10,  -20,  -20,   10,   10,    5,
+       0,    0,    0,    0,    0,    0,    0,    0,
+    // PST_MIDDLEGAME_WEIGHTS KNIGHT
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+     -40,  -20,    0,    0,    0,    0,  -20,  -40,
+     -30,    0,   10,   15,   15,   10,    0,  -30,
+     -30,    5,   15,   20,   20,   15,    5,  -30,
+     -30,    0,   15,   20,   20,   15,    0,  -30,
+     -30,    5,   10,   15,   15,   10,    5,  -30,
+     -40,  -20,    0,    5,    5,    0,  -20,  -40,
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+    // PST_MIDDLEGAME_WEIGHTS BISHOP
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+     -10,    0,    5,   10,   10,    5,    0,  -10,
+     -10,    5,    5,   10,   10,    5,    5,  -10,
+     -10,    0,   10,   10,   10,   10,    0,  -10,
+     -10,   10,   10,   10,   10,   10,   10,  -10,
+     -10,    5,    0,    0,    0,    0,    5,  -10,
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+    // PST_MIDDLEGAME_WEIGHTS ROOK
+       0,    0,    0,    0,    0,    0,    0,    0,
+       5,   10,   10,   10,   10,   10,   10,    5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+       0,    0,    0,    5,    5,    0,    0,    0,
+    // PST_MIDDLEGAME_WEIGHTS QUEEN
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+     -10,    0,    5,    5,    5,    5,    0,  -10,
+      -5,    0,    5,    5,    5,    5,    0,   -5,
+       0,    0,    5,    5,    5,    5,    0,   -5,
+     -10,    5,    5,    5,    5,    5,    0,  -10,
+     -10,    0,    5,    0,    0,    0,    0,  -10,
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+    // PST_MIDDLEGAME_WEIGHTS KING
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+     -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+     -20,  -30,  -30,  -40,  -40,  -30,  -30,  -20,
+     -10,  -20,  -20,  -20,  -20,  -20,  -20,  -10,
+      20,   20,    0,    0,    0,    0,   20,   20,
+      20,   30,   30,    0,    0,   10,   40,   20,
+    // PST_ENDGAME_WEIGHTS PAWN
+       0,    0,    0,    0,    0,    0,    0,    0,
+      80,   80,   80,   80,   80,   80,   80,   80,
+      50,   50,   50,   50,   50,   50,   50,   50,
+      30,   30,   30,   30,   30,   30,   30,   30,
+      20,   20,   20,   20,   20,   20,   20,   20,
+      10,   10,   10,   10,   10,   10,   10,   10,
+      10,   10,   10,   10,   10,   10,   10,   10,
+       0,    0,    0,    0,    0,    0,    0,    0,
+    // PST_ENDGAME_WEIGHTS KNIGHT
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+     -40,  -20,    0,    0,    0,    0,  -20,  -40,
+     -30,    0,   10,   15,   15,   10,    0,  -30,
+     -30,    5,   15,   20,   20,   15,    5,  -30,
+     -30,    0,   15,   20,   20,   15,    0,  -30,
+     -30,    5,   10,   15,   15,   10,    5,  -30,
+     -40,  -20,    0,    5,    5,    0,  -20,  -40,
+     -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+    // PST_ENDGAME_WEIGHTS BISHOP
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+     -10,    0,    5,   10,   10,    5,    0,  -10,
+     -10,    5,    5,   10,   10,    5,    5,  -10,
+     -10,    0,   10,   10,   10,   10,    0,  -10,
+     -10,   10,   10,   10,   10,   10,   10,  -10,
+     -10,    5,    0,    0,    0,    0,    5,  -10,
+     -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+    // PST_ENDGAME_WEIGHTS ROOK
+       0,    0,    0,    0,    0,    0,    0,    0,
+       5,   10,   10,   10,   10,   10,   10,    5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+      -5,    0,    0,    0,    0,    0,    0,   -5,
+       0,    0,    0,    5,    5,    0,    0,    0,
+    // PST_ENDGAME_WEIGHTS QUEEN
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+     -10,    0,    0,    0,    0,    0,    0,  -10,
+     -10,    0,    5,    5,    5,    5,    0,  -10,
+      -5,    0,    5,    5,    5,    5,    0,   -5,
+       0,    0,    5,    5,    5,    5,    0,   -5,
+     -10,    5,    5,    5,    5,    5,    0,  -10,
+     -10,    0,    5,    0,    0,    0,    0,  -10,
+     -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+    // PST_ENDGAME_WEIGHTS KING
+     -50,  -40,  -30,  -20,  -20,  -30,  -40,  -50,
+     -30,  -20,  -10,    0,    0,  -10,  -20,  -30,
+     -30,  -10,   20,   30,   30,   20,  -10,  -30,
+     -30,  -10,   30,   40,   40,   30,  -10,  -30,
+     -30,  -10,   30,   40,   40,   30,  -10,  -30,
+     -30,  -10,   20,   30,   30,   20,  -10,  -30,
+     -30,  -30,    0,    0,    0,    0,  -30,  -30,
+     -50,  -30,  -30,  -30,  -30,  -30,  -30,  -50,
+    // SAFETY_WEIGHTS
+       0,    0,    1,    2,    3,    5,    7,    9,   12,   15,
+      18,   22,   26,   30,   35,   39,   44,   50,   56,   62,
+      68,   75,   82,   85,   89,   97,  105,  113,  122,  131,
+     140,  150,  169,  180,  191,  202,  213,  225,  237,  248,
+     260,  272,  283,  295,  307,  319,  330,  342,  354,  366,
+     377,  389,  401,  412,  424,  436,  448,  459,  471,  483,
+     494,  500,  500,  500,  500,  500,  500,  500,  500,  500,
+     500,  500,  500,  500,  500,  500,  500,  500,  500,  500,
+     500,  500,  500,  500,  500,  500,  500,  500,  500,  500,
+     500,  500,  500,  500,  500,  500,  500,  500,  500,  500,
+    // KING_SHIELD_WEIGHTS
+       0,   33,   66,  100,
+};
+
+// clang-format on
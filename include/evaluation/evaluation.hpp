@@ -9,19 +9,154 @@
  */
 
 #include "board.hpp"
+#include "algorithm_selection.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
 
 /** 
  * @brief evaluate_position
  *
- * Evaluate chess position.
+ * Evaluate chess position with the evaluation algorithm selected in AlgorithmSelection.
  *  
- * @note None.
+ * @note The evaluation may stop before the expensive terms when the cheap terms already put it far outside
+ * the (alpha, beta) window, the result is then only a bound: >= beta or <= alpha. Use the default window
+ * to get the full evaluation.
  * 
  * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
  *
  * @returns
  *  - (0) if position is evaluated as equal.
  *  - (+) if position is evaluated as white is better.
  *  - (-) if position is evaluated as black is better.
  */
-int evaluate_position(Board& board);
\ No newline at end of file
+int evaluate_position(Board& board, int alpha = std::numeric_limits<int>::min(),
+                      int beta = std::numeric_limits<int>::max());
+
+/**
+ * @brief evaluate_position_dynamic, evaluate_position_safety_mobility, evaluate_position_nnue
+ *
+ * Evaluation algorithms, see evaluate_position.
+ *
+ */
+int evaluate_position_dynamic(Board& board, int alpha, int beta);
+int evaluate_position_safety_mobility(Board& board, int alpha, int beta, bool* lazyExit = nullptr);
+int evaluate_position_nnue(Board& board, int alpha, int beta);
+
+/**
+ * @brief evaluate_position<EvaluationAlgorithm>
+ *
+ * Evaluate chess position with the evaluation algorithm, resolved at compile time.
+ *
+ * @tparam algorithm [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ *
+ * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
+ * @param[out] lazyExit (optional) return true if the evaluation exited lazily and the result is only a bound,
+ *                      a lower bound >= beta or an upper bound <= alpha.
+ *
+ * @returns evaluation of the position, see evaluate_position.
+ */
+template<EvaluationAlgorithm algorithm>
+inline int evaluate_position(Board& board, int alpha = std::numeric_limits<int>::min(),
+                             int beta = std::numeric_limits<int>::max(), bool* lazyExit = nullptr)
+{
+    if constexpr (algorithm == EvaluationAlgorithm::SAFETY_MOBILITY) {
+        return evaluate_position_safety_mobility(board, alpha, beta, lazyExit);
+    }
+
+    if (lazyExit) {
+        *lazyExit = false;
+    }
+
+    if constexpr (algorithm == EvaluationAlgorithm::DYNAMIC) {
+        return evaluate_position_dynamic(board, alpha, beta);
+    }
+    else {
+        return evaluate_position_nnue(board, alpha, beta);
+    }
+}
+
+/**
+ * @brief LazyEvaluation
+ *
+ * Counter of the evaluations that returned before the expensive terms.
+ *
+ */
+class LazyEvaluation
+{
+public:
+    /**
+     * @brief count_exit()
+     *
+     * Count one lazy exit of the evaluation.
+     *
+     */
+    static inline void count_exit() { exitCount.fetch_add(1ULL, std::memory_order_relaxed); }
+
+    /**
+     * @brief exits()
+     *
+     * @return (uint64_t) lazy exits since the last clear_stats.
+     *
+     */
+    static inline uint64_t exits() { return exitCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief clear_stats()
+     *
+     * Reset the lazy exits counter.
+     *
+     */
+    static inline void clear_stats() { exitCount.store(0ULL, std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<uint64_t> exitCount{0ULL};
+};
+
+#ifdef EVAL_TUNING
+/**
+ * @brief EvalTrace
+ *
+ * Terms of the last evaluation of the thread that use the tunable weights of EVAL_WEIGHTS,
+ * only in the EvalTuner build (EVAL_TUNING). The PST terms are read from the board by the tuner.
+ *
+ */
+struct EvalTrace
+{
+    /**
+     * @brief false if the position was evaluated by a known endgame, or the evaluation exited lazily.
+     */
+    bool complete = false;
+
+    /**
+     * @brief index of the SAFETY_WEIGHTS penalization of each king [white, black].
+     */
+    int kingSafety[2] = {0, 0};
+
+    /**
+     * @brief index of the KING_SHIELD_WEIGHTS bonus of each king [white, black].
+     */
+    int kingShield[2] = {0, 0};
+
+    /**
+     * @brief scale factor applied to the endgame evaluation, SCALE_FACTOR_NORMAL if not scaled.
+     */
+    int endgameScale = 0;
+
+    /**
+     * @brief current()
+     *
+     * @return (EvalTrace&) trace of the last evaluation of the calling thread.
+     *
+     */
+    static inline EvalTrace& current()
+    {
+        static thread_local EvalTrace trace;
+        return trace;
+    }
+};
+#endif
@@ -0,0 +1,184 @@
+#pragma once
+
+/**
+ * @file material.hpp
+ * @brief material evaluation declaration.
+ *
+ * Material terms cached in a material table indexed by the material zobrist key.
+ *
+ * https://www.chessprogramming.org/Material_Hash_Table
+ * https://www.chessprogramming.org/Material
+ * https://www.chessprogramming.org/Draw_Evaluation
+ *
+ */
+
+#include "board.hpp"
+#include "endgame.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief MaterialEntry
+ *
+ * Entry of the material table, everything that only depends on the number of pieces of each type.
+ *
+ * @note the arrays are indexed by ChessColor.
+ *
+ */
+struct MaterialEntry
+{
+    /**
+     * @brief material zobrist key of the position
+     */
+    uint64_t key = 0ULL;
+
+    /**
+     * @brief bishop pair and piece values adjusted by the pawns packed score (make_score), positive if white is better
+     */
+    int32_t imbalance = 0;
+
+    /**
+     * @brief evaluation of a known endgame that replaces the normal evaluation, nullptr if none
+     */
+    EndgameEvaluation evaluation = nullptr;
+
+    /**
+     * @brief scale function of a known endgame applied to both sides, nullptr if none
+     */
+    ScaleFunction scaleFunction = nullptr;
+
+    /**
+     * @brief scale factor of the endgame evaluation when the color is winning
+     */
+    uint8_t scaleFactor[2] = {SCALE_FACTOR_NORMAL, SCALE_FACTOR_NORMAL};
+
+    /**
+     * @brief no side can checkmate with this material (KK, KNK)
+     */
+    bool insufficientMaterial = false;
+
+    /**
+     * @brief only kings and bishops, no side can checkmate if all the bishops are in squares of the same color
+     */
+    bool onlyBishops = false;
+
+    /**
+     * @brief is_draw(const Board&)
+     *
+     * @param[in] board chess position with this material.
+     *
+     * @return true if no side can checkmate.
+     *
+     */
+    bool is_draw(const Board& board) const;
+
+    /**
+     * @brief scale_factor(const Board&, ChessColor)
+     *
+     * @param[in] board chess position with this material.
+     * @param[in] strong side that is winning in the endgame evaluation.
+     *
+     * @return (int) scale factor of the endgame evaluation, from 0 (draw) to SCALE_FACTOR_NORMAL.
+     *
+     */
+    inline int scale_factor(const Board& board, ChessColor strong) const
+    {
+        const int scale = scaleFactor[static_cast<int>(strong)];
+        return scaleFunction != nullptr ? std::min(scale, scaleFunction(board)) : scale;
+    }
+};
+
+/**
+ * @brief MaterialTable
+ *
+ * Material table of one search thread. The material changes only with captures and promotions,
+ * so there are few different entries in a search.
+ *
+ * The tables are kept in a TablePool, so the short lived threads of the search reuse the tables.
+ *
+ * @note use MaterialTable::thread_table() to get the table of the calling thread.
+ *
+ */
+class MaterialTable
+{
+public:
+    /**
+     * @brief number of entries in each table, power of two
+     */
+    static constexpr uint32_t NUM_ENTRIES = 1U << 11;
+
+    /**
+     * @brief thread_table()
+     *
+     * @return (MaterialTable&) material table of the calling thread.
+     *
+     */
+    static MaterialTable& thread_table();
+
+    /**
+     * @brief probe(const Board&)
+     *
+     * Get the material entry of the position, the entry is calculated if it is not in the table.
+     *
+     * @param[in] board chess position.
+     *
+     * @return (const MaterialEntry&) material entry of the position.
+     *
+     */
+    inline const MaterialEntry& probe(const Board& board)
+    {
+        const uint64_t key = board.state().get_material_key();
+        MaterialEntry& entry = entries[key & (NUM_ENTRIES - 1U)];
+
+        if (entry.key != key) {
+            calculate_entry(board, entry);
+        }
+        return entry;
+    }
+
+    MaterialTable();
+
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+private:
+    static void calculate_entry(const Board& board, MaterialEntry& entry);
+
+    std::vector<MaterialEntry> entries;
+};
+
+/**
+ * @brief is_draw_by_material(const Board&)
+ *
+ * Dead positions where no side can checkmate, the search returns a draw without expanding them.
+ *
+ * @note only the positions with 4 or less pieces are probed in the material table.
+ *
+ * @param[in] board chess position.
+ *
+ * @return true if no side can checkmate.
+ *
+ */
+inline bool is_draw_by_material(const Board& board)
+{
+    return board.get_num_pieces() <= 4 && MaterialTable::thread_table().probe(board).is_draw(board);
+}
+
+/**
+ * @brief scale_endgame(int, const MaterialEntry&, const Board&)
+ *
+ * Scale the endgame evaluation towards a draw when the winning side can not win with its material.
+ *
+ * @param[in] endgame_eval endgame evaluation, positive if white is better.
+ * @param[in] entry material entry of the position.
+ * @param[in] board chess position.
+ *
+ * @return (int) scaled endgame evaluation.
+ *
+ */
+inline int scale_endgame(int endgame_eval, const MaterialEntry& entry, const Board& board)
+{
+    const ChessColor strong = endgame_eval > 0 ? ChessColor::WHITE : ChessColor::BLACK;
+    return endgame_eval * entry.scale_factor(board, strong) / SCALE_FACTOR_NORMAL;
+}
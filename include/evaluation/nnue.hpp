@@ -0,0 +1,232 @@
+#pragma once
+
+/**
+ * @file nnue.hpp
+ * @brief efficiently updatable neural network declaration.
+ *
+ * HalfKP feature transformer with two quantized hidden layers, evaluated with AVX2, SSSE3 or scalar kernels.
+ *
+ * https://www.chessprogramming.org/NNUE
+ * https://github.com/official-stockfish/nnue-pytorch/blob/master/docs/nnue.md
+ *
+ */
+
+#include "board.hpp"
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+/**
+ * @brief NnueNetwork
+ *
+ * Quantized weights of the network, the layout of the network file.
+ *
+ * Float network, from the point of view of the side to move:
+ *  - h0 = clamp(W0 * halfkp(side to move) + b0, 0, 1) and clamp(W0 * halfkp(other side) + b0, 0, 1)
+ *  - h1 = clamp(W1 * [h0 side to move, h0 other side] + b1, 0, 1)
+ *  - h2 = clamp(W2 * h1 + b2, 0, 1)
+ *  - eval = W3 * h2 + b3, in pawns
+ *
+ * Quantization:
+ *  - W0, b0 : int16, multiplied by ACTIVATION_SCALE.
+ *  - W1, W2, W3 : int8, multiplied by WEIGHT_SCALE.
+ *  - b1, b2, b3 : int32, multiplied by ACTIVATION_SCALE * WEIGHT_SCALE.
+ *
+ * File: MAGIC, the dimensions as uint32 and the arrays in the order of the members, little endian.
+ *
+ */
+struct NnueNetwork
+{
+    /**
+     * @brief HalfKP features, own king square x non king piece x square
+     */
+    static constexpr uint32_t INPUT_DIMENSIONS = 64U * 10U * 64U;
+
+    /**
+     * @brief accumulator size of each perspective
+     */
+    static constexpr uint32_t L1 = 256U;
+
+    /**
+     * @brief size of the first hidden layer
+     */
+    static constexpr uint32_t L2 = 32U;
+
+    /**
+     * @brief size of the second hidden layer
+     */
+    static constexpr uint32_t L3 = 32U;
+
+    /**
+     * @brief quantized value of an activation of 1.0
+     */
+    static constexpr int ACTIVATION_SCALE = 127;
+
+    /**
+     * @brief log2 of WEIGHT_SCALE
+     */
+    static constexpr int WEIGHT_SCALE_BITS = 6;
+
+    /**
+     * @brief quantized value of a hidden layer weight of 1.0
+     */
+    static constexpr int WEIGHT_SCALE = 1 << WEIGHT_SCALE_BITS;
+
+    /**
+     * @brief first bytes of a network file
+     */
+    static constexpr char MAGIC[8] = {'A', 'D', 'C', 'N', 'N', 'U', 'E', '1'};
+
+    alignas(64) int16_t featureBiases[L1];
+    alignas(64) int16_t featureWeights[INPUT_DIMENSIONS * L1];   // [feature][L1]
+    alignas(64) int32_t hidden1Biases[L2];
+    alignas(64) int8_t hidden1Weights[L2 * 2U * L1];   // [output][input]
+    alignas(64) int32_t hidden2Biases[L3];
+    alignas(64) int8_t hidden2Weights[L3 * L2];   // [output][input]
+    int32_t outputBias;
+    alignas(64) int8_t outputWeights[L3];
+
+    /**
+     * @brief read(std::istream&)
+     *
+     * @param[in] stream binary stream of a network file.
+     *
+     * @return true if the stream has a network with the dimensions of this build.
+     *
+     */
+    bool read(std::istream& stream);
+
+    /**
+     * @brief write(std::ostream&)
+     *
+     * @param[out] stream binary stream of the network file.
+     *
+     * @return true if the network has been written.
+     *
+     */
+    bool write(std::ostream& stream) const;
+};
+
+/**
+ * @brief Nnue
+ *
+ * Network loaded with the EvalFile option, evaluated with accumulators cached per thread.
+ *
+ * Each search thread keeps an accumulator for each perspective and king square. The accumulator is updated
+ * incrementally with the pieces that changed since it was last used, so the consecutive positions of the search
+ * cost a few feature updates and a king move never refreshes the whole accumulator.
+ *
+ */
+class Nnue
+{
+public:
+    /**
+     * @brief load(const std::string&)
+     *
+     * Load a network file, the previous network is kept if the file is invalid.
+     *
+     * @note must not be called while a search is running.
+     *
+     * @param[in] path path of the network file.
+     *
+     * @return true if the network has been loaded.
+     *
+     */
+    static bool load(const std::string& path);
+
+    /**
+     * @brief set_network(std::unique_ptr<NnueNetwork>)
+     *
+     * Use a network already in memory.
+     *
+     * @note must not be called while a search is running.
+     *
+     * @param[in] network network to evaluate with.
+     *
+     */
+    static void set_network(std::unique_ptr<NnueNetwork> network);
+
+    /**
+     * @brief is_loaded()
+     *
+     * @return true if there is a network to evaluate with.
+     *
+     */
+    static inline bool is_loaded() { return network != nullptr; }
+
+    /**
+     * @brief file()
+     *
+     * @return (const std::string&) path of the loaded network file, empty if none.
+     *
+     */
+    static inline const std::string& file() { return networkFile; }
+
+    /**
+     * @brief evaluate(const Board&)
+     *
+     * Evaluate the position with the accumulators of the calling thread.
+     *
+     * @note a network must be loaded.
+     *
+     * @param[in] board chess position.
+     *
+     * @return (int) evaluation in centipawns, positive if white is better.
+     *
+     */
+    static int evaluate(const Board& board);
+
+    /**
+     * @brief evaluate_refresh(const Board&)
+     *
+     * Evaluate the position computing the accumulators from scratch, used to verify the incremental updates.
+     *
+     * @note a network must be loaded.
+     *
+     * @param[in] board chess position.
+     *
+     * @return (int) evaluation in centipawns, positive if white is better.
+     *
+     */
+    static int evaluate_refresh(const Board& board);
+
+    /**
+     * @brief feature_index(ChessColor, Square, Piece, Square)
+     *
+     * HalfKP feature of a piece from one perspective, the board is flipped for black.
+     *
+     * @param[in] perspective side whose king defines the features.
+     * @param[in] king_square king square of the perspective side.
+     * @param[in] piece piece, not a king.
+     * @param[in] square square of the piece.
+     *
+     * @return (uint32_t) feature index, 0 <= index < NnueNetwork::INPUT_DIMENSIONS.
+     *
+     */
+    static inline uint32_t feature_index(ChessColor perspective, Square king_square, Piece piece, Square square)
+    {
+        const uint32_t flip = is_white(perspective) ? 0U : 56U;
+        const uint32_t type = static_cast<uint32_t>(piece_to_pieceType(piece));
+        const uint32_t relative_piece = get_color(piece) == perspective ? type : type + 5U;
+
+        return ((king_square.value() ^ flip) * 10U + relative_piece) * 64U + (square.value() ^ flip);
+    }
+
+    /**
+     * @brief generation()
+     *
+     * @return (uint32_t) number of networks loaded, the accumulators of an older network are discarded.
+     *
+     */
+    static inline uint32_t generation() { return networkGeneration.load(std::memory_order_relaxed); }
+
+    Nnue() = delete;
+    ~Nnue() = delete;
+
+private:
+    static inline std::unique_ptr<NnueNetwork> network;
+    static inline std::string networkFile;
+    static inline std::atomic<uint32_t> networkGeneration{0U};
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * @file pawn_structure.hpp
+ * @brief pawn structure evaluation declaration.
+ *
+ * Pawn structure terms cached in a pawn hash table indexed by the pawn zobrist key.
+ *
+ * https://www.chessprogramming.org/Pawn_Structure
+ * https://www.chessprogramming.org/Pawn_Hash_Table
+ *
+ */
+
+#include "board.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief PawnEntry
+ *
+ * Entry of the pawn hash table, pawn structure score and bitboards derived from the pawns.
+ * The king shelter is cached with the king square it was calculated for.
+ *
+ * @note the default entry is the entry of the positions without pawns (pawn key 0), so empty entries of the
+ *       table are never a wrong hit.
+ *
+ * @note the arrays are indexed by ChessColor.
+ *
+ */
+struct PawnEntry
+{
+    /**
+     * @brief pawn zobrist key of the position
+     */
+    uint64_t key = 0ULL;
+
+    /**
+     * @brief passed, isolated, doubled and backward pawns packed score (make_score), positive if white is better
+     */
+    int32_t score = 0;
+
+    /**
+     * @brief files without pawns of the color, bit i set for the col i
+     */
+    uint8_t semiOpenFiles[2] = {0xff, 0xff};
+
+    /**
+     * @brief king square of the cached king shelter, Square::INVALID if not calculated
+     */
+    Square kingSquare[2];
+
+    /**
+     * @brief shelter and storm packed score for the king of the color in kingSquare, positive is good for the color
+     */
+    int32_t kingShelter[2] = {0, 0};
+
+    /**
+     * @brief passed pawns of the color
+     */
+    uint64_t passedPawns[2] = {0ULL, 0ULL};
+
+    /**
+     * @brief squares attacked by the pawns of the color
+     */
+    uint64_t pawnAttacks[2] = {0ULL, 0ULL};
+
+    /**
+     * @brief squares that the pawns of the color can attack if they advance
+     */
+    uint64_t pawnAttacksSpan[2] = {0ULL, 0ULL};
+};
+
+/**
+ * @brief PawnHashTable
+ *
+ * Pawn hash table of one search thread. The pawn structure changes rarely in the search tree,
+ * so most of the positions reuse the pawn entry calculated in a previous position.
+ *
+ * The tables are kept in a TablePool, so the short lived threads of the search reuse the tables.
+ *
+ * @note use PawnHashTable::thread_table() to get the table of the calling thread.
+ *
+ */
+class PawnHashTable
+{
+public:
+    /**
+     * @brief number of entries in each table, power of two
+     */
+    static constexpr uint32_t NUM_ENTRIES = 1U << 13;
+
+    /**
+     * @brief thread_table()
+     *
+     * @return (PawnHashTable&) pawn hash table of the calling thread.
+     *
+     */
+    static PawnHashTable& thread_table();
+
+    /**
+     * @brief probe(const Board&)
+     *
+     * Get the pawn entry of the position, the entry is calculated if it is not in the table.
+     *
+     * @param[in] board chess position.
+     *
+     * @return (PawnEntry&) pawn entry of the position.
+     *
+     */
+    PawnEntry& probe(const Board& board);
+
+    /**
+     * @brief clear_stats()
+     *
+     * Reset the probes and hits of all the tables.
+     *
+     * @note must not be called while a search is running.
+     *
+     */
+    static void clear_stats();
+
+    /**
+     * @brief probes()
+     *
+     * @return (uint64_t) probes of all the tables since the last clear_stats.
+     *
+     */
+    static uint64_t probes();
+
+    /**
+     * @brief hits()
+     *
+     * @return (uint64_t) hits of all the tables since the last clear_stats.
+     *
+     */
+    static uint64_t hits();
+
+    PawnHashTable();
+
+    PawnHashTable(const PawnHashTable&) = delete;
+    PawnHashTable& operator=(const PawnHashTable&) = delete;
+
+private:
+    std::vector<PawnEntry> entries;
+
+    // written only by the thread that holds the table, read by the uci thread for the stats
+    std::atomic<uint64_t> probeCount{0ULL};
+    std::atomic<uint64_t> hitCount{0ULL};
+};
+
+/**
+ * @brief king_shelter(PawnEntry&, const Board&)
+ *
+ * Pawn shield and pawn storm in front of the kings, cached in the entry for the king squares.
+ *
+ * @param[in, out] entry pawn entry of the position.
+ * @param[in] board chess position.
+ *
+ * @return (int32_t) packed score (make_score), positive if white is better.
+ *
+ */
+int32_t king_shelter(PawnEntry& entry, const Board& board);
+
+/**
+ * @brief rooks_on_open_files(const PawnEntry&, const Board&)
+ *
+ * Bonus for the rooks in files without pawns (open) or without own pawns (semi open).
+ *
+ * @param[in] entry pawn entry of the position.
+ * @param[in] board chess position.
+ *
+ * @return (int32_t) packed score (make_score), positive if white is better.
+ *
+ */
+int32_t rooks_on_open_files(const PawnEntry& entry, const Board& board);
@@ -9,8 +9,11 @@
  */
 #include "square.hpp"
 #include "piece.hpp"
+#include "move.hpp"
+#include "eval_weights.hpp"
 #include <array>
 #include <cassert>
+#include <cstdint>
 
 /**
  * @brief Indicates the type of Piece-Square Table (PST) for the middlegame phase.
@@ -28,6 +31,72 @@ constexpr bool PST_TYPE_MIDDLEGAME = false;
  */
 constexpr bool PST_TYPE_ENDGAME = true;
 
+/**
+ * @brief game phase of the full middlegame (8 minor pieces, 4 rooks and 2 queens)
+ */
+constexpr int MAX_GAME_PHASE = 24;
+
+/**
+ * @brief make_score
+ *
+ * Pack a middlegame and an endgame score in one integer, so both are updated with a single addition.
+ *
+ * @param[in] middlegame middlegame score.
+ * @param[in] endgame endgame score.
+ *
+ * @return (int32_t) packed score.
+ */
+constexpr inline int32_t make_score(int middlegame, int endgame)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(endgame) << 16) + middlegame;
+}
+
+/**
+ * @brief middlegame_score
+ *
+ * @param[in] score packed score.
+ *
+ * @return (int) middlegame score.
+ */
+constexpr inline int middlegame_score(int32_t score)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+}
+
+/**
+ * @brief endgame_score
+ *
+ * @param[in] score packed score.
+ *
+ * @return (int) endgame score.
+ */
+constexpr inline int endgame_score(int32_t score)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score + 0x8000) >> 16));
+}
+
+/**
+ * @brief EvalWeight
+ *
+ * Offset of each group of weights in EVAL_WEIGHTS (eval_weights.hpp), the weights tuned by the EvalTuner tool.
+ *
+ * PST_MIDDLEGAME_WEIGHTS : [PieceType][64] middlegame PST of each piece type, from the white side, a8 first.
+ * PST_ENDGAME_WEIGHTS : [PieceType][64] endgame PST of each piece type, from the white side, a8 first.
+ * SAFETY_WEIGHTS : [100] king safety penalization by attacks to the king danger zone.
+ * KING_SHIELD_WEIGHTS : [4] king shield bonus by pawns in front of the king.
+ *
+ */
+enum EvalWeight : int
+{
+    PST_MIDDLEGAME_WEIGHTS = 0,
+    PST_ENDGAME_WEIGHTS = PST_MIDDLEGAME_WEIGHTS + (NUM_CHESS_PIECE_TYPES - 1) * 64,
+    SAFETY_WEIGHTS = PST_ENDGAME_WEIGHTS + (NUM_CHESS_PIECE_TYPES - 1) * 64,
+    KING_SHIELD_WEIGHTS = SAFETY_WEIGHTS + 100,
+    NUM_EVAL_WEIGHTS = KING_SHIELD_WEIGHTS + 4
+};
+
+static_assert(std::size(EVAL_WEIGHTS) == NUM_EVAL_WEIGHTS, "eval_weights.hpp does not match EvalWeight");
+
 /**
  * @brief PrecomputedEvalData
  *
@@ -48,16 +117,13 @@ public:
      * @param[in] piece piece to get the value
      * @param[in] square piece square
      * 
-     * @return int PIECE_SQUARE_TABLE[piece][square]
+     * @return int PST value of the piece in the square
      */
     template<bool PST_TYPE>
     static inline int get_piece_square_table(Piece piece, Square square)
     {
         assert(PST_TYPE == PST_TYPE_MIDDLEGAME || PST_TYPE == PST_TYPE_ENDGAME);
 
-        assert(KING_PIECE_SQUARE_TABLE[pst_index_sq(Move::castle_white_king().square_to(), ChessColor::WHITE)] ==
-               KING_PIECE_SQUARE_TABLE[pst_index_sq(Move::castle_black_king().square_to(), ChessColor::BLACK)]);
-
         assert(square.is_valid());
         assert(is_valid_piece(piece));
 
@@ -67,27 +133,56 @@ public:
         assert(piece_type != PieceType::EMPTY);
         assert(is_valid_color(color));
 
-        const int index_sq = pst_index_sq(square, color);
+        return EVAL_WEIGHTS[pst_weight_index<PST_TYPE>(static_cast<int>(piece_type), pst_index_sq(square, color))];
+    }
+    /**
+     * @brief get the material + PST score of a piece in a square
+     * 
+     * @note white pieces are positive and black pieces negative, Piece::EMPTY is 0.
+     * 
+     * @param[in] piece piece to get the score
+     * @param[in] square piece square
+     * 
+     * @return (int32_t) make_score(raw_value + PST middlegame, raw_value + PST endgame)
+     */
+    static constexpr inline int32_t get_piece_score(Piece piece, Square square)
+    {
+        assert(square.is_valid());
+        assert(is_valid_piece(piece));
+
+        return PIECE_SCORE[static_cast<int>(piece)][square.value()];
+    }
 
-        if constexpr (PST_TYPE == PST_TYPE_MIDDLEGAME) {
-            return PIECE_SQUARE_TABLE[static_cast<int>(piece_type)][index_sq];
-        }
-        else {
-            return PIECE_ENDGAME_SQUARE_TABLE[static_cast<int>(piece_type)][index_sq];
-        }
+    /**
+     * @brief get the game phase weight of a piece
+     * 
+     * minor piece weight : 1
+     * rook weight : 2
+     * queen weight : 4
+     * pawn, king and empty weight : 0
+     * 
+     * @param[in] piece selected piece
+     * 
+     * @return (int) PHASE_WEIGHT[piece]
+     */
+    static constexpr inline int get_phase_weight(Piece piece)
+    {
+        assert(is_valid_piece(piece));
+        return PHASE_WEIGHT[static_cast<int>(piece)];
     }
+
     /**
      * @brief calculates the king safety penalization
      * 
      * @param[in] number_of_attackers_to_king_danger_zone number of attackers
      * 
-     * @return (0-500) SAFETY_TABLE[number_of_attackers]
+     * @return (int) SAFETY_WEIGHTS[number_of_attackers]
      */
     static inline int king_safety_penalization(int number_of_attackers_to_king_danger_zone)
     {
         assert(number_of_attackers_to_king_danger_zone >= 0);
         // max of 99 attackers
-        return SAFETY_TABLE[std::min(number_of_attackers_to_king_danger_zone, 99)];
+        return EVAL_WEIGHTS[SAFETY_WEIGHTS + std::min(number_of_attackers_to_king_danger_zone, 99)];
     }
 
     /**
@@ -158,10 +253,52 @@ public:
     static inline int get_safety_table(int number_pieces)
     {
         assert(number_pieces >= 0 && number_pieces < 100);
-        return SAFETY_TABLE[number_pieces];
+        return EVAL_WEIGHTS[SAFETY_WEIGHTS + number_pieces];
     }
 
-private:
+    /**
+     * @brief get_king_shield_bonus
+     *
+     * Get the king shield bonus for a number of pawns in front of the king.
+     *
+     * @param[in] number_of_shield_pawns pawns in the three squares in front of the king.
+     *
+     * @return (int) KING_SHIELD_WEIGHTS[number_of_shield_pawns]
+     */
+    static constexpr inline int get_king_shield_bonus(int number_of_shield_pawns)
+    {
+        assert(number_of_shield_pawns >= 0 && number_of_shield_pawns <= 3);
+        return EVAL_WEIGHTS[KING_SHIELD_WEIGHTS + number_of_shield_pawns];
+    }
+
+    /**
+     * @brief pst_weight_index
+     *
+     * Index in EVAL_WEIGHTS of the PST value of a piece type in a square.
+     *
+     * @tparam PST_TYPE [PST_TYPE_MIDDLEGAME, PST_TYPE_ENDGAME]
+     * @param[in] piece_type piece type, not empty.
+     * @param[in] index_sq square from the point of view of the piece color, see pst_index_sq.
+     *
+     * @return (int) PST_MIDDLEGAME_WEIGHTS or PST_ENDGAME_WEIGHTS + piece_type * 64 + index_sq
+     */
+    template<bool PST_TYPE>
+    static constexpr inline int pst_weight_index(int piece_type, int index_sq)
+    {
+        constexpr int offset = PST_TYPE == PST_TYPE_MIDDLEGAME ? PST_MIDDLEGAME_WEIGHTS : PST_ENDGAME_WEIGHTS;
+        return offset + piece_type * 64 + index_sq;
+    }
+
+    /**
+     * @brief pst_index_sq
+     *
+     * Square of the PST of a color, the PST are written from the white side with a8 first.
+     *
+     * @param[in] sq square of the piece.
+     * @param[in] color color of the piece.
+     *
+     * @return (int) index of the square in the PST.
+     */
     static constexpr inline int pst_index_sq(Square sq, ChessColor color)
     {
         assert(sq.is_valid());
@@ -170,6 +307,34 @@ private:
         return is_white(color) ? ((7 - static_cast<int>(sq.row())) << 3) + static_cast<int>(sq.col()) : sq.value();
     }
 
+private:
+    static constexpr std::array<std::array<int32_t, 64>, NUM_CHESS_PIECES> init_piece_score()
+    {
+        std::array<std::array<int32_t, 64>, NUM_CHESS_PIECES> scores {};
+
+        for (int p = 0; p < NUM_CHESS_PIECES; p++) {
+            const Piece piece = static_cast<Piece>(p);
+            if (piece == Piece::EMPTY) {
+                continue;
+            }
+            const ChessColor color = get_color(piece);
+            const int piece_type = static_cast<int>(piece_to_pieceType(piece));
+            const int piece_raw_value = raw_value(piece);
+
+            for (uint8_t sq = 0; sq < NUM_SQUARES; sq++) {
+                const int index_sq = pst_index_sq(Square(sq), color);
+                const int middlegame =
+                    piece_raw_value + EVAL_WEIGHTS[pst_weight_index<PST_TYPE_MIDDLEGAME>(piece_type, index_sq)];
+                const int endgame =
+                    piece_raw_value + EVAL_WEIGHTS[pst_weight_index<PST_TYPE_ENDGAME>(piece_type, index_sq)];
+
+                scores[p][sq] = is_white(color) ? make_score(middlegame, endgame) : make_score(-middlegame, -endgame);
+            }
+        }
+
+        return scores;
+    }
+
     static inline const std::array<std::array<int, 64>, 64> init_chebyshev_distance()
     {
         std::array<std::array<int, 64>, 64> distances;
@@ -236,138 +401,14 @@ private:
 
     // clang-format off
 
-    // https://www.chessprogramming.org/King_Safety
-    static constexpr int SAFETY_TABLE[100] = {
-        0,   0,   1,   2,   3,   5,   7,   9,   12,  15,  18,  22,  26,  30,  35,  39,  44,  50,  56,  62,
-        68,  75,  82,  85,  89,  97,  105, 113, 122, 131, 140, 150, 169, 180, 191, 202, 213, 225, 237, 248,
-        260, 272, 283, 295, 307, 319, 330, 342, 354, 366, 377, 389, 401, 412, 424, 436, 448, 459, 471, 483,
-        494, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500,
-        500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500};
-
-    // https://www.chessprogramming.org/Simplified_Evaluation_Function
-    static constexpr int PAWN_PIECE_SQUARE_TABLE[64] = {
-        0,   0,   0,   0,   0,   0,   0,   0,
-        50,  50,  50,  50,  50,  50,  50,  50,
-        10,  10,  20,  30,  30,  20,  10,  10,
-        5,   5,   10,  25,  25,  10,  5,   5,
-        0,   0,  0,   20,  20,  0,   -5,  0,
-        5,   -5,  -10, 0,   0,   -10, -5,  5,
-        5,   10,  10,  -20, -20, 10,  10,  5,
-        0,   0,   0,   0,   0,   0,   0,   0
-    };
-
-    static constexpr int ROOK_PIECE_SQUARE_TABLE[64] = {
-        0,   0,   0,   0,   0,   0,   0,   0,
-        5,   10,  10,  10,  10,  10,  10,  5,
-        -5,  0,   0,   0,   0,   0,   0,   -5,
-        -5,  0,   0,   0,   0,   0,   0,   -5,
-        -5,  0,   0,   0,   0,   0,   0,   -5,
-        -5,  0,   0,   0,   0,   0,   0,   -5,
-        -5,  0,   0,   0,   0,   0,   0,   -5,
-        0,   0,   0,   5,   5,   0,   0,   0
-    };
-
-    static constexpr int KNIGHT_PIECE_SQUARE_TABLE[64] = {
-        -50, -40, -30, -30, -30, -30, -40, -50,
-        -40, -20, 0,   0,   0,   0,   -20, -40,
-        -30, 0,   10,  15,  15,  10,  0,   -30,
-        -30, 5,   15,  20,  20,  15,  5,   -30,
-        -30, 0,   15,  20,  20,  15,  0,   -30,
-        -30, 5,   10,  15,  15,  10,  5,   -30,
-        -40, -20, 0,   5,   5,   0,   -20, -40,
-        -50, -40, -30, -30, -30, -30, -40, -50
-    };
-
-    static constexpr int BISHOP_PIECE_SQUARE_TABLE[64] = {
-        -20, -10, -10, -10, -10, -10, -10, -20,
-        -10, 0,   0,   0,   0,   0,   0,   -10,
-        -10, 0,   5,   10,  10,  5,   0,   -10,
-        -10, 5,   5,   10,  10,  5,   5,   -10,
-        -10, 0,   10,  10,  10,  10,  0,   -10,
-        -10, 10,  10,  10,  10,  10,  10,  -10,
-        -10, 5,   0,   0,   0,   0,   5,   -10,
-        -20, -10, -10, -10, -10, -10, -10, -20
-    };
-    static constexpr int QUEEN_PIECE_SQUARE_TABLE[64] = {
-        -20, -10, -10, -5,  -5,  -10, -10, -20,
-        -10, 0,   0,   0,   0,   0,   0,   -10,
-        -10, 0,   5,   5,   5,   5,   0,   -10,
-        -5,  0,   5,   5,   5,   5,   0,   -5,
-        0,   0,   5,   5,   5,   5,   0,   -5,
-        -10, 5,   5,   5,   5,   5,   0,   -10, 
-        -10, 0,   5,   0,   0,   0,   0,   -10, 
-        -20, -10, -10, -5,  -5,  -10, -10, -20
-    };
-    static constexpr int KING_PIECE_SQUARE_TABLE[64] = {
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -20, -30, -30, -40, -40, -30, -30, -20,
-        -10, -20, -20, -20, -20, -20, -20, -10,
-        20,  20,  0,   0,   0,   0,   20,  20,
-        20,  30,  30,  0,   0,   10,  40,  20
-    };
-
-    static constexpr int PAWN_ENDGAME_SQUARE_TABLE[64] = {
-        0,   0,   0,   0,   0,   0,   0,   0,
-        80,  80,  80,  80,  80,  80,  80,  80,
-        50,  50,  50,  50,  50,  50,  50,  50,
-        30,  30,  30,  30,  30,  30,  30,  30,
-        20,  20,  20,  20,  20,  20,  20,  20,
-        10,  10,  10,  10,  10,  10,  10,  10,
-        10,  10,  10,  10,  10,  10,  10,  10,
-        0,   0,   0,   0,   0,   0,   0,   0
-    };
-
-    static constexpr int KING_ENDGAME_SQUARE_TABLE[64] = {
-        -50, -40, -30, -20, -20, -30, -40, -50,
-        -30, -20, -10, 0,   0,   -10, -20, -30,
-        -30, -10, 20,  30,  30,  20,  -10, -30,
-        -30, -10, 30,  40,  40,  30,  -10, -30,
-        -30, -10, 30,  40,  40,  30,  -10, -30,
-        -30, -10, 20,  30,  30,  20,  -10, -30,
-        -30, -30, 0,   0,   0,   0,   -30, -30,
-        -50, -30, -30, -30, -30, -30, -30, -50
-    };
-
-    /**
-     * @brief lookup table for each middlegame PST indexed by PieceType
-     * 
-     * 0 : PAWN_PIECE_SQUARE_TABLE
-     * 1 : KNIGHT_PIECE_SQUARE_TABLE
-     * 2 : BISHOP_PIECE_SQUARE_TABLE
-     * 3 : ROOK_PIECE_SQUARE_TABLE
-     * 4 : QUEEN_PIECE_SQUARE_TABLE
-     * 5 : KING_PIECE_SQUARE_TABLE
-     */
-    static constexpr const int* PIECE_SQUARE_TABLE[NUM_CHESS_PIECE_TYPES - 1] = {
-        PAWN_PIECE_SQUARE_TABLE,
-        KNIGHT_PIECE_SQUARE_TABLE,
-        BISHOP_PIECE_SQUARE_TABLE,
-        ROOK_PIECE_SQUARE_TABLE, 
-        QUEEN_PIECE_SQUARE_TABLE,
-        KING_PIECE_SQUARE_TABLE
-    };
-
-    /**
-     * @brief lookup table for each endgame PST indexed by PieceType
-     * 
-     * 0 : PAWN_PIECE_SQUARE_TABLE
-     * 1 : KNIGHT_PIECE_SQUARE_TABLE
-     * 2 : BISHOP_PIECE_SQUARE_TABLE
-     * 3 : ROOK_PIECE_SQUARE_TABLE
-     * 4 : QUEEN_PIECE_SQUARE_TABLE
-     * 5 : KING_ENDGAME_SQUARE_TABLE
-     */
-    static constexpr const int* PIECE_ENDGAME_SQUARE_TABLE[NUM_CHESS_PIECE_TYPES - 1] = {
-        PAWN_ENDGAME_SQUARE_TABLE,
-        KNIGHT_PIECE_SQUARE_TABLE,
-        BISHOP_PIECE_SQUARE_TABLE,
-        ROOK_PIECE_SQUARE_TABLE, 
-        QUEEN_PIECE_SQUARE_TABLE,
-        KING_ENDGAME_SQUARE_TABLE
-    };
+    // W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING, B_PAWN, ..., B_KING, EMPTY
+    static constexpr int PHASE_WEIGHT[NUM_CHESS_PIECES] = {0, 1, 1, 2, 4, 0, 0, 1, 1, 2, 4, 0, 0};
 
     // clang-format on
+
+    // material + PST score of each piece in each square, defined after the class with init_piece_score()
+    static const std::array<std::array<int32_t, 64>, NUM_CHESS_PIECES> PIECE_SCORE;
 };
+
+inline constexpr std::array<std::array<int32_t, 64>, NUM_CHESS_PIECES> PrecomputedEvalData::PIECE_SCORE =
+    PrecomputedEvalData::init_piece_score();
@@ -56,6 +56,48 @@ public:
      */
     constexpr inline void clear() { num_moves = 0; }
 
+    /**
+     * @brief filter
+     * 
+     * Remove in place the moves that do not satisfy the predicate, the order of the kept moves is preserved.
+     * 
+     * @param[in] keep predicate, returns true for the moves to keep.
+     * 
+     */
+    template<typename Predicate>
+    constexpr inline void filter(Predicate keep)
+    {
+        int kept = 0;
+        for (int i = 0; i < num_moves; i++) {
+            if (keep(moves[i])) {
+                moves[kept++] = moves[i];
+            }
+        }
+        num_moves = kept;
+    }
+
+    /**
+     * @brief contains
+     * 
+     * Check if the move is stored in the list.
+     * 
+     * @param[in] move move to find.
+     * 
+     * @return (bool)
+     * @retval TRUE if the move is in the list.
+     * @retval FALSE otherwise.
+     * 
+     */
+    constexpr inline bool contains(Move move) const
+    {
+        for (int i = 0; i < num_moves; i++) {
+            if (moves[i] == move) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * @brief add
      * 
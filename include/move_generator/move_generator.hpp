@@ -10,6 +10,7 @@
 
 #include "board.hpp"
 #include "move_list.hpp"
+#include "algorithm_selection.hpp"
 
 /**
  * @brief MoveGeneratorType
@@ -25,7 +26,7 @@ enum MoveGeneratorType
 /**
  * @brief generate_legal_moves
  * 
- * Calculate all the legal moves in the chess position.
+ * Calculate all the legal moves in the chess position with the move generator selected in AlgorithmSelection.
  * 
  * @param[out] moves move list.
  * @param[in] board chess position.
@@ -34,3 +35,38 @@ enum MoveGeneratorType
  */
 template<MoveGeneratorType genType>
 void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck = nullptr);
+
+/**
+ * @brief generate_legal_moves_basic, generate_legal_moves_magic_bitboards
+ *
+ * Move generator algorithms, see generate_legal_moves.
+ *
+ */
+template<MoveGeneratorType genType>
+void generate_legal_moves_basic(MoveList& moves, Board& board, bool* inCheck);
+template<MoveGeneratorType genType>
+void generate_legal_moves_magic_bitboards(MoveList& moves, Board& board, bool* inCheck);
+
+/**
+ * @brief generate_legal_moves<MoveGeneratorType, MoveGeneratorAlgorithm>
+ *
+ * Calculate all the legal moves in the chess position with the move generator algorithm, resolved at compile time.
+ *
+ * @tparam genType [ALL_MOVES, ONLY_CAPTURES]
+ * @tparam algorithm [BASIC, MAGIC_BITBOARDS]
+ *
+ * @param[out] moves move list.
+ * @param[in] board chess position.
+ * @param[out] inCheck (optional) return true if the king is in check.
+ *
+ */
+template<MoveGeneratorType genType, MoveGeneratorAlgorithm algorithm>
+inline void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck = nullptr)
+{
+    if constexpr (algorithm == MoveGeneratorAlgorithm::BASIC) {
+        generate_legal_moves_basic<genType>(moves, board, inCheck);
+    }
+    else {
+        generate_legal_moves_magic_bitboards<genType>(moves, board, inCheck);
+    }
+}
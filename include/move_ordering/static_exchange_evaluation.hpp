@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * @file static_exchange_evaluation.hpp
+ * @brief static exchange evaluation services.
+ *
+ * SEE (Static Exchange Evaluation) declarations.
+ *
+ * https://www.chessprogramming.org/Static_Exchange_Evaluation
+ * https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+ *
+ */
+
+#include "board.hpp"
+#include "move.hpp"
+
+/**
+ * @brief static_exchange_evaluation(const Board&, Move)
+ *
+ * Calculates the material balance of the sequence of captures on the destination square of the move,
+ * both sides always recapture with their least valuable attacker and can stop the exchange at any time.
+ *
+ * @note move should be legal in the position.
+ *
+ * @param[in] board chess position.
+ * @param[in] move move to evaluate.
+ *
+ * @return (int) material gained by the side to move (centipawns), negative if the exchange loses material.
+ *
+ */
+int static_exchange_evaluation(const Board& board, Move move);
+
+/**
+ * @brief see_greater_equal(const Board&, Move, int)
+ *
+ * Check if the static exchange evaluation of the move reaches the threshold.
+ *
+ * @param[in] board chess position.
+ * @param[in] move move to evaluate.
+ * @param[in] threshold minimum material balance (centipawns).
+ *
+ * @return (bool)
+ * @retval TRUE if static_exchange_evaluation(board, move) >= threshold
+ * @retval FALSE otherwise
+ *
+ */
+inline bool see_greater_equal(const Board& board, Move move, int threshold)
+{
+    return static_exchange_evaluation(board, move) >= threshold;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file mate_search.hpp
+ * @brief mate search declarations.
+ *
+ * Dedicated mate finder (go mate) with depth-first proof-number search.
+ *
+ */
+
+#include "search_utils.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief MateSearch
+ *
+ * Mate solver, the attacker only plays checking moves and the defender all the legal moves.
+ * The proof and disproof numbers of the nodes are stored in its own table.
+ *
+ * https://www.chessprogramming.org/Proof-Number_Search
+ * https://www.chessprogramming.org/Proof-number_search#Depth-First_Proof-Number_Search
+ *
+ */
+class MateSearch
+{
+public:
+    /**
+     * @brief max number of moves of the mate, the principal variation must fit in MAX_PLY
+     */
+    static constexpr int MAX_MATE_MOVES = MAX_PLY / 2;
+
+    /**
+     * @brief default size of the mate table in MB
+     */
+    static constexpr int DEFAULT_SIZE_MB = 16;
+
+    /**
+     * @brief search(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
+     *
+     * Search the shortest forced mate in at most limits.mate moves for the side to move.
+     * If a mate is found one result is inserted with the mate score and the mating line,
+     * if there is no mate no result is inserted.
+     *
+     * @param[in] stop stop search signal.
+     * @param[out] results struct where to store the results.
+     * @param[in] board chess position.
+     * @param[in] limits number of moves of the mate (limits.mate) and time manager
+     *
+     */
+    static void search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+
+    /**
+     * @brief find_mate(std::atomic<bool>&, Board&, int, Move*, int&)
+     *
+     * Find the shortest forced mate for the side to move, first mate in 1, then mate in 2 ...
+     *
+     * @param[in] stop stop search signal.
+     * @param[in] board chess position.
+     * @param[in] max_moves max number of moves of the mate (1 <= max_moves <= MAX_MATE_MOVES).
+     * @param[out] pv mating line, at least MAX_PLY moves.
+     * @param[out] pv_length number of moves of the mating line.
+     *
+     * @return (int) number of moves of the mate, 0 if there is no mate in max_moves or the search was stopped.
+     *
+     */
+    static int find_mate(std::atomic<bool>& stop, Board& board, int max_moves, Move* pv, int& pv_length);
+
+    /**
+     * @brief resize(int)
+     *
+     * resize the mate table, the table is cleared.
+     *
+     * @param[in] size_mb new size of the table in MB, must be power of two
+     *
+     */
+    static void resize(int size_mb);
+
+    /**
+     * @brief clear()
+     *
+     * remove all the entries of the mate table.
+     *
+     */
+    static void clear();
+
+    /**
+     * @brief nodes()
+     *
+     * @return (uint64_t) nodes visited in the last call to find_mate.
+     *
+     */
+    static uint64_t nodes() { return nodesVisited; }
+
+    MateSearch() = delete;
+    ~MateSearch() = delete;
+
+private:
+    /**
+     * @brief Entry
+     *
+     * Proof and disproof numbers of a node, the key mixes the zobrist key and the remaining moves.
+     */
+    struct Entry
+    {
+        uint64_t key;
+        uint32_t proof;
+        uint32_t disproof;
+    };
+
+    static std::vector<Entry> entries;
+    static uint64_t nodesVisited;
+    static TimeManager* timeManager;
+
+    template<bool attacker>
+    static void mid(std::atomic<bool>& stop, Board& board, int moves_left, uint32_t threshold_proof,
+                    uint32_t threshold_disproof, uint32_t& proof, uint32_t& disproof);
+
+    template<bool attacker>
+    static bool prove(std::atomic<bool>& stop, Board& board, int moves_left);
+
+    static bool lookup(uint64_t zobrist, int moves_left, uint32_t& proof, uint32_t& disproof);
+
+    static void store(uint64_t zobrist, int moves_left, uint32_t proof, uint32_t disproof);
+
+    static std::vector<Entry> initialization();
+};
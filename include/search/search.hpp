@@ -10,16 +10,37 @@
 #include "search_utils.hpp"
 #include "board.hpp"
 #include "move_list.hpp"
+#include "algorithm_selection.hpp"
 
 /**
- * @brief search(std::atomic<bool>&, SearchResults&, Board&, int32_t)
+ * @brief search(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
  * 
- * Search the best legal move in the chess position.
+ * Search the best legal move in the chess position with the search, evaluation and move generator algorithms
+ * selected in AlgorithmSelection.
  * 
  * @param[in] stop stop search signal.
  * @param[out] results struct where to store the results.
  * @param[in] board chess position.
- * @param[in] max_depth maximum depth of search, default value is INFINITE_DEPTH
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
  * 
  */
-void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint32_t max_depth);
\ No newline at end of file
+void search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+
+/**
+ * @brief search_basic, search_multithread, search_transposition_table, search_tt_reductions
+ *
+ * Search algorithms, see search. Instantiated for every evaluation and move generator algorithm.
+ *
+ * @tparam evaluation [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ * @tparam moveGenerator [BASIC, MAGIC_BITBOARDS]
+ *
+ */
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_basic(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_multithread(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_transposition_table(std::atomic<bool>& stop, SearchResults& results, Board& board,
+                                const SearchLimits& limits);
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_tt_reductions(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
@@ -8,11 +8,18 @@
 
 #include "board.hpp"
 #include "move.hpp"
+#include "move_list.hpp"
+#include "time_manager.hpp"
+#include "transposition_table.hpp"
+#include "spsc_ring.hpp"
 #include <cstdint>
 #include <limits>
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 #ifdef _MSC_VER
 #include <xmmintrin.h> // For _mm_prefetch
 #endif
@@ -52,6 +59,29 @@ constexpr int MATE_THRESHOLD = MATE_IN_ONE_SCORE - 1000U;
  */
 constexpr int MAX_PLY = 64;
 
+/**
+ * @brief Quiescence search depth of the first quiescence ply.
+ *
+ * At this depth the quiet moves that give check are also searched, entries are stored in the
+ * transposition table with this depth.
+ */
+constexpr int DEPTH_QS_CHECKS = 0;
+
+/**
+ * @brief Quiescence search depth of the rest of quiescence plies.
+ *
+ * At this depth only captures (or evasions when in check) are searched, entries are stored in the
+ * transposition table with this depth.
+ */
+constexpr int DEPTH_QS_NO_CHECKS = -1;
+
+/**
+ * @brief Search stack frames before the root.
+ *
+ * Sentinel frames so the search can look up to 4 plies back without checking the ply.
+ */
+constexpr int SEARCH_STACK_OFFSET = 4;
+
 /**
  * @brief Initial aspiration window margin.
  *
@@ -59,6 +89,36 @@ constexpr int MAX_PLY = 64;
  */
 constexpr int ASPIRATION_MARGIN = 50;
 
+/**
+ * @brief ProbCut margin.
+ *
+ * This constant defines how far above beta (below alpha for black) a shallow capture search must score
+ * to prune the node with ProbCut (200 cp).
+ */
+constexpr int PROBCUT_MARGIN = 200;
+
+/**
+ * @brief ProbCut margin reduction when improving.
+ *
+ * This constant defines how much the ProbCut margin is reduced when the static evaluation of the side to move
+ * is better than two plies ago (50 cp).
+ */
+constexpr int PROBCUT_IMPROVING_MARGIN = 50;
+
+/**
+ * @brief ProbCut minimum depth.
+ *
+ * This constant defines the minimum remaining depth of a node to try ProbCut.
+ */
+constexpr int PROBCUT_MIN_DEPTH = 5;
+
+/**
+ * @brief ProbCut depth reduction.
+ *
+ * This constant defines the depth reduction of the shallow verification search of ProbCut.
+ */
+constexpr int PROBCUT_REDUCTION = 4;
+
 /**
  * @brief SearchType
  * 
@@ -74,6 +134,461 @@ enum SearchType : int
     MINIMIZE_BLACK = 1
 };
 
+/**
+ * @brief Maximum number of principal variations searched (MultiPV).
+ */
+constexpr int MAX_MULTI_PV = 64;
+
+/**
+ * @brief SearchLimits
+ * 
+ * Parameters of the search sent with the go command.
+ */
+struct SearchLimits
+{
+    /**
+     * @brief Maximum depth of the search.
+     */
+    uint32_t depth;
+
+    /**
+     * @brief Number of principal variations to search (MultiPV).
+     *
+     * The root searches the best line, then the best line without the first move and so on.
+     */
+    int multiPV;
+
+    /**
+     * @brief Root moves to search (searchmoves).
+     *
+     * If empty all the legal moves are searched.
+     */
+    MoveList searchMoves;
+
+    /**
+     * @brief Maximum number of nodes of the search (go nodes), 0 if there is no limit.
+     */
+    uint64_t nodes;
+
+    /**
+     * @brief Search a mate in this number of moves (go mate), 0 for the normal search.
+     */
+    int mate;
+
+    /**
+     * @brief Time manager of the move (go wtime btime movetime), nullptr if there is no time limit.
+     */
+    TimeManager* timeManager;
+
+    /**
+     * @brief Constructor for SearchLimits.
+     *
+     * Infinite depth, one principal variation, all the root moves, no node or time limit and normal search.
+     */
+    SearchLimits() : depth(INF_DEPTH), multiPV(1), searchMoves(), nodes(0ULL), mate(0), timeManager(nullptr) { }
+};
+
+/**
+ * @brief SearchStackFrame
+ * 
+ * Information of one ply of the search, reused by every node searched at that ply.
+ */
+struct SearchStackFrame
+{
+    /**
+     * @brief Move buffer.
+     *
+     * Stores the moves generated in the node.
+     */
+    MoveList moves;
+
+    /**
+     * @brief Move being searched.
+     *
+     * Stores the move of the node that is being searched in the subtree.
+     */
+    Move currentMove;
+
+    /**
+     * @brief Static evaluation of the node.
+     *
+     * Only valid if hasStaticEval is true.
+     */
+    int staticEval;
+
+    /**
+     * @brief Static evaluation available.
+     *
+     * False when the node is in check or the static evaluation was not calculated.
+     */
+    bool hasStaticEval;
+
+    /**
+     * @brief Principal variation of the node.
+     *
+     * Best line found from this ply, row of the triangular PV table.
+     */
+    Move pv[MAX_PLY];
+
+    /**
+     * @brief Number of moves in the principal variation.
+     */
+    int pvLength;
+};
+
+/**
+ * @brief SearchStack
+ * 
+ * Preallocated search frames indexed by ply, from -SEARCH_STACK_OFFSET to MAX_PLY - 1.
+ * 
+ * @note https://www.chessprogramming.org/Search_Stack
+ */
+class SearchStack
+{
+public:
+    /**
+     * @brief SearchStack
+     * 
+     * SearchStack constructor, all the frames are cleared.
+     */
+    SearchStack() { clear(); }
+
+    /**
+     * @brief clear
+     * 
+     * Reset all the frames.
+     */
+    inline void clear()
+    {
+        for (SearchStackFrame& frame : frames) {
+            frame.moves.clear();
+            frame.currentMove = Move::null();
+            frame.staticEval = 0;
+            frame.hasStaticEval = false;
+            frame.pvLength = 0;
+        }
+    }
+
+    /**
+     * @brief operator[]
+     * 
+     * @param[in] ply search ply (-SEARCH_STACK_OFFSET <= ply < MAX_PLY)
+     * 
+     * @return frame of the ply
+     */
+    inline SearchStackFrame& operator[](int ply)
+    {
+        assert(-SEARCH_STACK_OFFSET <= ply && ply < MAX_PLY);
+        return frames[ply + SEARCH_STACK_OFFSET];
+    }
+
+    /**
+     * @brief operator[]
+     * 
+     * @param[in] ply search ply (-SEARCH_STACK_OFFSET <= ply < MAX_PLY)
+     * 
+     * @return frame of the ply
+     */
+    inline const SearchStackFrame& operator[](int ply) const
+    {
+        assert(-SEARCH_STACK_OFFSET <= ply && ply < MAX_PLY);
+        return frames[ply + SEARCH_STACK_OFFSET];
+    }
+
+    /**
+     * @brief update_pv
+     * 
+     * New best move in the node, the principal variation of the ply is the move followed by the principal
+     * variation of the next ply.
+     * 
+     * @note https://www.chessprogramming.org/Triangular_PV-Table
+     * 
+     * @param[in] ply search ply (0 <= ply < MAX_PLY)
+     * @param[in] move new best move
+     */
+    inline void update_pv(int ply, Move move)
+    {
+        SearchStackFrame& frame = (*this)[ply];
+
+        frame.pv[0] = move;
+        frame.pvLength = 1;
+
+        if (ply + 1 < MAX_PLY) {
+            const SearchStackFrame& child = (*this)[ply + 1];
+
+            for (int i = 0; i < child.pvLength && frame.pvLength < MAX_PLY; i++) {
+                frame.pv[frame.pvLength++] = child.pv[i];
+            }
+        }
+    }
+
+    /**
+     * @brief improving
+     * 
+     * Check if the static evaluation of the side to move is better than two plies ago (four plies ago if
+     * the node two plies ago has no static evaluation).
+     * 
+     * @tparam searchType [MAXIMIZE_WHITE, MINIMIZE_BLACK]
+     * 
+     * @param[in] ply search ply
+     * 
+     * @return (bool)
+     * @retval TRUE if the static evaluation is improving, or there is no previous static evaluation.
+     * @retval FALSE if the static evaluation is not improving, or the node has no static evaluation.
+     */
+    template<SearchType searchType>
+    inline bool improving(int ply) const
+    {
+        const SearchStackFrame& current = (*this)[ply];
+
+        if (!current.hasStaticEval) {
+            return false;
+        }
+
+        const SearchStackFrame& previous = (*this)[ply - 2].hasStaticEval ? (*this)[ply - 2] : (*this)[ply - 4];
+
+        if (!previous.hasStaticEval) {
+            return true;
+        }
+
+        return searchType == MAXIMIZE_WHITE ? current.staticEval > previous.staticEval
+                                            : current.staticEval < previous.staticEval;
+    }
+
+private:
+    SearchStackFrame frames[MAX_PLY + SEARCH_STACK_OFFSET];
+};
+
+/**
+ * @brief RootMove
+ * 
+ * Information of a legal move of the root position, kept between the iterations of the search.
+ */
+struct RootMove
+{
+    /**
+     * @brief Root move.
+     */
+    Move move;
+
+    /**
+     * @brief Score of the move in the current iteration.
+     *
+     * Worst evaluation if the move was not searched yet in the iteration.
+     */
+    int score;
+
+    /**
+     * @brief Score of the move in the previous iteration.
+     */
+    int previousScore;
+
+    /**
+     * @brief Nodes spent searching the move.
+     *
+     * Accumulated over all the iterations.
+     */
+    uint64_t nodes;
+
+    /**
+     * @brief Principal variation of the move.
+     *
+     * Only exact for the best move, a bound for the rest.
+     */
+    Move pv[MAX_PLY];
+
+    /**
+     * @brief Number of moves in the principal variation.
+     */
+    int pvLength;
+};
+
+/**
+ * @brief RootMoves
+ * 
+ * Legal moves of the root position, searched in the order of the previous iteration results.
+ */
+class RootMoves
+{
+public:
+    /**
+     * @brief init
+     * 
+     * Fill the root moves, the order of the list is the order of the first iteration.
+     * 
+     * @param[in] moves legal moves of the root position.
+     * @param[in] search_moves moves to search (searchmoves), if empty all the legal moves are searched.
+     * @param[in] multi_pv number of principal variations of the search (MultiPV).
+     */
+    inline void init(const MoveList& moves, const MoveList& search_moves, int multi_pv = 1)
+    {
+        rootMoves.clear();
+        rootMoves.reserve(moves.size());
+        pvIndex = 0;
+        multiPV = multi_pv;
+        restricted = false;
+
+        for (int i = 0; i < moves.size(); i++) {
+
+            if (search_moves.size() > 0 && !search_moves.contains(moves[i])) {
+                restricted = true;
+                continue;
+            }
+
+            RootMove root_move;
+            root_move.move = moves[i];
+            root_move.score = 0;
+            root_move.previousScore = 0;
+            root_move.nodes = 0ULL;
+            root_move.pv[0] = moves[i];
+            root_move.pvLength = 1;
+            rootMoves.push_back(root_move);
+        }
+
+        if (rootMoves.empty() && search_moves.size() > 0) {
+            init(moves, MoveList(), multi_pv);   // none of the searchmoves is legal, search all the moves
+        }
+    }
+
+    /**
+     * @brief size
+     * 
+     * @return number of root moves
+     */
+    inline int size() const { return static_cast<int>(rootMoves.size()); }
+
+    /**
+     * @brief operator[]
+     * 
+     * @param[in] index index of the root move (0 <= index < size())
+     * 
+     * @return root move
+     */
+    inline const RootMove& operator[](int index) const
+    {
+        assert(0 <= index && index < size());
+        return rootMoves[index];
+    }
+
+    /**
+     * @brief set_pv_index
+     * 
+     * Select the principal variation searched (MultiPV), the root moves before the index are the best moves of
+     * the previous lines and are excluded from the search.
+     * 
+     * @param[in] pv_index index of the line (0 <= pv_index < size())
+     */
+    inline void set_pv_index(int pv_index)
+    {
+        assert(0 <= pv_index && pv_index < size());
+        pvIndex = pv_index;
+    }
+
+    /**
+     * @brief searching_all_moves
+     * 
+     * @return (bool)
+     * @retval TRUE if the root searches all the legal moves, the transposition table can be used in the root.
+     * @retval FALSE if some moves are excluded by searchmoves or by the previous MultiPV lines, or there are
+     *         several MultiPV lines, a root cutoff would not score the moves of the next lines.
+     */
+    inline bool searching_all_moves() const { return multiPV == 1 && pvIndex == 0 && !restricted; }
+
+    /**
+     * @brief new_iteration
+     * 
+     * Save the scores as previous scores and mark all the moves as not searched.
+     * 
+     * @tparam searchType [MAXIMIZE_WHITE, MINIMIZE_BLACK] side to move in the root
+     */
+    template<SearchType searchType>
+    inline void new_iteration()
+    {
+        for (RootMove& root_move : rootMoves) {
+            root_move.previousScore = root_move.score;
+            root_move.score = searchType == MAXIMIZE_WHITE ? std::numeric_limits<int>::min()
+                                                           : std::numeric_limits<int>::max();
+        }
+    }
+
+    /**
+     * @brief copy_moves
+     * 
+     * Copy the root moves to search in their current order into the move list, starting at the pv index.
+     * 
+     * @param[out] moves move list.
+     */
+    inline void copy_moves(MoveList& moves) const
+    {
+        moves.clear();
+
+        for (int i = pvIndex; i < size(); i++) {
+            moves.add(rootMoves[i].move);
+        }
+    }
+
+    /**
+     * @brief update
+     * 
+     * Store the result of searching a root move.
+     * 
+     * @param[in] index index of the move in the list filled by copy_moves
+     * @param[in] score evaluation returned by the search of the move
+     * @param[in] nodes nodes spent searching the move
+     * @param[in] child search frame of ply 1, with the principal variation after the move
+     */
+    inline void update(int index, int score, uint64_t nodes, const SearchStackFrame& child)
+    {
+        assert(0 <= pvIndex + index && pvIndex + index < size());
+
+        RootMove& root_move = rootMoves[pvIndex + index];
+
+        root_move.score = score;
+        root_move.nodes += nodes;
+        root_move.pvLength = 1;
+
+        for (int i = 0; i < child.pvLength && root_move.pvLength < MAX_PLY; i++) {
+            root_move.pv[root_move.pvLength++] = child.pv[i];
+        }
+    }
+
+    /**
+     * @brief sort
+     * 
+     * Sort the root moves from the pv index to the end from best to worst score, the moves with the same
+     * score (or not searched) keep their previous order.
+     * 
+     * @tparam searchType [MAXIMIZE_WHITE, MINIMIZE_BLACK] side to move in the root
+     */
+    template<SearchType searchType>
+    inline void sort()
+    {
+        std::stable_sort(rootMoves.begin() + pvIndex, rootMoves.end(), [](const RootMove& a, const RootMove& b) {
+            return searchType == MAXIMIZE_WHITE ? a.score > b.score : a.score < b.score;
+        });
+    }
+
+private:
+    std::vector<RootMove> rootMoves;
+
+    /**
+     * @brief index of the principal variation searched (MultiPV)
+     */
+    int pvIndex = 0;
+
+    /**
+     * @brief number of principal variations of the search (MultiPV)
+     */
+    int multiPV = 1;
+
+    /**
+     * @brief true if searchmoves excluded some legal moves
+     */
+    bool restricted = false;
+};
+
+struct SearchResults;
+
 /**
  * @brief SearchContext
  * 
@@ -116,6 +631,54 @@ struct SearchContext
      */
     Board& board;
 
+    /**
+     * @brief Number of nodes visited.
+     *
+     * Counts the nodes of the alpha beta and quiescence searches.
+     */
+    uint64_t nodes;
+
+    /**
+     * @brief Maximum number of nodes of the search, 0 if there is no limit.
+     */
+    uint64_t nodesLimit;
+
+    /**
+     * @brief Selective depth, max ply reached by the search.
+     */
+    int selDepth;
+
+    /**
+     * @brief Results of the search, where the information for the uci is sent.
+     */
+    SearchResults* results;
+
+    /**
+     * @brief Time manager of the search, nullptr if there is no time limit.
+     */
+    TimeManager* timeManager;
+
+    /**
+     * @brief Number of nodes pruned by ProbCut.
+     *
+     * Counts the nodes where a shallow capture search proved the cutoff.
+     */
+    uint64_t probcutCutoffs;
+
+    /**
+     * @brief Search stack.
+     *
+     * Preallocated frames of the search, indexed by ply.
+     */
+    SearchStack stack;
+
+    /**
+     * @brief Root moves.
+     *
+     * Legal moves of the root position with the results of the previous iterations.
+     */
+    RootMoves rootMoves;
+
     /**
      * @brief Constructor for SearchContext.
      *
@@ -124,50 +687,170 @@ struct SearchContext
      * @param[in] board Reference to the chessboard.
      */
     SearchContext(Board& board)
-        : bestEvalFound(0), bestEvalInIteration(0), bestMoveFound(), bestMoveInIteration(), board(board)
+        : bestEvalFound(0), bestEvalInIteration(0), bestMoveFound(), bestMoveInIteration(), board(board), nodes(0ULL),
+          nodesLimit(0ULL), selDepth(0), results(nullptr), timeManager(nullptr), probcutCutoffs(0ULL), stack(),
+          rootMoves()
     { }
+
+    /**
+     * @brief Poll the stop conditions of the search, called once per node.
+     *
+     * The node limit (go nodes) is checked in every node. The stop signal and the maximum time are only
+     * checked every POLL_NODES nodes with a relaxed read, so the check is almost free and the search
+     * notices a stop after at most POLL_NODES nodes.
+     *
+     * @param[in, out] stop stop search signal, set if a limit of the search has been reached.
+     *
+     * @return true if the search must unwind.
+     */
+    inline bool poll_stop(std::atomic<bool>& stop) const
+    {
+        constexpr uint64_t POLL_NODES = 1024ULL;
+
+        if (nodesLimit != 0ULL && nodes >= nodesLimit) {
+            stop.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        if ((nodes & (POLL_NODES - 1ULL)) != 0ULL) {
+            return false;
+        }
+
+        if (timeManager != nullptr && timeManager->hard_limit_reached()) {
+            stop.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        return stop.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief ScoreBound
+ * 
+ * Bound of the score of a search information.
+ * 
+ * -EXACT score inside the window
+ * -LOWER score failed high in the aspiration window, the real score is higher or equal (lowerbound)
+ * -UPPER score failed low in the aspiration window, the real score is lower or equal (upperbound)
+ * 
+ */
+enum class ScoreBound : uint8_t
+{
+    EXACT,
+    LOWER,
+    UPPER
 };
 
 /**
- * @brief SearchResult
+ * @brief SearchInfo
  * 
- * Struct containing the search result for a specific depth.
+ * Information sent by the search to the uci, the result of an iteration or the root move being searched.
  */
-struct SearchResult
+struct SearchInfo
 {
     /**
-     * @brief Depth at which the search result was calculated.
+     * @brief Type of the information.
      *
-     * Represents the depth of the search tree where this result was obtained.
+     * -ITERATION result of a completed iteration (or line of the MultiPV).
+     * -CURRMOVE root move that starts to be searched (currmove and currmovenumber).
      */
-    std::atomic<uint32_t> depth;
+    enum class Type : uint8_t
+    {
+        ITERATION,
+        CURRMOVE
+    };
 
     /**
-     * @brief Evaluation score of the position.
-     *
-     * The evaluation score of the position at the given depth.
+     * @brief Type of the information.
      */
-    std::atomic<int> evaluation;
+    Type type;
 
     /**
-     * @brief Encoded best move data.
-     *
-     * Stores the best move found at the given depth as a 16-bit encoded value.
+     * @brief Bound of the evaluation.
+     */
+    ScoreBound bound;
+
+    /**
+     * @brief Index of the principal variation (MultiPV), 1 is the best line.
+     */
+    uint8_t multiPV;
+
+    /**
+     * @brief Number of moves in the principal variation.
+     */
+    uint8_t pvLength;
+
+    /**
+     * @brief Depth of the iteration.
+     */
+    uint16_t depth;
+
+    /**
+     * @brief Selective depth, max ply reached by the search.
+     */
+    uint16_t selDepth;
+
+    /**
+     * @brief Evaluation score of the position (white perspective).
+     */
+    int evaluation;
+
+    /**
+     * @brief Occupation of the transposition table in per mille.
+     */
+    int hashfull;
+
+    /**
+     * @brief Number of the root move being searched, starting at 1 (CURRMOVE).
+     */
+    int currMoveNumber;
+
+    /**
+     * @brief Nodes visited by the search when the information was sent.
+     */
+    uint64_t nodes;
+
+    /**
+     * @brief Milliseconds elapsed since the start of the search when the information was sent.
+     */
+    uint64_t time;
+
+    /**
+     * @brief Best move of the iteration, or the root move being searched (CURRMOVE).
+     */
+    Move move;
+
+    /**
+     * @brief Principal variation, the first move is the best move.
      */
-    std::atomic<uint16_t> bestMove_data;
+    Move pv[MAX_PLY];
 };
 
+/**
+ * @brief Capacity of the information ring between the search and the uci.
+ */
+constexpr uint32_t SEARCH_INFO_CAPACITY = 256U;
+
+/**
+ * @brief Milliseconds of search before the currmove information is sent.
+ */
+constexpr uint64_t CURRMOVE_MIN_TIME_MS = 1000ULL;
+
 /**
  * @brief SearchResults
  * 
- * Struct containing the search results for all depths.
+ * Struct containing the information stream of the search and its final result.
+ * 
+ * The search thread is the only producer of the ring and the reader thread of the uci the only consumer.
+ * The reader is only woken up when it sleeps, so the search does not pay a notification per information.
  */
 struct SearchResults
 {
     /**
      * @brief Mutex for synchronizing access to the search results.
      *
-     * Ensures thread-safe access to the search results.
+     * Protects the sleep of the reader thread.
      */
     std::mutex mtx_data_available_cv;
 
@@ -179,51 +862,285 @@ struct SearchResults
     std::condition_variable data_available_cv;
 
     /**
-     * @brief Encoded ponder move data.
+     * @brief True while the reader thread sleeps waiting for data.
+     */
+    std::atomic<bool> readerSleeping;
+
+    /**
+     * @brief True when the search has finished and the best line is final.
      *
-     * Stores the move to be played if the opponent makes the expected move.
+     * Cleared by the uci before the search starts.
      */
-    std::atomic<uint16_t> ponderMove_data;
+    std::atomic<bool> searchFinished;
 
     /**
-     * @brief Depth reached in the search.
+     * @brief Information stream of the search.
      *
-     * Indicates the maximum depth reached during the search.
+     * If the reader is too slow and the ring is full new information is dropped, the best line is always kept.
      */
-    std::atomic<uint32_t> depthReached;
+    SpscRing<SearchInfo, SEARCH_INFO_CAPACITY> infos;
 
     /**
-     * @brief Array of search results for all depths.
+     * @brief Last exact result of the best line (multiPV 1).
      *
-     * Stores the search results for each depth up to `INF_DEPTH`.
+     * Written by the search thread, read by the uci after searchFinished. Empty (pvLength 0) if there is no result.
      */
-    SearchResult results[INF_DEPTH];
+    SearchInfo bestLine;
+
+    /**
+     * @brief Nodes visited in the last search.
+     *
+     * Written after every iteration and when the search finishes, used for the search statistics.
+     */
+    std::atomic<uint64_t> nodes;
+
+    /**
+     * @brief Selective depth of the last search.
+     *
+     * Written after every iteration, max ply reached by the search.
+     */
+    std::atomic<int> selDepth;
+
+    /**
+     * @brief Nodes spent in the best root move.
+     *
+     * Written after every iteration, share of the nodes of the search spent in the best move.
+     */
+    std::atomic<uint64_t> bestMoveNodes;
+
+    /**
+     * @brief Time point when the search started.
+     *
+     * Written by the search thread before the first iteration, used to calculate the time of each result.
+     */
+    std::chrono::steady_clock::time_point startTime;
+
+    /**
+     * @brief Nodes pruned by ProbCut in the last search.
+     *
+     * Written when the search finishes, used for the search statistics.
+     */
+    std::atomic<uint64_t> probcutCutoffs;
+
+    /**
+     * @brief Constructor for SearchResults.
+     */
+    SearchResults() : readerSleeping(false), searchFinished(false), bestLine(), nodes(0ULL), selDepth(0),
+                      bestMoveNodes(0ULL), startTime(), probcutCutoffs(0ULL)
+    { }
 };
 
 /**
- * @brief insert_new_result(SearchResults&,int,int,Move)
+ * @brief start_search_results(SearchResults&)
+ * 
+ * Called by the search before the first iteration, clears the best line and starts the clock.
+ * 
+ * @param[in, out] results
+ */
+inline void start_search_results(SearchResults& results)
+{
+    results.bestLine.pvLength = 0;
+    results.bestLine.move = Move::null();
+    results.nodes = 0ULL;
+    results.selDepth = 0;
+    results.startTime = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief elapsed_ms(const SearchResults&)
+ * 
+ * @return (uint64_t) milliseconds since the start of the search.
+ */
+inline uint64_t elapsed_ms(const SearchResults& results)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - results.startTime)
+            .count());
+}
+
+/**
+ * @brief notify_data_available(SearchResults&)
+ * 
+ * Wake up the reader thread if it is sleeping.
+ * 
+ * @note The reader publishes readerSleeping before checking the ring and the search pushes to the ring before
+ *       reading readerSleeping, with the fences at least one of them sees the other and the wake up can not be
+ *       lost. The mutex is taken before notifying so the reader is either before its check or waiting.
+ * 
+ * @param[in, out] results
+ */
+inline void notify_data_available(SearchResults& results)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (results.readerSleeping.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(results.mtx_data_available_cv);
+        }
+        results.data_available_cv.notify_one();
+    }
+}
+
+/**
+ * @brief notify_search_finished(SearchResults&)
+ * 
+ * Called by the search when it finishes, the best line is final.
+ * 
+ * @param[in, out] results
+ */
+inline void notify_search_finished(SearchResults& results)
+{
+    results.searchFinished.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(results.mtx_data_available_cv);
+    }
+    results.data_available_cv.notify_one();
+}
+
+/**
+ * @brief wait_data_available(SearchResults&)
+ * 
+ * Called by the reader thread, sleeps until there is information in the ring or the search has finished.
+ * 
+ * @param[in, out] results
+ */
+inline void wait_data_available(SearchResults& results)
+{
+    std::unique_lock<std::mutex> lock(results.mtx_data_available_cv);
+
+    results.readerSleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    results.data_available_cv.wait(lock, [&results] {
+        return !results.infos.empty() || results.searchFinished.load(std::memory_order_acquire);
+    });
+
+    results.readerSleeping.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief insert_new_result(SearchResults&,int,int,Move,const Move*,int,int,ScoreBound)
  * 
- * @note This method is thread safe.
+ * @note Only the search thread can call this method.
  * 
- * Insert new result in the search results.
+ * Send the result of an iteration to the uci, the exact results of the first line are kept as the best line.
+ * The nodes and selective depth of the result are read from results.nodes and results.selDepth and the time
+ * is measured from results.startTime.
+ * If the principal variation does not start with the best move only the best move is stored.
  * 
  * @param[in, out] results
  * @param[in] depth calculated depth
  * @param[in] evaluation best evaluation result
  * @param[in] move best move result
+ * @param[in] pv principal variation (optional)
+ * @param[in] pv_length number of moves of the principal variation
+ * @param[in] multi_pv index of the principal variation, 1 is the best line
+ * @param[in] bound bound of the evaluation, only exact results can be the best line
  */
-inline void insert_new_result(SearchResults& results, int depth, int evaluation, Move move)
+inline void insert_new_result(SearchResults& results, int depth, int evaluation, Move move, const Move* pv = nullptr,
+                              int pv_length = 0, int multi_pv = 1, ScoreBound bound = ScoreBound::EXACT)
 {
-    assert(results.depthReached < INF_DEPTH);
+    assert(pv_length <= MAX_PLY);
 
-    results.results[results.depthReached].depth = depth;
-    results.results[results.depthReached].evaluation = evaluation;
-    results.results[results.depthReached].bestMove_data = move.raw_data();
-    results.depthReached++;
+    if (pv == nullptr || pv_length == 0 || pv[0] != move) {
+        pv = &move;
+        pv_length = 1;
+    }
 
-    results.data_available_cv.notify_one();
+    SearchInfo info;
+    info.type = SearchInfo::Type::ITERATION;
+    info.bound = bound;
+    info.multiPV = static_cast<uint8_t>(multi_pv);
+    info.pvLength = static_cast<uint8_t>(pv_length);
+    info.depth = static_cast<uint16_t>(depth);
+    info.selDepth = static_cast<uint16_t>(std::max(results.selDepth.load(), depth));
+    info.evaluation = evaluation;
+    info.hashfull = TranspositionTable::hashfull();
+    info.currMoveNumber = 0;
+    info.nodes = results.nodes.load();
+    info.time = elapsed_ms(results);
+    info.move = move;
+    std::copy(pv, pv + pv_length, info.pv);
+
+    if (multi_pv == 1 && bound == ScoreBound::EXACT) {
+        results.bestLine = info;
+    }
+
+    results.infos.push(info);   // if the ring is full the information is dropped
+    notify_data_available(results);
+}
+
+/**
+ * @brief insert_currmove(SearchResults&,int,Move,int,uint64_t)
+ * 
+ * @note Only the search thread can call this method.
+ * 
+ * Send the root move that starts to be searched, only after CURRMOVE_MIN_TIME_MS of search.
+ * 
+ * @param[in, out] results
+ * @param[in] depth depth of the iteration
+ * @param[in] move root move
+ * @param[in] move_number number of the root move, starting at 1
+ * @param[in] nodes nodes visited by the search
+ */
+inline void insert_currmove(SearchResults& results, int depth, Move move, int move_number, uint64_t nodes)
+{
+    const uint64_t time = elapsed_ms(results);
+
+    if (time < CURRMOVE_MIN_TIME_MS) {
+        return;
+    }
+
+    SearchInfo info;
+    info.type = SearchInfo::Type::CURRMOVE;
+    info.bound = ScoreBound::EXACT;
+    info.multiPV = 1;
+    info.pvLength = 0;
+    info.depth = static_cast<uint16_t>(depth);
+    info.selDepth = 0;
+    info.evaluation = 0;
+    info.hashfull = 0;
+    info.currMoveNumber = move_number;
+    info.nodes = nodes;
+    info.time = time;
+    info.move = move;
+
+    if (results.infos.push(info)) {
+        notify_data_available(results);
+    }
+}
+
+/**
+ * @brief score_to_tt(int, int)
+ * 
+ * Converts a score to store it in the transposition table, mate scores are stored relative to the
+ * position instead of relative to the root.
+ * 
+ * @param[in] score evaluation of the position
+ * @param[in] ply current ply in the tree
+ * 
+ * @return score to store in the transposition table
+ */
+constexpr inline int score_to_tt(int score, int ply)
+{
+    return score >= MATE_THRESHOLD ? score + ply : score <= -MATE_THRESHOLD ? score - ply : score;
 }
 
+/**
+ * @brief score_from_tt(int, int)
+ * 
+ * Converts a score read from the transposition table, mate scores are converted back relative to the root.
+ * 
+ * @param[in] score evaluation stored in the transposition table
+ * @param[in] ply current ply in the tree
+ * 
+ * @return score relative to the root
+ */
+constexpr inline int score_from_tt(int score, int ply)
+{
+    return score >= MATE_THRESHOLD ? score - ply : score <= -MATE_THRESHOLD ? score + ply : score;
+}
 
 /**
  * @brief Tells the CPU to load data from memory into the cache.
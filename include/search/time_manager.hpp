@@ -0,0 +1,156 @@
+#pragma once
+
+/**
+ * @file time_manager.hpp
+ * @brief time manager declaration.
+ *
+ * Think time of the search with the clock of the go command.
+ *
+ */
+
+#include "move.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief TimeManager
+ *
+ * Calculates an optimum and a maximum time for the move.
+ *
+ * The maximum time is a hard limit polled inside the search. The optimum time is a soft limit checked
+ * after every iteration, scaled by the stability of the best move, the evaluation drops and the share
+ * of the nodes spent in the best root move.
+ *
+ * @note The search thread polls the time manager while the uci thread can signal a ponderhit.
+ *
+ * https://www.chessprogramming.org/Time_Management
+ *
+ */
+class TimeManager
+{
+public:
+    /**
+     * @brief default time reserved for the communication with the gui in each move (ms)
+     */
+    static constexpr uint32_t DEFAULT_MOVE_OVERHEAD = 10U;
+
+    /**
+     * @brief max value of the move overhead option (ms)
+     */
+    static constexpr uint32_t MAX_MOVE_OVERHEAD = 5000U;
+
+    /**
+     * @brief init(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, bool)
+     *
+     * Calculate the optimum and maximum time of the move, the clock starts now (or on ponderhit).
+     *
+     * @param[in] time remaining time of the side to move (ms), 0 if not provided.
+     * @param[in] increment increment per move of the side to move (ms).
+     * @param[in] moves_to_go moves until the next time control, 0 in sudden death.
+     * @param[in] movetime explicit think time (ms), 0 if not provided.
+     * @param[in] move_overhead time reserved for the communication with the gui (ms).
+     * @param[in] ponder true if the search starts pondering, the clock starts on ponderhit.
+     *
+     */
+    void init(uint32_t time, uint32_t increment, uint32_t moves_to_go, uint32_t movetime, uint32_t move_overhead,
+              bool ponder);
+
+    /**
+     * @brief ponderhit()
+     *
+     * The opponent played the expected move, restart the clock and apply the time limits.
+     *
+     */
+    void ponderhit();
+
+    /**
+     * @brief hard_limit_reached()
+     *
+     * @note polled inside the search.
+     *
+     * @return true if the maximum time of the move has been spent.
+     *
+     */
+    bool hard_limit_reached() const { return !pondering && elapsed() >= maximumTime; }
+
+    /**
+     * @brief stop_after_iteration(Move, int, uint64_t, uint64_t, int)
+     *
+     * Called after every completed iteration, updates the best move stability and decides if
+     * there is time for another iteration.
+     *
+     * @param[in] best_move best move of the iteration.
+     * @param[in] evaluation evaluation of the iteration from the point of view of the side to move.
+     * @param[in] best_move_nodes nodes spent in the best root move.
+     * @param[in] nodes nodes of the search.
+     * @param[in] num_root_moves number of legal moves in the root.
+     *
+     * @return true if the search should stop.
+     *
+     */
+    bool stop_after_iteration(Move best_move, int evaluation, uint64_t best_move_nodes, uint64_t nodes,
+                              int num_root_moves);
+
+    /**
+     * @brief elapsed()
+     *
+     * @return (uint64_t) milliseconds since the start of the clock.
+     *
+     */
+    uint64_t elapsed() const { return static_cast<uint64_t>(std::max<int64_t>(now() - startTime, 0)); }
+
+    /**
+     * @brief deadline()
+     *
+     * @return (std::chrono::steady_clock::time_point) end of the maximum time of the move.
+     *
+     */
+    std::chrono::steady_clock::time_point deadline() const
+    {
+        return std::chrono::steady_clock::time_point(std::chrono::milliseconds(startTime + int64_t(maximumTime)));
+    }
+
+    /**
+     * @brief optimum()
+     *
+     * @return (uint64_t) optimum time of the move (ms).
+     *
+     */
+    uint64_t optimum() const { return optimumTime; }
+
+    /**
+     * @brief maximum()
+     *
+     * @return (uint64_t) maximum time of the move (ms).
+     *
+     */
+    uint64_t maximum() const { return maximumTime; }
+
+private:
+    /**
+     * @brief now()
+     *
+     * @return (int64_t) milliseconds of the steady clock.
+     *
+     */
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    std::atomic<int64_t> startTime{0};
+    std::atomic<bool> pondering{false};
+    uint64_t optimumTime = 0ULL;
+    uint64_t maximumTime = 0ULL;
+    bool fixedTime = false;
+
+    // iteration history
+    Move previousBestMove;
+    int previousEvaluation = 0;
+    double bestMoveChanges = 0.0;
+    int iterations = 0;
+};
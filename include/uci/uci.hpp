@@ -14,10 +14,14 @@
 
 #include "board.hpp"
 #include "search.hpp"
+#include "latency_histogram.hpp"
 #include <atomic>
 #include <array>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 /**
  * @brief MAX_UCI_TOKENS
@@ -50,19 +54,18 @@ public:
     /**
      * @brief Uci
      * 
-     * Uci constructor.
+     * Uci constructor, starts the search and reader threads that wait for the go commands.
      * 
      */
-
-    Uci() { }
+    Uci();
 
     /**
      * @brief ~Uci
      * 
-     * Uci destructor.
+     * Uci destructor, stops the search and finishes the threads.
      * 
      */
-    ~Uci() { stop_command_action(); }
+    ~Uci();
 
     /**
      * @brief loop
@@ -72,6 +75,26 @@ public:
      */
     void loop();
 
+    /**
+     * @brief execute_command
+     *
+     * Parse the command line and run the action of the command.
+     *
+     * @param[in] line command line sent by the gui or the user.
+     *
+     * @return false if the command is quit.
+     *
+     */
+    bool execute_command(std::string_view line);
+
+    /**
+     * @brief get_board
+     *
+     * @return board with the position set by the position commands.
+     *
+     */
+    const Board& get_board() const { return board; }
+
 private:
     /**
      * @brief stop_signal
@@ -91,10 +114,27 @@ private:
      */
     Board board;
 
+    /**
+     * @brief positionFen
+     * 
+     * fen of the position where the game of the board starts, empty if the board has to be rebuilt.
+     * 
+     */
+    std::string positionFen;
+
+    /**
+     * @brief positionMoves
+     * 
+     * moves played in the board from positionFen, used to apply only the new moves of the next position command.
+     * 
+     */
+    std::vector<std::string> positionMoves;
+
     /**
      * @brief searchThread
      * 
-     * thread in charge of searching for the best move.
+     * thread in charge of searching for the best move, it lives until the uci is destroyed
+     * and sleeps between searches.
      * 
      */
     std::thread searchThread;
@@ -102,34 +142,70 @@ private:
     /**
      * @brief readerThread
      * 
-     * thread in charge of reading the search output
+     * thread in charge of reading the search output, it lives until the uci is destroyed
+     * and sleeps between searches.
      * 
      */
     std::thread readerThread;
 
     /**
-     * @brief timerThread
+     * @brief mutex to protect the search job and the state of the threads.
+     */
+    std::mutex workersMutex;
+
+    /**
+     * @brief condition variable to wake up the threads with a new search job.
+     */
+    std::condition_variable workersCv;
+
+    /**
+     * @brief condition variable to signal that the threads finished the search job.
+     */
+    std::condition_variable workersIdleCv;
+
+    /**
+     * @brief number of the last search job, the threads run the job when it changes.
+     */
+    uint64_t jobId = 0ULL;
+
+    /**
+     * @brief limits of the last search job.
+     */
+    SearchLimits jobLimits;
+
+    /**
+     * @brief number of threads that have not finished the last search job.
+     */
+    int activeWorkers = 0;
+
+    /**
+     * @brief signal the threads to finish.
+     */
+    bool quitWorkers = false;
+
+    /**
+     * @brief timeManager
      * 
-     * thread in charge of stopping the search when time is up.
+     * think time of the current search, polled by the search thread.
      * 
      */
-    std::thread timerThread;
+    TimeManager timeManager;
 
     /**
-     * @brief timerMutex
+     * @brief stopRequestTime
      * 
-     * mutex to protect the timerCv.
+     * microseconds of the steady clock when the stop command arrived, 0 if the search was not stopped.
      * 
      */
-    std::mutex timerMutex;
+    std::atomic<int64_t> stopRequestTime;
 
     /**
-     * @brief timerCv
+     * @brief stopLatency
      * 
-     * condition variable to signal the timer.
+     * time from the stop command or the end of the maximum time to the bestmove output.
      * 
      */
-    std::condition_variable timerCv;
+    LatencyHistogram stopLatency;
 
     /**
      * @brief mutex to protect the ponderhitCv.
@@ -154,6 +230,22 @@ private:
      */
     SearchResults searchResults;
 
+    /**
+     * @brief multiPV
+     * 
+     * number of principal variations reported by the search (MultiPV option).
+     * 
+     */
+    int multiPV = 1;
+
+    /**
+     * @brief moveOverhead
+     * 
+     * time reserved for the communication with the gui in each move (Move Overhead option).
+     * 
+     */
+    uint32_t moveOverhead = TimeManager::DEFAULT_MOVE_OVERHEAD;
+
     /**
      * @brief uci_command_action
      * 
@@ -238,6 +330,25 @@ private:
      */
     void diagram_command_action() const;
 
+    /**
+     * @brief stats_command_action
+     * 
+     * Prints the statistics of the last search.
+     * 
+     */
+    void stats_command_action() const;
+
+    /**
+     * @brief latency_command_action
+     * 
+     * Prints the histogram of the stop to bestmove latency, with clear the histogram is reset.
+     * 
+     * @param[in] tokens buffer array with the user input tokens.
+     * @param[in] num_tokens number of tokens.
+     * 
+     */
+    void latency_command_action(const TokenArray& tokens, uint32_t num_tokens);
+
     /**
      * @brief help_command_action
      * 
@@ -278,6 +389,40 @@ private:
      */
     bool setoption_command_action(const TokenArray& tokens, uint32_t num_tokens);
 
+    /**
+     * @brief setoption_algorithm
+     *
+     * Select the algorithm of a SearchAlgorithm, Evaluation or MoveGen setoption command.
+     *
+     * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+     *
+     * @param[in] option_name name of the UCI option.
+     * @param[in] tokens buffer array with the user input tokens.
+     * @param[in] num_tokens number of tokens.
+     * @param[in] token_i index of the token after the option name.
+     *
+     *  @return
+     *      - TRUE if success.
+     *      - FALSE if error detected, probably error in user input.
+     */
+    template<typename Algorithm>
+    bool setoption_algorithm(std::string_view option_name, const TokenArray& tokens, uint32_t num_tokens,
+                             uint32_t token_i);
+
+    /**
+     * @brief print_combo_option
+     *
+     * Print the UCI combo option of an algorithm selection.
+     *
+     * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+     *
+     * @param[in] option_name name of the UCI option.
+     * @param[in] default_algorithm default value of the option.
+     *
+     */
+    template<typename Algorithm>
+    void print_combo_option(std::string_view option_name, Algorithm default_algorithm) const;
+
     /**
      * @brief ponderhit_command_action
      * 
@@ -286,6 +431,64 @@ private:
      */
     void ponderhit_command_action();
 
+    /**
+     * @brief search_worker
+     * 
+     * Loop of the search thread, waits for a search job and searches the best move.
+     * 
+     */
+    void search_worker();
+
+    /**
+     * @brief reader_worker
+     * 
+     * Loop of the reader thread, waits for a search job and prints the search output.
+     * 
+     */
+    void reader_worker();
+
+    /**
+     * @brief wait_job(uint64_t&, SearchLimits&)
+     * 
+     * Sleep until there is a new search job or the threads must finish.
+     * 
+     * @param[in, out] last_job number of the last job run by the thread.
+     * @param[out] limits limits of the new job.
+     * 
+     * @return false if the thread must finish.
+     * 
+     */
+    bool wait_job(uint64_t& last_job, SearchLimits& limits);
+
+    /**
+     * @brief job_finished
+     * 
+     * Called by the search and reader threads when they finish the search job.
+     * 
+     */
+    void job_finished();
+
+    /**
+     * @brief print_search_results(const SearchLimits&)
+     * 
+     * Prints the info lines of the search while it runs and the bestmove when it finishes.
+     * 
+     * @param[in] limits limits of the search job, the options changed during the search do not apply to it.
+     * 
+     */
+    void print_search_results(const SearchLimits& limits);
+
+    /**
+     * @brief print_search_info(const SearchInfo&, int)
+     * 
+     * Prints one info line of the search.
+     * 
+     * @param[in] info information sent by the search.
+     * @param[in] multi_pv number of principal variations of the search job.
+     * 
+     */
+    void print_search_info(const SearchInfo& info, int multi_pv) const;
+
     /**
      * @brief unknown_command_action
      * 
@@ -314,21 +517,4 @@ private:
      *      - Move::null() if error detected, bad string move representation.
      */
     Move create_move_from_string(std::string_view move_string, const Board& board) const;
-
-    /**
-     * @brief calculate the time the bot has until stopping the search
-     * 
-     * @note pass 0 to not provide an argument
-     * 
-     * @param[in] us side to move
-     * @param[in] movetime explicit think time (if provided it will be the think time)
-     * @param[in] wtime white total time
-     * @param[in] btime black total time
-     * @param[in] winc white time increment per move
-     * @param[in] binc black time increment per move
-     * 
-     *  @return (uint32_t) time to think
-     * 
-     */
-    uint32_t think_time(ChessColor us, uint32_t movetime, uint32_t wtime, uint32_t btime, uint32_t winc, uint32_t binc);
 };
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * @file uci_output.hpp
+ * @brief uci output declaration.
+ *
+ * Buffered output of the uci, the text is written to stdout by a writer thread.
+ *
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/**
+ * @brief uci_out()
+ *
+ * Output stream of the calling thread, the text is kept in a thread local buffer.
+ * std::endl and std::flush hand the text of the buffer to the writer thread without waiting.
+ *
+ * @note use UciOutput::flush() to wait until the text is written.
+ *
+ * @return (std::ostream&) thread local output stream.
+ *
+ */
+std::ostream& uci_out();
+
+/**
+ * @brief UciOutput
+ *
+ * Writer thread of the uci output. The threads format their lines in their own buffers and hand
+ * complete lines to a shared pending buffer, the writer writes everything pending with a single
+ * write and flush, so a burst of lines costs one system call.
+ *
+ * The lines of each thread keep their order (bestmove is written after the info lines of the search)
+ * and the lines of different threads are never mixed.
+ *
+ */
+class UciOutput
+{
+public:
+    /**
+     * @brief start()
+     *
+     * Start the writer thread, before it is started the text is written directly.
+     *
+     */
+    static void start();
+
+    /**
+     * @brief stop()
+     *
+     * Write all the pending text and finish the writer thread.
+     *
+     */
+    static void stop();
+
+    /**
+     * @brief write(const std::string&)
+     *
+     * Hand the text to the writer thread, or write it directly if the writer is not running.
+     *
+     * @param[in] text complete lines of text.
+     *
+     */
+    static void write(const std::string& text);
+
+    /**
+     * @brief flush()
+     *
+     * Hand the buffer of the calling thread to the writer and wait until all the text handed
+     * before the call is written.
+     *
+     */
+    static void flush();
+
+    UciOutput() = delete;
+    ~UciOutput() = delete;
+
+private:
+    static void writer_loop();
+    static void write_to_stdout(const std::string& text);
+
+    static std::thread writerThread;
+    static std::mutex mutex;
+    static std::condition_variable pendingCv;
+    static std::condition_variable writtenCv;
+    static std::string pending;
+    static uint64_t enqueuedBytes;
+    static uint64_t writtenBytes;
+    static bool running;
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+/**
+ * @file algorithm_selection.hpp
+ * @brief algorithm selection utilities declaration.
+ *
+ * Search, evaluation and move generator algorithms used by the engine, selected with the UCI options
+ * SearchAlgorithm, Evaluation and MoveGen.
+ *
+ */
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief default algorithms, defined by CMake with the USE_SEARCH_*, USE_EVALUATION_* and USE_MOVE_GENERATOR_* options
+ */
+#ifndef DEFAULT_SEARCH_ALGORITHM
+#define DEFAULT_SEARCH_ALGORITHM TRANSPOSITION_TABLE
+#endif
+#ifndef DEFAULT_EVALUATION_ALGORITHM
+#define DEFAULT_EVALUATION_ALGORITHM DYNAMIC
+#endif
+#ifndef DEFAULT_MOVE_GENERATOR_ALGORITHM
+#define DEFAULT_MOVE_GENERATOR_ALGORITHM MAGIC_BITBOARDS
+#endif
+
+/**
+ * @brief SearchAlgorithm
+ *
+ * Search implementations, search_basic.cpp, search_multithread.cpp, search_transposition_table.cpp and
+ * search_tt_reductions.cpp.
+ */
+enum class SearchAlgorithm
+{
+    BASIC,
+    MULTITHREAD,
+    TRANSPOSITION_TABLE,
+    TT_REDUCTIONS
+};
+
+/**
+ * @brief EvaluationAlgorithm
+ *
+ * Evaluation implementations, evaluation_dynamic.cpp, evaluation_safety_mobility.cpp and evaluation_nnue.cpp.
+ */
+enum class EvaluationAlgorithm
+{
+    DYNAMIC,
+    SAFETY_MOBILITY,
+    NNUE
+};
+
+/**
+ * @brief MoveGeneratorAlgorithm
+ *
+ * Move generator implementations, move_generator_basic.cpp and move_generator_magic_bitboards.cpp.
+ */
+enum class MoveGeneratorAlgorithm
+{
+    BASIC,
+    MAGIC_BITBOARDS
+};
+
+/**
+ * @brief AlgorithmSelection
+ *
+ * Algorithms selected for the next search. Every algorithm is compiled in the engine, the search dispatches
+ * once to the template instantiation of the selected combination, so the calls inside the search are direct.
+ *
+ * @note the selection must not change while the engine is searching.
+ *
+ */
+class AlgorithmSelection
+{
+public:
+    /**
+     * @brief UCI names of the search algorithms, indexed by SearchAlgorithm
+     */
+    static constexpr std::array<std::string_view, 4> SEARCH_NAMES = {"basic", "multithread", "transposition_table",
+                                                                     "tt_reductions"};
+    /**
+     * @brief UCI names of the evaluation algorithms, indexed by EvaluationAlgorithm
+     */
+    static constexpr std::array<std::string_view, 3> EVALUATION_NAMES = {"dynamic", "safety_mobility", "nnue"};
+
+    /**
+     * @brief UCI names of the move generator algorithms, indexed by MoveGeneratorAlgorithm
+     */
+    static constexpr std::array<std::string_view, 2> MOVE_GENERATOR_NAMES = {"basic", "magic_bitboards"};
+
+    /**
+     * @brief default algorithms of the engine
+     */
+    static constexpr SearchAlgorithm DEFAULT_SEARCH = SearchAlgorithm::DEFAULT_SEARCH_ALGORITHM;
+    static constexpr EvaluationAlgorithm DEFAULT_EVALUATION = EvaluationAlgorithm::DEFAULT_EVALUATION_ALGORITHM;
+    static constexpr MoveGeneratorAlgorithm DEFAULT_MOVE_GENERATOR =
+        MoveGeneratorAlgorithm::DEFAULT_MOVE_GENERATOR_ALGORITHM;
+
+    /**
+     * @brief search()
+     *
+     * @return (SearchAlgorithm) selected search algorithm.
+     *
+     */
+    static inline SearchAlgorithm search() { return searchAlgorithm; }
+
+    /**
+     * @brief evaluation()
+     *
+     * @return (EvaluationAlgorithm) selected evaluation algorithm.
+     *
+     */
+    static inline EvaluationAlgorithm evaluation() { return evaluationAlgorithm; }
+
+    /**
+     * @brief move_generator()
+     *
+     * @return (MoveGeneratorAlgorithm) selected move generator algorithm.
+     *
+     */
+    static inline MoveGeneratorAlgorithm move_generator() { return moveGeneratorAlgorithm; }
+
+    /**
+     * @brief select(SearchAlgorithm)
+     *
+     * @param[in] algorithm search algorithm of the next searches.
+     *
+     */
+    static inline void select(SearchAlgorithm algorithm) { searchAlgorithm = algorithm; }
+
+    /**
+     * @brief select(EvaluationAlgorithm)
+     *
+     * @param[in] algorithm evaluation algorithm of the next searches.
+     *
+     */
+    static inline void select(EvaluationAlgorithm algorithm) { evaluationAlgorithm = algorithm; }
+
+    /**
+     * @brief select(MoveGeneratorAlgorithm)
+     *
+     * @param[in] algorithm move generator algorithm of the next searches.
+     *
+     */
+    static inline void select(MoveGeneratorAlgorithm algorithm) { moveGeneratorAlgorithm = algorithm; }
+
+    /**
+     * @brief select_by_name(std::string_view)
+     *
+     * Select the algorithm with the UCI name.
+     *
+     * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+     *
+     * @param[in] name UCI name of the algorithm.
+     *
+     * @return
+     *  - TRUE if the algorithm was selected.
+     *  - FALSE if there is no algorithm with that name.
+     *
+     */
+    template<typename Algorithm>
+    static bool select_by_name(std::string_view name)
+    {
+        const auto& names = names_of<Algorithm>();
+
+        for (size_t i = 0; i < names.size(); i++) {
+            if (names[i] == name) {
+                select(static_cast<Algorithm>(i));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief name(Algorithm)
+     *
+     * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+     *
+     * @param[in] algorithm algorithm.
+     *
+     * @return (std::string_view) UCI name of the algorithm.
+     *
+     */
+    template<typename Algorithm>
+    static constexpr std::string_view name(Algorithm algorithm)
+    {
+        return names_of<Algorithm>()[static_cast<size_t>(algorithm)];
+    }
+
+    /**
+     * @brief names_of()
+     *
+     * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+     *
+     * @return UCI names of the algorithms of that type.
+     *
+     */
+    template<typename Algorithm>
+    static constexpr const auto& names_of()
+    {
+        if constexpr (std::is_same_v<Algorithm, SearchAlgorithm>) {
+            return SEARCH_NAMES;
+        }
+        else if constexpr (std::is_same_v<Algorithm, EvaluationAlgorithm>) {
+            return EVALUATION_NAMES;
+        }
+        else {
+            static_assert(std::is_same_v<Algorithm, MoveGeneratorAlgorithm>, "not an algorithm type");
+            return MOVE_GENERATOR_NAMES;
+        }
+    }
+
+    AlgorithmSelection() = delete;
+    ~AlgorithmSelection() = delete;
+
+private:
+    static inline SearchAlgorithm searchAlgorithm = DEFAULT_SEARCH;
+    static inline EvaluationAlgorithm evaluationAlgorithm = DEFAULT_EVALUATION;
+    static inline MoveGeneratorAlgorithm moveGeneratorAlgorithm = DEFAULT_MOVE_GENERATOR;
+};
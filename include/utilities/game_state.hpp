@@ -12,6 +12,7 @@
  * 
  */
 
+static constexpr uint64_t SHIFT_GAME_PHASE = 51ULL;
 static constexpr uint64_t SHIFT_ATTACKS_UPDATED = 50ULL;
 static constexpr uint64_t SHIFT_NUM_PIECES = 43ULL;
 static constexpr uint64_t SHIFT_FIFTY_MOVE_RULE = 35ULL;
@@ -24,6 +25,7 @@ static constexpr uint64_t SHIFT_CASTLE_QUEEN_BLACK = 27ULL;
 static constexpr uint64_t SHIFT_EN_PASSANT_SQUARE = 20ULL;
 static constexpr uint64_t SHIFT_MOVE_NUMBER = 0ULL;
 
+static constexpr uint64_t MASK_GAME_PHASE = (0x7fULL << SHIFT_GAME_PHASE);
 static constexpr uint64_t MASK_ATTACKS_UPDATED = (1ULL << SHIFT_ATTACKS_UPDATED);
 static constexpr uint64_t MASK_NUM_PIECES = (0x7fULL << SHIFT_NUM_PIECES);
 static constexpr uint64_t MASK_FIFTY_MOVE_RULE = (0xffULL << SHIFT_FIFTY_MOVE_RULE);
@@ -43,6 +45,7 @@ static constexpr uint64_t MASK_MOVE_NUMBER = (0xfffffULL << SHIFT_MOVE_NUMBER);
  * Represents the state of the chess game.
  * 
  * @note game state is stored as a 64-bit number :
+ * 51-57 : game_phase : 0 to 127 phase weight of the pieces in the board
  * 50 : attacks_updated : 1 if updated, 0 if not
  * 43-49 : num_pieces : 0 to 64 pieces
  * 35-42 : fifty_move_rule_counter : if counter gets to 100 then game is a draw.
@@ -57,6 +60,12 @@ static constexpr uint64_t MASK_MOVE_NUMBER = (0xfffffULL << SHIFT_MOVE_NUMBER);
  * 
  * 63-0 zobrist_key : zobrist hash key of the position
  * 
+ * 63-0 pawn_key : zobrist hash key of the pawns of the position
+ * 
+ * 63-0 material_key : zobrist hash key of the number of pieces of each type
+ * 
+ * 31-0 pst_score : middlegame and endgame material + piece square table score of the position
+ * 
  */
 class GameState
 {
@@ -333,6 +342,66 @@ public:
      */
     constexpr inline void xor_zobrist(uint64_t seed) { zobrist_key ^= seed; };
 
+    /**
+     * @brief get_pawn_key
+     * 
+     * get the zobrist key of the pawns, used to index the pawn hash table.
+     * 
+     * @return pawn_key.
+     * 
+     */
+    constexpr inline uint64_t get_pawn_key() const { return pawn_key; };
+
+    /**
+     * @brief set_pawn_key
+     * 
+     * set the zobrist key of the pawns.
+     * 
+     * @param[in] key pawn zobrist key
+     * 
+     */
+    constexpr inline void set_pawn_key(uint64_t key) { pawn_key = key; };
+
+    /**
+     * @brief xor_pawn_key
+     * 
+     * modify the pawn_key ( pawn_key ^= seed ).
+     * 
+     * @param[in] seed seed hash key modifier
+     * 
+     */
+    constexpr inline void xor_pawn_key(uint64_t seed) { pawn_key ^= seed; };
+
+    /**
+     * @brief get_material_key
+     * 
+     * get the zobrist key of the material, used to index the material table.
+     * 
+     * @return material_key.
+     * 
+     */
+    constexpr inline uint64_t get_material_key() const { return material_key; };
+
+    /**
+     * @brief set_material_key
+     * 
+     * set the zobrist key of the material.
+     * 
+     * @param[in] key material zobrist key
+     * 
+     */
+    constexpr inline void set_material_key(uint64_t key) { material_key = key; };
+
+    /**
+     * @brief xor_material_key
+     * 
+     * modify the material_key ( material_key ^= seed ).
+     * 
+     * @param[in] seed seed hash key modifier
+     * 
+     */
+    constexpr inline void xor_material_key(uint64_t seed) { material_key ^= seed; };
+
     /**
      * @brief returns the bitboard with 1 in the squares that all pieces of this type attacks on the position
      * 
@@ -424,6 +493,53 @@ public:
      */
     constexpr inline bool attacks_updated() const { return state_register & MASK_ATTACKS_UPDATED; }
 
+    /**
+     * @brief game_phase
+     * 
+     * sum of the phase weights of the pieces in the board (minor piece 1, rook 2, queen 4)
+     * 
+     * @return (int) 0 <= game_phase <= 127.
+     * 
+     */
+    constexpr inline int game_phase() const { return (state_register & MASK_GAME_PHASE) >> SHIFT_GAME_PHASE; }
+
+    /**
+     * @brief set_game_phase
+     * 
+     * set the sum of the phase weights of the pieces in the board.
+     * 
+     * @note phase must be between 0-127, otherwise state will be corrupted.
+     * 
+     * @param[in] phase game phase
+     * 
+     */
+    constexpr inline void set_game_phase(int phase)
+    {
+        assert(phase >= 0 && phase <= 127);
+        state_register &= ~MASK_GAME_PHASE;
+        state_register |= static_cast<uint64_t>(phase) << SHIFT_GAME_PHASE;
+    }
+
+    /**
+     * @brief pst_score
+     * 
+     * material + piece square table score of the position, middlegame and endgame packed in one score.
+     * 
+     * @return (int32_t) pst_score.
+     * 
+     */
+    constexpr inline int32_t pst_score() const { return pst_score_pair; }
+
+    /**
+     * @brief add_pst_score
+     * 
+     * modify the material + piece square table score ( pst_score += score ).
+     * 
+     * @param[in] score packed middlegame and endgame score
+     * 
+     */
+    constexpr inline void add_pst_score(int32_t score) { pst_score_pair += score; }
+
     /**
      * @brief number of pieces of the specified type in the board
      * 
@@ -468,6 +584,9 @@ public:
     {
         state_register = 0ULL;
         zobrist_key = 0ULL;
+        pawn_key = 0ULL;
+        material_key = 0ULL;
+        pst_score_pair = 0;
         clear_attacks_bb();
         set_move_number(1ULL);
         piece_counter.fill(0U);
@@ -490,7 +609,12 @@ public:
      * set_last_captured_piece(PieceType::EMPTY);
      * 
      */
-    constexpr GameState() : state_register(0ULL), zobrist_key(0ULL), attacks_bb {{0}}, piece_counter {{0}} { clean(); }
+    constexpr GameState()
+        : state_register(0ULL), zobrist_key(0ULL), pawn_key(0ULL), material_key(0ULL), pst_score_pair(0),
+          attacks_bb {{0}}, piece_counter {{0}}
+    {
+        clean();
+    }
 
     /**
      * @brief GameState
@@ -501,7 +625,8 @@ public:
      * 
      */
     constexpr GameState(const GameState& gs)
-        : state_register(gs.state_register), zobrist_key(gs.zobrist_key), attacks_bb(gs.attacks_bb),
+        : state_register(gs.state_register), zobrist_key(gs.zobrist_key), pawn_key(gs.pawn_key),
+          material_key(gs.material_key), pst_score_pair(gs.pst_score_pair), attacks_bb(gs.attacks_bb),
           piece_counter(gs.piece_counter)
     { }
 
@@ -518,7 +643,8 @@ public:
      */
     constexpr bool operator==(const GameState& gs) const
     {
-        return state_register == gs.state_register && zobrist_key == gs.zobrist_key && attacks_bb == attacks_bb &&
+        return state_register == gs.state_register && zobrist_key == gs.zobrist_key && pawn_key == gs.pawn_key &&
+            material_key == gs.material_key && pst_score_pair == gs.pst_score_pair && attacks_bb == attacks_bb &&
             piece_counter == piece_counter;
     }
 
@@ -551,6 +677,9 @@ public:
         {
             this->state_register = other.state_register;
             this->zobrist_key = other.zobrist_key;
+            this->pawn_key = other.pawn_key;
+            this->material_key = other.material_key;
+            this->pst_score_pair = other.pst_score_pair;
             this->attacks_bb = other.attacks_bb;
             this->piece_counter = other.piece_counter;
         }
@@ -574,6 +703,30 @@ private:
      */
     uint64_t zobrist_key;
 
+    /**
+     * @brief pawn_key
+     * 
+     * Zobrist hash key of the pawns
+     * 
+     */
+    uint64_t pawn_key;
+
+    /**
+     * @brief material_key
+     * 
+     * Zobrist hash key of the number of pieces of each type
+     * 
+     */
+    uint64_t material_key;
+
+    /**
+     * @brief pst_score_pair
+     * 
+     * material + piece square table score, middlegame in the low 16 bits and endgame in the high 16 bits
+     * 
+     */
+    int32_t pst_score_pair;
+
     /**
      * @brief attack squares bitboard by every piece[NUM_CHESS_PIECES - 1]
      * 
@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * @file latency_histogram.hpp
+ * @brief latency histogram declaration.
+ *
+ * Histogram of latencies in microseconds, used to measure the time from a stop to the bestmove.
+ *
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief LatencyHistogram
+ *
+ * Counts latencies in fixed buckets, the last bucket counts everything above the last bound.
+ *
+ * @note record can be called from one thread while another thread prints the histogram.
+ *
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @brief upper bounds of the buckets in microseconds
+     */
+    static constexpr std::array<uint64_t, 10> BUCKET_BOUNDS_US = {100,  250,   500,   1000,  2500,
+                                                                   5000, 10000, 25000, 50000, 100000};
+
+    /**
+     * @brief number of buckets, one more than the bounds for the latencies above the last bound
+     */
+    static constexpr int NUM_BUCKETS = BUCKET_BOUNDS_US.size() + 1;
+
+    /**
+     * @brief record(uint64_t)
+     *
+     * Count a new latency.
+     *
+     * @param[in] latency_us latency in microseconds.
+     *
+     */
+    void record(uint64_t latency_us)
+    {
+        int bucket = 0;
+        while (bucket < NUM_BUCKETS - 1 && latency_us >= BUCKET_BOUNDS_US[bucket]) {
+            bucket++;
+        }
+
+        buckets[bucket].fetch_add(1ULL, std::memory_order_relaxed);
+        samples.fetch_add(1ULL, std::memory_order_relaxed);
+        total.fetch_add(latency_us, std::memory_order_relaxed);
+
+        uint64_t max = maximum.load(std::memory_order_relaxed);
+        while (latency_us > max && !maximum.compare_exchange_weak(max, latency_us, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief clear()
+     *
+     * Remove all the samples.
+     *
+     */
+    void clear()
+    {
+        for (std::atomic<uint64_t>& bucket : buckets) {
+            bucket = 0ULL;
+        }
+        samples = 0ULL;
+        total = 0ULL;
+        maximum = 0ULL;
+    }
+
+    /**
+     * @brief count()
+     *
+     * @return (uint64_t) number of latencies recorded.
+     *
+     */
+    uint64_t count() const { return samples.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief bucket_count(int)
+     *
+     * @param[in] bucket index of the bucket (0 <= bucket < NUM_BUCKETS).
+     *
+     * @return (uint64_t) number of latencies recorded in the bucket.
+     *
+     */
+    uint64_t bucket_count(int bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief operator<<
+     *
+     * Print the number of samples, mean, maximum and one line per bucket.
+     *
+     */
+    friend std::ostream& operator<<(std::ostream& os, const LatencyHistogram& histogram)
+    {
+        const uint64_t samples = histogram.count();
+        const uint64_t mean = samples ? histogram.total.load(std::memory_order_relaxed) / samples : 0ULL;
+
+        os << "samples " << samples << " mean " << mean << " us max " << histogram.maximum.load() << " us\n";
+
+        uint64_t lower = 0ULL;
+        for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            os << "  [" << lower << ", ";
+            if (bucket < NUM_BUCKETS - 1) {
+                os << BUCKET_BOUNDS_US[bucket] << ") us: ";
+                lower = BUCKET_BOUNDS_US[bucket];
+            }
+            else {
+                os << "inf) us: ";
+            }
+            os << histogram.bucket_count(bucket) << "\n";
+        }
+        return os;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> samples{0ULL};
+    std::atomic<uint64_t> total{0ULL};
+    std::atomic<uint64_t> maximum{0ULL};
+};
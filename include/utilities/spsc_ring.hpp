@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file spsc_ring.hpp
+ * @brief single producer single consumer ring declaration.
+ *
+ * Lock-free bounded queue between two threads, used to send the search information to the uci.
+ *
+ * https://en.wikipedia.org/wiki/Circular_buffer
+ *
+ */
+
+#include "bit_utilities.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief SpscRing
+ *
+ * Bounded lock-free queue for one producer thread and one consumer thread.
+ * The elements are stored in a fixed array, there is no allocation after the construction.
+ *
+ * @note push can only be called by the producer and pop by the consumer.
+ *
+ * @tparam T type of the elements, copied in and out of the ring.
+ * @tparam CAPACITY max number of elements in the ring, must be power of two.
+ *
+ */
+template<typename T, uint32_t CAPACITY>
+class SpscRing
+{
+    static_assert(is_power_of_two(CAPACITY), "the capacity of the ring must be power of two");
+
+public:
+    /**
+     * @brief push(const T&)
+     *
+     * Insert an element at the end of the ring (producer).
+     *
+     * @param[in] element element to insert.
+     *
+     * @return false if the ring is full and the element was not inserted.
+     *
+     */
+    bool push(const T& element)
+    {
+        const uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+
+        if (tail - headCache == CAPACITY) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail - headCache == CAPACITY) {
+                return false;
+            }
+        }
+
+        buffer[tail & (CAPACITY - 1)] = element;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop(T&)
+     *
+     * Remove the first element of the ring (consumer).
+     *
+     * @param[out] element first element of the ring.
+     *
+     * @return false if the ring is empty.
+     *
+     */
+    bool pop(T& element)
+    {
+        const uint32_t head = headIndex.load(std::memory_order_relaxed);
+
+        if (head == tailCache) {
+            tailCache = tailIndex.load(std::memory_order_acquire);
+            if (head == tailCache) {
+                return false;
+            }
+        }
+
+        element = buffer[head & (CAPACITY - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief empty()
+     *
+     * @note the result can be outdated if the other thread is using the ring.
+     *
+     * @return true if there are no elements in the ring.
+     *
+     */
+    bool empty() const
+    {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief capacity()
+     *
+     * @return (uint32_t) max number of elements in the ring.
+     *
+     */
+    static constexpr uint32_t capacity() { return CAPACITY; }
+
+private:
+    // the indexes grow without bounds, the position in the buffer is index & (CAPACITY - 1).
+    // producer and consumer data in different cache lines to avoid false sharing.
+    alignas(64) std::atomic<uint32_t> tailIndex{0U};
+    uint32_t headCache = 0U;   // producer copy of headIndex
+
+    alignas(64) std::atomic<uint32_t> headIndex{0U};
+    uint32_t tailCache = 0U;   // consumer copy of tailIndex
+
+    alignas(64) std::array<T, CAPACITY> buffer{};
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * @file table_pool.hpp
+ * @brief table pool utilities declaration.
+ *
+ * Pool of per thread tables.
+ *
+ */
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief TablePool
+ *
+ * Pool of the tables of the search threads. A thread takes a table the first time it uses it and gives
+ * it back when it finishes, so the short lived threads of the search reuse the tables and their entries
+ * instead of allocating a new table each.
+ *
+ * @tparam Table table type, default constructible.
+ *
+ */
+template<typename Table>
+class TablePool
+{
+public:
+    /**
+     * @brief thread_table()
+     *
+     * @return (Table&) table held by the calling thread.
+     *
+     */
+    static Table& thread_table()
+    {
+        thread_local Lease lease;
+        return *lease.table;
+    }
+
+    /**
+     * @brief for_each(Function)
+     *
+     * Call the function with every table of the pool, held by a thread or not.
+     *
+     * @note the tables held by a running search can be modified while the function reads them.
+     *
+     * @param[in] function function called with each table.
+     *
+     */
+    template<typename Function>
+    static void for_each(Function function)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<Table>& table : tables) {
+            function(*table);
+        }
+    }
+
+    TablePool() = delete;
+    ~TablePool() = delete;
+
+private:
+    /**
+     * @brief Lease
+     *
+     * Table held by one thread while the thread is alive.
+     *
+     */
+    struct Lease
+    {
+        Lease()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (freeTables.empty()) {
+                tables.push_back(std::make_unique<Table>());
+                table = tables.back().get();
+            }
+            else {
+                table = freeTables.back();
+                freeTables.pop_back();
+            }
+        }
+
+        ~Lease()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeTables.push_back(table);
+        }
+
+        Table* table;
+    };
+
+    static inline std::mutex mutex;
+    static inline std::vector<std::unique_ptr<Table>> tables;   // every table created
+    static inline std::vector<Table*> freeTables;               // tables not held by any thread
+};
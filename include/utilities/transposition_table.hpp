@@ -9,6 +9,7 @@
  */
 
 #include <vector>
+#include <limits>
 #include <bit_utilities.hpp>
 #include "move.hpp"
 
@@ -21,6 +22,11 @@
 class TranspositionTable
 {
 public:
+    /**
+     * @brief value stored in the entries without static evaluation
+     */
+    static constexpr int NO_STATIC_EVAL = std::numeric_limits<int>::min();
+
     enum class SIZE : int;
     enum class NodeType : uint8_t;
     class Entry;
@@ -52,13 +58,46 @@ public:
      * @param[in] move best mode of the position
      * @param[in] node_type node type 
      * @param[in] depth depth 
+     * @param[in] static_eval (optional) static evaluation of the position
+     * 
+     * @note the move can be Move::null() in quiescence search entries.
      * 
      */
-    static inline constexpr void store_entry(uint64_t zobrist, int eval, Move move, NodeType node_type, int8_t depth)
+    static inline constexpr void store_entry(uint64_t zobrist, int eval, Move move, NodeType node_type, int8_t depth,
+                                             int static_eval = NO_STATIC_EVAL)
     {
-        entries[index_in_table(zobrist)] = Entry(zobrist, eval, move, node_type, depth);
+        entries[index_in_table(zobrist)] = Entry(zobrist, eval, move, node_type, depth, static_eval);
         assert(entries[index_in_table(zobrist)].is_valid());
-        assert(move.is_valid());
+    }
+
+    /**
+     * @brief store_quiescence_entry(uint64_t)
+     * 
+     * stores an entry of the quiescence search in the transposition table
+     * 
+     * @param[in] zobrist zobrist hash key of the position 
+     * @param[in] eval evaluation of the position
+     * @param[in] move best mode of the position
+     * @param[in] node_type node type 
+     * @param[in] depth depth, 0 or less in the quiescence search
+     * @param[in] static_eval (optional) static evaluation of the position
+     * 
+     * @note entries of the main search (depth > 0) are never replaced, they are more expensive and keep the move
+     * ordering of the next iterations.
+     * 
+     */
+    static inline constexpr void store_quiescence_entry(uint64_t zobrist, int eval, Move move, NodeType node_type,
+                                                        int8_t depth, int static_eval = NO_STATIC_EVAL)
+    {
+        assert(depth <= 0);
+
+        const Entry& entry = entries[index_in_table(zobrist)];
+
+        if (entry.is_valid() && entry.depth > 0) {
+            return;
+        }
+
+        store_entry(zobrist, eval, move, node_type, depth, static_eval);
     }
 
     /**
@@ -73,7 +112,6 @@ public:
     {
         entries[index_in_table(entry.key)] = entry;
         assert(entries[index_in_table(entry.key)].is_valid());
-        assert(entry.move.is_valid());
     }
 
     /**
@@ -88,6 +126,14 @@ public:
      */
     static void resize(SIZE new_size_mb);
 
+    /**
+     * @brief clear()
+     * 
+     * remove all the entries of the transposition table
+     * 
+     */
+    static void clear();
+
     /**
      * @brief int_to_tt_size(int)
      * 
@@ -115,6 +161,15 @@ public:
      */
     static inline constexpr uint32_t get_num_entries() { return entries.size(); }
 
+    /**
+     * @brief hashfull()
+     *
+     * Occupation of the table sampled in the first entries (uci hashfull).
+     * 
+     * @return (int) per mille of the sampled entries in use.
+     */
+    static int hashfull();
+
     /**
      * @brief returns the memory address of the entry in the tt
      *
@@ -223,6 +278,7 @@ public:
      *   - move.       
      *   - node_type.  
      *   - depth. 
+     *   - static_eval.
      */
     class Entry
     {
@@ -263,12 +319,21 @@ public:
          */
         int8_t depth;
 
+        /**
+         * @brief Static evaluation of the chess position.
+         *
+         * Evaluation of the position without search, NO_STATIC_EVAL if it was not calculated.
+         */
+        int static_eval;
+
         /**
          * @brief Default constructor for an entry.
          *
          * Initializes the entry with default values, marking it as invalid.
          */
-        constexpr Entry() : key(0ULL), evaluation(0), move(), node_type(NodeType::FAILED), depth(0U) { }
+        constexpr Entry()
+            : key(0ULL), evaluation(0), move(), node_type(NodeType::FAILED), depth(0U), static_eval(NO_STATIC_EVAL)
+        { }
 
         /**
          * @brief Copy constructor for an entry.
@@ -279,7 +344,7 @@ public:
          */
         constexpr Entry(const Entry& entry)
             : key(entry.key), evaluation(entry.evaluation), move(entry.move), node_type(entry.node_type),
-            depth(entry.depth)
+            depth(entry.depth), static_eval(entry.static_eval)
         { }
 
         /**
@@ -292,9 +357,11 @@ public:
          * @param[in] move Best move found for the position.
          * @param[in] node_type Type of the node in the search tree.
          * @param[in] depth Depth at which the position was evaluated.
+         * @param[in] static_eval (optional) Static evaluation of the position.
          */
-        constexpr Entry(uint64_t key, int evaluation, Move move, NodeType node_type, uint8_t depth)
-            : key(key), evaluation(evaluation), move(move), node_type(node_type), depth(depth)
+        constexpr Entry(uint64_t key, int evaluation, Move move, NodeType node_type, int8_t depth,
+                        int static_eval = NO_STATIC_EVAL)
+            : key(key), evaluation(evaluation), move(move), node_type(node_type), depth(depth), static_eval(static_eval)
         { }
 
         /**
@@ -319,7 +386,7 @@ public:
          * @brief Equality operator.
          *
          * Compares two entries for equality based on their key, evaluation, move,
-         * node type, and depth.
+         * node type, depth and static evaluation.
          *
          * @param[in] other The entry to compare with.
          * @return True if the entries are equal, false otherwise.
@@ -327,7 +394,7 @@ public:
         constexpr bool operator==(const Entry& other) const
         {
             return key == other.key && evaluation == other.evaluation && move == other.move &&
-                node_type == other.node_type && depth == other.depth;
+                node_type == other.node_type && depth == other.depth && static_eval == other.static_eval;
         }
 
         /**
@@ -357,6 +424,7 @@ public:
                 this->move = other.move;
                 this->node_type = other.node_type;
                 this->depth = other.depth;
+                this->static_eval = other.static_eval;
             }
             return *this;
         }
@@ -11,6 +11,7 @@
  */
 
 #include "board.hpp"
+#include "bit_utilities.hpp"
 #include <random>
 #include <array>
 
@@ -70,6 +71,71 @@ public:
         return hash;
     }
 
+    /**
+     * @brief pawn_hash(const Board&)
+     * 
+     * @param[in] position board containing the chess position
+     * 
+     * @return the hash key of the pawns of the chess position
+     * 
+     */
+    static uint64_t pawn_hash(const Board& position)
+    {
+        init_random_numbers_only_once();   // initialize the random numbers only the first time is executed
+
+        uint64_t hash = 0ULL;
+
+        for (const Piece pawn : {Piece::W_PAWN, Piece::B_PAWN}) {
+            uint64_t pawns = position.get_bitboard_piece(pawn);
+            while (pawns) {
+                hash ^= get_seed(Square(pop_lsb(pawns)), pawn);
+            }
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief material_hash(const Board&)
+     * 
+     * @param[in] position board containing the chess position
+     * 
+     * @return the hash key of the number of pieces of each type of the chess position
+     * 
+     */
+    static uint64_t material_hash(const Board& position)
+    {
+        init_random_numbers_only_once();   // initialize the random numbers only the first time is executed
+
+        uint64_t hash = 0ULL;
+
+        for (Piece piece = Piece::W_PAWN; piece != Piece::EMPTY; piece = piece + 1) {
+            const int count = number_of_1_bits(position.get_bitboard_piece(piece));
+            for (int i = 0; i < count; i++) {
+                hash ^= get_material_seed(piece, i);
+            }
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief get_material_seed(Piece, int)
+     * 
+     * seed of the i-th piece of a type, the material key is the xor of the seeds of all the pieces
+     * 
+     * @param[in] piece piece
+     * @param[in] index number of pieces of the same type before this one
+     * 
+     * @return square_piece_seed[index][piece]
+     */
+    inline static uint64_t get_material_seed(Piece piece, int index)
+    {
+        assert(0 <= index && index < NUM_SQUARES);
+
+        return get_seed(Square(static_cast<uint8_t>(index)), piece);
+    }
+
     /**
      * @brief get_seed(Square, Piece)
      * 
@@ -155,13 +221,10 @@ private:
             return;
         }
 
-#ifndef NDEBUG
+        // constant seed, the keys (and the transposition table) must be the same in every run
+        // so node limited searches are reproducible
         const uint64_t SEED = 123456789ULL;
-        std::mt19937_64 gen(SEED);   // Use constant seed in debug mode
-#else
-        std::random_device rd;
-        std::mt19937_64 gen(rd());   // Use random seed in release mode
-#endif
+        std::mt19937_64 gen(SEED);
 
         std::uniform_int_distribution<uint64_t> dis;
 
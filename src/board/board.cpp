@@ -92,13 +92,20 @@ void Board::make_move(Move move)
         game_state.set_num_pieces(game_state.num_pieces() - 1);
         const Piece enemy_pawn = create_piece(PieceType::PAWN, opposite_color(get_color(origin_piece)));
         const Piece captured_piece = move.type() != MoveType::EN_PASSANT ? end_piece : enemy_pawn;
-        game_state.set_piece_counter(captured_piece, game_state.get_piece_counter(captured_piece) - 1);
+        const int captured_count = game_state.get_piece_counter(captured_piece) - 1;
+        game_state.set_piece_counter(captured_piece, captured_count);
+        game_state.xor_material_key(Zobrist::get_material_seed(captured_piece, captured_count));
     }
 
     if (move.type() == MoveType::PROMOTION) {
-        game_state.set_piece_counter(origin_piece, game_state.get_piece_counter(origin_piece) - 1);
+        const int pawn_count = game_state.get_piece_counter(origin_piece) - 1;
+        game_state.set_piece_counter(origin_piece, pawn_count);
+        game_state.xor_material_key(Zobrist::get_material_seed(origin_piece, pawn_count));
+
         const Piece promoted_piece = create_piece(move.promotion_piece(), get_color(origin_piece));
-        game_state.set_piece_counter(promoted_piece, game_state.get_piece_counter(promoted_piece) + 1);
+        const int promoted_count = game_state.get_piece_counter(promoted_piece);
+        game_state.set_piece_counter(promoted_piece, promoted_count + 1);
+        game_state.xor_material_key(Zobrist::get_material_seed(promoted_piece, promoted_count));
     }
 
     game_state.set_attacks_updated(false);
@@ -252,6 +259,8 @@ void Board::load_fen(const std::string& fen)
     game_state.set_move_number(moveNumber);
 
     game_state.set_zobrist_key(Zobrist::hash(*this));
+    game_state.set_pawn_key(Zobrist::pawn_hash(*this));
+    game_state.set_material_key(Zobrist::material_hash(*this));
 
     game_state.set_num_pieces(number_of_1_bits(bitboard_all));
     update_piece_counter();
@@ -395,6 +404,14 @@ void Board::make_normal_move(Move normal_move)
         game_state.xor_zobrist(Zobrist::get_seed(end_sq, end_piece));
     }
 
+    // update pawn hash if a pawn moved or was captured
+    if (piece_to_pieceType(origin_piece) == PieceType::PAWN) {
+        game_state.xor_pawn_key(Zobrist::get_seed(origin_sq, origin_piece) ^ Zobrist::get_seed(end_sq, origin_piece));
+    }
+    if (piece_to_pieceType(end_piece) == PieceType::PAWN) {
+        game_state.xor_pawn_key(Zobrist::get_seed(end_sq, end_piece));
+    }
+
     // captured piece will be Empty if move was not a capture
     game_state.set_last_captured_piece(piece_to_pieceType(end_piece));
 
@@ -459,6 +476,9 @@ void Board::make_promotion_move(Move promotion_move)
         game_state.xor_zobrist(Zobrist::get_seed(end_square, end_piece));
     }
 
+    // the promoted pawn leaves the pawn hash
+    game_state.xor_pawn_key(Zobrist::get_seed(origin_square, moved_piece));
+
     // captured piece will be Empty if move was not a capture
     game_state.set_last_captured_piece(piece_to_pieceType(end_piece));
     //en Passant will be invalid
@@ -641,6 +661,10 @@ void Board::make_enPassant_move(Move enPassant_move)
 
     game_state.xor_zobrist(Zobrist::get_seed(captured_pawn_square, captured_pawn_piece));
 
+    game_state.xor_pawn_key(Zobrist::get_seed(origin_square, attacker_pawn_piece) ^
+                            Zobrist::get_seed(end_square, attacker_pawn_piece) ^
+                            Zobrist::get_seed(captured_pawn_square, captured_pawn_piece));
+
     put_piece(attacker_pawn_piece, end_square);
     remove_piece(origin_square);
     remove_piece(captured_pawn_square);
@@ -803,6 +827,98 @@ void Board::update_attacks_bb()
     game_state.set_attacks_updated(true);
 }
 
+/**
+ * @brief in_check
+ * 
+ * calculate if the king of the side to move is attacked.
+ * 
+ * @return True if the side to move is in check
+ * 
+ */
+bool Board::in_check() const
+{
+    const ChessColor us = game_state.side_to_move();
+    const ChessColor them = opposite_color(us);
+    const Square king_sq(lsb(get_bitboard_piece(create_piece(PieceType::KING, us))));
+
+    const uint64_t bishops_queens = get_bitboard_piece(create_piece(PieceType::BISHOP, them)) |
+        get_bitboard_piece(create_piece(PieceType::QUEEN, them));
+    const uint64_t rooks_queens = get_bitboard_piece(create_piece(PieceType::ROOK, them)) |
+        get_bitboard_piece(create_piece(PieceType::QUEEN, them));
+
+    return (PrecomputedMoveData::pawnAttacks(king_sq, us) & get_bitboard_piece(create_piece(PieceType::PAWN, them))) ||
+        (PrecomputedMoveData::knightAttacks(king_sq) & get_bitboard_piece(create_piece(PieceType::KNIGHT, them))) ||
+        (PrecomputedMoveData::bishopMoves(king_sq, bitboard_all) & bishops_queens) ||
+        (PrecomputedMoveData::rookMoves(king_sq, bitboard_all) & rooks_queens);
+}
+
+/**
+ * @brief move_gives_check
+ * 
+ * calculate if a move attacks the enemy king, direct checks, discovered checks by sliders and castling checks.
+ * 
+ * @param[in] move chess move, must be legal in the position.
+ * 
+ * @return True if the move gives check
+ * 
+ */
+bool Board::move_gives_check(Move move) const
+{
+    assert(move.is_valid());
+
+    if (move.type() == MoveType::CASTLING) {
+        // only the rook can give check, look from its destination with the king already moved
+        const bool king_side = move.square_to().col() == COL_G;
+        const Square rook_from = king_side ? move.square_to().east() : move.square_to().west().west();
+        const Square rook_to = king_side ? move.square_to().west() : move.square_to().east();
+        const uint64_t enemy_king =
+            get_bitboard_piece(create_piece(PieceType::KING, opposite_color(game_state.side_to_move())));
+
+        const uint64_t occupied =
+            (bitboard_all & ~move.square_from().mask() & ~rook_from.mask()) | move.square_to().mask() | rook_to.mask();
+
+        return PrecomputedMoveData::rookMoves(rook_to, occupied) & enemy_king;
+    }
+
+    const Square from = move.square_from();
+    const Square to = move.square_to();
+    const ChessColor us = game_state.side_to_move();
+    const Square enemy_king_sq(lsb(get_bitboard_piece(create_piece(PieceType::KING, opposite_color(us)))));
+
+    const PieceType moved_piece =
+        move.type() == MoveType::PROMOTION ? move.promotion_piece() : piece_to_pieceType(get_piece(from));
+
+    uint64_t occupied = (bitboard_all & ~from.mask()) | to.mask();
+
+    if (move.type() == MoveType::EN_PASSANT) {
+        occupied &= ~(is_white(us) ? to.south() : to.north()).mask();
+    }
+
+    // direct checks of non slider pieces
+    if (moved_piece == PieceType::PAWN && (PrecomputedMoveData::pawnAttacks(to, us) & enemy_king_sq.mask())) {
+        return true;
+    }
+    if (moved_piece == PieceType::KNIGHT && (PrecomputedMoveData::knightAttacks(to) & enemy_king_sq.mask())) {
+        return true;
+    }
+
+    // slider checks from the enemy king square, direct or discovered
+    const uint64_t moved_mask = is_slider(moved_piece) ? to.mask() : 0ULL;
+
+    const uint64_t bishops_queens = ((get_bitboard_piece(create_piece(PieceType::BISHOP, us)) |
+                                      get_bitboard_piece(create_piece(PieceType::QUEEN, us))) &
+                                     ~from.mask()) |
+        (moved_piece == PieceType::ROOK ? 0ULL : moved_mask);
+
+    const uint64_t rooks_queens = ((get_bitboard_piece(create_piece(PieceType::ROOK, us)) |
+                                    get_bitboard_piece(create_piece(PieceType::QUEEN, us))) &
+                                   ~from.mask()) |
+        (moved_piece == PieceType::BISHOP ? 0ULL : moved_mask);
+
+    return (PrecomputedMoveData::bishopMoves(enemy_king_sq, occupied) & bishops_queens) ||
+        (PrecomputedMoveData::rookMoves(enemy_king_sq, occupied) & rooks_queens);
+}
+
 /**
  * @brief recalculates all the number of pieces
  */
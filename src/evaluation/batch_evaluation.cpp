@@ -0,0 +1,203 @@
+/**
+ * @file batch_evaluation.cpp
+ * @brief batch evaluation services implementation.
+ *
+ * Material and PST evaluation of many positions at once, evaluated with AVX-512 or scalar kernels.
+ *
+ * https://www.chessprogramming.org/Tapered_Eval
+ * https://www.chessprogramming.org/Population_Count
+ *
+ */
+
+#include "batch_evaluation.hpp"
+#include "precomputed_eval_data.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+#include <array>
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+static constexpr int NUM_PIECE_BITBOARDS = NUM_CHESS_PIECES - 1;
+
+static std::array<int32_t, NUM_PIECE_BITBOARDS * 64> init_piece_scores();
+static inline int game_phase(const CompactPosition& position);
+static inline int taper(int32_t score, int game_phase);
+
+/**
+ * @brief material + PST score of each piece in each square, [piece][square]
+ */
+alignas(64) static const std::array<int32_t, NUM_PIECE_BITBOARDS * 64> PIECE_SCORES = init_piece_scores();
+
+/**
+ * @brief evaluate(const CompactPosition*, size_t, int*)
+ *
+ * Evaluate an array of positions.
+ *
+ * @param[in] positions positions to evaluate.
+ * @param[in] count number of positions.
+ * @param[out] evaluations evaluation of each position, positive if white is better.
+ *
+ */
+void BatchEvaluation::evaluate(const CompactPosition* positions, size_t count, int* evaluations)
+{
+    size_t first = 0U;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    constexpr size_t LANES = BATCH_LANES;
+    static_assert(LANES == 16U, "one position per 32 bit lane of a 512 bit register");
+
+    for (; first + LANES <= count; first += LANES) {
+
+        __m512i sums[LANES];
+        alignas(64) int32_t phases[LANES];
+
+        // material and PST, each bitboard is the mask of the squares of its PST row that are added
+        for (size_t lane = 0; lane < LANES; lane++) {
+            const CompactPosition& position = positions[first + lane];
+            __m512i score[4] = {_mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512(),
+                                _mm512_setzero_si512()};
+
+            for (int piece = 0; piece < NUM_PIECE_BITBOARDS; piece++) {
+                const uint64_t bitboard = position.pieces[piece];
+                if (bitboard == 0ULL) {
+                    continue;
+                }
+                const int32_t* row = PIECE_SCORES.data() + piece * 64;
+                for (int k = 0; k < 4; k++) {
+                    score[k] = _mm512_mask_add_epi32(score[k], static_cast<__mmask16>(bitboard >> (16 * k)), score[k],
+                                                     _mm512_load_si512(row + 16 * k));
+                }
+            }
+
+            sums[lane] = _mm512_add_epi32(_mm512_add_epi32(score[0], score[1]), _mm512_add_epi32(score[2], score[3]));
+            phases[lane] = game_phase(position);
+        }
+
+        // horizontal sums of the sixteen positions at once, lane i of score is the sum of sums[i]
+        __m512i pairs[LANES / 2];
+        for (size_t i = 0; i < LANES / 2; i++) {
+            pairs[i] = _mm512_add_epi32(_mm512_unpacklo_epi32(sums[2 * i], sums[2 * i + 1]),
+                                        _mm512_unpackhi_epi32(sums[2 * i], sums[2 * i + 1]));
+        }
+        __m512i quads[LANES / 4];
+        for (size_t i = 0; i < LANES / 4; i++) {
+            quads[i] = _mm512_add_epi32(_mm512_unpacklo_epi64(pairs[2 * i], pairs[2 * i + 1]),
+                                        _mm512_unpackhi_epi64(pairs[2 * i], pairs[2 * i + 1]));
+        }
+        const __m512i low = _mm512_add_epi32(_mm512_shuffle_i32x4(quads[0], quads[1], 0b10001000),
+                                             _mm512_shuffle_i32x4(quads[0], quads[1], 0b11011101));
+        const __m512i high = _mm512_add_epi32(_mm512_shuffle_i32x4(quads[2], quads[3], 0b10001000),
+                                              _mm512_shuffle_i32x4(quads[2], quads[3], 0b11011101));
+        const __m512i score = _mm512_add_epi32(_mm512_shuffle_i32x4(low, high, 0b10001000),
+                                               _mm512_shuffle_i32x4(low, high, 0b11011101));
+
+        // tapered evaluation of the sixteen positions,
+        // (middlegame * phase + endgame * (MAX_GAME_PHASE - phase)) / MAX_GAME_PHASE
+        const __m512i phase = _mm512_min_epi32(_mm512_load_si512(phases), _mm512_set1_epi32(MAX_GAME_PHASE));
+        const __m512i middlegame = _mm512_srai_epi32(_mm512_slli_epi32(score, 16), 16);
+        const __m512i endgame = _mm512_srai_epi32(_mm512_add_epi32(score, _mm512_set1_epi32(0x8000)), 16);
+        const __m512i blended =
+            _mm512_add_epi32(_mm512_mullo_epi32(middlegame, phase),
+                             _mm512_mullo_epi32(endgame, _mm512_sub_epi32(_mm512_set1_epi32(MAX_GAME_PHASE), phase)));
+
+        // the float division is exact for these values and truncates like the integer division
+        const __m512 quotient =
+            _mm512_div_ps(_mm512_cvtepi32_ps(blended), _mm512_set1_ps(static_cast<float>(MAX_GAME_PHASE)));
+        _mm512_storeu_si512(evaluations + first, _mm512_cvttps_epi32(quotient));
+    }
+#endif
+
+    for (; first < count; first++) {
+        evaluations[first] = evaluate(positions[first]);
+    }
+}
+
+/**
+ * @brief evaluate(const CompactPosition&)
+ *
+ * Evaluate one position, reference of the batch kernel.
+ *
+ * @param[in] position position to evaluate.
+ *
+ * @return (int) evaluation, positive if white is better.
+ *
+ */
+int BatchEvaluation::evaluate(const CompactPosition& position)
+{
+    int32_t score = 0;
+    int phase = 0;
+
+    for (int p = 0; p < NUM_PIECE_BITBOARDS; p++) {
+        const Piece piece = static_cast<Piece>(p);
+        uint64_t bitboard = position.pieces[p];
+
+        while (bitboard) {
+            const Square square(pop_lsb(bitboard));
+            score += PrecomputedEvalData::get_piece_score(piece, square);
+            phase += PrecomputedEvalData::get_phase_weight(piece);
+        }
+    }
+
+    return taper(score, phase);
+}
+
+/**
+ * @brief game_phase(const CompactPosition&)
+ *
+ * @param[in] position chess position.
+ *
+ * @return (int) game phase, minor pieces 1, rooks 2 and queens 4, not capped.
+ *
+ */
+static inline int game_phase(const CompactPosition& position)
+{
+    const uint64_t minors = position.pieces[static_cast<int>(Piece::W_KNIGHT)] |
+        position.pieces[static_cast<int>(Piece::B_KNIGHT)] | position.pieces[static_cast<int>(Piece::W_BISHOP)] |
+        position.pieces[static_cast<int>(Piece::B_BISHOP)];
+    const uint64_t rooks =
+        position.pieces[static_cast<int>(Piece::W_ROOK)] | position.pieces[static_cast<int>(Piece::B_ROOK)];
+    const uint64_t queens =
+        position.pieces[static_cast<int>(Piece::W_QUEEN)] | position.pieces[static_cast<int>(Piece::B_QUEEN)];
+
+    return number_of_1_bits(minors) + 2 * number_of_1_bits(rooks) + 4 * number_of_1_bits(queens);
+}
+
+/**
+ * @brief taper(int32_t, int)
+ *
+ * @param[in] score packed material + PST score.
+ * @param[in] game_phase game phase of the position, capped to MAX_GAME_PHASE.
+ *
+ * @return (int) blend of the middlegame and endgame scores.
+ *
+ */
+static inline int taper(int32_t score, int game_phase)
+{
+    const int middlegame_percentage = std::min(game_phase, MAX_GAME_PHASE);
+    const int endgame_percentage = MAX_GAME_PHASE - middlegame_percentage;
+
+    return (middlegame_score(score) * middlegame_percentage + endgame_score(score) * endgame_percentage) /
+        MAX_GAME_PHASE;
+}
+
+/**
+ * @brief init_piece_scores()
+ *
+ * @return material + PST score of each piece in each square, [piece][square].
+ *
+ */
+static std::array<int32_t, NUM_PIECE_BITBOARDS * 64> init_piece_scores()
+{
+    std::array<int32_t, NUM_PIECE_BITBOARDS * 64> scores {};
+
+    for (int piece = 0; piece < NUM_PIECE_BITBOARDS; piece++) {
+        for (uint8_t square = 0; square < NUM_SQUARES; square++) {
+            scores[piece * 64 + square] =
+                PrecomputedEvalData::get_piece_score(static_cast<Piece>(piece), Square(square));
+        }
+    }
+
+    return scores;
+}
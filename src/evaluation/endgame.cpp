@@ -0,0 +1,402 @@
+/**
+ * @file endgame.cpp
+ * @brief endgame evaluation implementation.
+ *
+ * Specialized evaluation and scaling functions of known endgames, selected by the material table.
+ *
+ * https://www.chessprogramming.org/Endgame
+ * https://www.chessprogramming.org/KPK
+ *
+ */
+
+#include "endgame.hpp"
+#include "precomputed_eval_data.hpp"
+#include "precomputed_move_data.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+// squares of the same color as A1
+static constexpr uint64_t DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+// bonus for the distance between the kings, the strong king must approach the lone king
+static constexpr int PUSH_CLOSE[8] = {0, 0, 100, 80, 60, 40, 20, 10};
+
+static constexpr inline int push_to_edge(Square square);
+static constexpr inline int push_to_dark_corner(Square square);
+static constexpr inline Square flip_row(Square square);
+static constexpr inline Square flip_col(Square square);
+
+/**
+ * @brief KpkBitbase
+ *
+ * Result of every position of king and pawn against king, generated by retrograde analysis the first time
+ * it is probed. White has the pawn in the cols A-D, the other positions are mirrored.
+ *
+ */
+class KpkBitbase
+{
+public:
+    /**
+     * @brief probe(Square, Square, Square, ChessColor)
+     *
+     * @param[in] white_king white king square.
+     * @param[in] pawn white pawn square, col A-D.
+     * @param[in] black_king black king square.
+     * @param[in] side_to_move side to move.
+     *
+     * @return true if white wins.
+     *
+     */
+    static bool probe(Square white_king, Square pawn, Square black_king, ChessColor side_to_move)
+    {
+        static const KpkBitbase bitbase;   // generated only once, thread safe initialization
+
+        const int i = index(side_to_move, black_king, white_king, pawn);
+        return (bitbase.winBits[i >> 5] >> (i & 31)) & 1U;
+    }
+
+private:
+    enum Result : uint8_t
+    {
+        INVALID = 0,
+        UNKNOWN = 1,
+        DRAW = 2,
+        WIN = 4
+    };
+
+    // side to move, 24 pawn squares (cols A-D, rows 2-7), black king and white king
+    static constexpr int MAX_INDEX = 2 * 24 * 64 * 64;
+
+    KpkBitbase();
+
+    static constexpr inline int index(ChessColor side_to_move, Square black_king, Square white_king, Square pawn)
+    {
+        return white_king.value() | (black_king.value() << 6) | (static_cast<int>(side_to_move) << 12) |
+            (static_cast<int>(pawn.col()) << 13) | ((static_cast<int>(ROW_7) - static_cast<int>(pawn.row())) << 15);
+    }
+
+    static Result initial_result(ChessColor side_to_move, Square black_king, Square white_king, Square pawn);
+    static Result classify(const std::vector<uint8_t>& db, ChessColor side_to_move, Square black_king,
+                           Square white_king, Square pawn);
+
+    std::array<uint32_t, MAX_INDEX / 32> winBits;
+};
+
+/**
+ * @brief KpkBitbase
+ *
+ * Classifies the positions that are decided in one move and iterates over the unknown positions
+ * until none of them changes, the positions still unknown are draws.
+ *
+ */
+KpkBitbase::KpkBitbase() : winBits {}
+{
+    std::vector<uint8_t> db(MAX_INDEX);
+
+    const auto decode = [](int i, ChessColor& side_to_move, Square& black_king, Square& white_king, Square& pawn) {
+        white_king = Square(static_cast<uint8_t>(i & 63));
+        black_king = Square(static_cast<uint8_t>((i >> 6) & 63));
+        side_to_move = static_cast<ChessColor>((i >> 12) & 1);
+        pawn = Square(static_cast<Row>(static_cast<int>(ROW_7) - (i >> 15)), static_cast<Col>((i >> 13) & 3));
+    };
+
+    ChessColor side_to_move;
+    Square black_king, white_king, pawn;
+
+    for (int i = 0; i < MAX_INDEX; i++) {
+        decode(i, side_to_move, black_king, white_king, pawn);
+        db[i] = initial_result(side_to_move, black_king, white_king, pawn);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < MAX_INDEX; i++) {
+            if (db[i] == UNKNOWN) {
+                decode(i, side_to_move, black_king, white_king, pawn);
+                db[i] = classify(db, side_to_move, black_king, white_king, pawn);
+                changed |= db[i] != UNKNOWN;
+            }
+        }
+    }
+
+    for (int i = 0; i < MAX_INDEX; i++) {
+        if (db[i] == WIN) {
+            winBits[i >> 5] |= 1U << (i & 31);
+        }
+    }
+}
+
+/**
+ * @brief initial_result(ChessColor, Square, Square, Square)
+ *
+ * Result of the illegal positions and the positions decided in one move.
+ *
+ */
+KpkBitbase::Result KpkBitbase::initial_result(ChessColor side_to_move, Square black_king, Square white_king,
+                                              Square pawn)
+{
+    const uint64_t pawn_attacks = PrecomputedMoveData::pawnAttacks(pawn, ChessColor::WHITE);
+
+    if (PrecomputedEvalData::get_distance_chebyshev(white_king, black_king) <= 1 || white_king == pawn ||
+        black_king == pawn || (is_white(side_to_move) && (pawn_attacks & black_king.mask()))) {
+        return INVALID;
+    }
+
+    // the pawn promotes and the queen can not be captured
+    if (is_white(side_to_move) && pawn.row() == ROW_7) {
+        const Square promotion(ROW_8, pawn.col());
+        if (white_king != promotion && (PrecomputedEvalData::get_distance_chebyshev(black_king, promotion) > 1 ||
+                                        PrecomputedEvalData::get_distance_chebyshev(white_king, promotion) == 1)) {
+            return WIN;
+        }
+    }
+
+    if (!is_white(side_to_move)) {
+        const uint64_t black_king_moves = PrecomputedMoveData::kingAttacks(black_king);
+        const uint64_t white_king_attacks = PrecomputedMoveData::kingAttacks(white_king);
+
+        // stalemate or the pawn is captured
+        if ((black_king_moves & ~(white_king_attacks | pawn_attacks)) == 0ULL ||
+            (black_king_moves & pawn.mask() & ~white_king_attacks) != 0ULL) {
+            return DRAW;
+        }
+    }
+
+    return UNKNOWN;
+}
+
+/**
+ * @brief classify(const std::vector<uint8_t>&, ChessColor, Square, Square, Square)
+ *
+ * White wins if one move leads to a win, black draws if one move leads to a draw.
+ *
+ */
+KpkBitbase::Result KpkBitbase::classify(const std::vector<uint8_t>& db, ChessColor side_to_move, Square black_king,
+                                        Square white_king, Square pawn)
+{
+    const Result good = is_white(side_to_move) ? WIN : DRAW;
+    const Result bad = is_white(side_to_move) ? DRAW : WIN;
+
+    uint8_t result = INVALID;
+    uint64_t king_moves = PrecomputedMoveData::kingAttacks(is_white(side_to_move) ? white_king : black_king);
+
+    while (king_moves) {
+        const Square to(pop_lsb(king_moves));
+        result |= is_white(side_to_move) ? db[index(ChessColor::BLACK, black_king, to, pawn)]
+                                         : db[index(ChessColor::WHITE, to, white_king, pawn)];
+    }
+
+    if (is_white(side_to_move) && pawn.row() < ROW_7) {
+        const Square single_push(pawn.row() + 1, pawn.col());
+        result |= db[index(ChessColor::BLACK, black_king, white_king, single_push)];
+
+        if (pawn.row() == ROW_2 && single_push != white_king && single_push != black_king) {
+            result |= db[index(ChessColor::BLACK, black_king, white_king, Square(ROW_4, pawn.col()))];
+        }
+    }
+
+    return result & good ? good : result & UNKNOWN ? UNKNOWN : bad;
+}
+
+/**
+ * @brief kpk_probe(Square, Square, Square, ChessColor)
+ *
+ * Probe the KPK bitbase, white has the king and the pawn.
+ *
+ * @param[in] white_king white king square.
+ * @param[in] pawn white pawn square.
+ * @param[in] black_king black king square.
+ * @param[in] side_to_move side to move.
+ *
+ * @return true if white wins, false if the position is a draw.
+ *
+ */
+bool kpk_probe(Square white_king, Square pawn, Square black_king, ChessColor side_to_move)
+{
+    if (pawn.col() >= COL_E) {
+        return KpkBitbase::probe(flip_col(white_king), flip_col(pawn), flip_col(black_king), side_to_move);
+    }
+    return KpkBitbase::probe(white_king, pawn, black_king, side_to_move);
+}
+
+/**
+ * @brief evaluate_KXK(const Board&)
+ *
+ * Lone king against mating material (KRK, KQK, ...), push the lone king to the edge and the kings together.
+ *
+ * @tparam strong side with the mating material.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KXK(const Board& board)
+{
+    constexpr ChessColor weak = opposite_color(strong);
+
+    const Square strong_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, strong))));
+    const Square weak_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, weak))));
+    const uint64_t bishops = board.get_bitboard_piece(create_piece(PieceType::BISHOP, strong));
+
+    int result = PUSH_CLOSE[PrecomputedEvalData::get_distance_chebyshev(strong_king, weak_king)] +
+        push_to_edge(weak_king);
+
+    for (const PieceType type : {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK,
+                                 PieceType::QUEEN}) {
+        const Piece piece = create_piece(type, strong);
+        result += board.get_piece_counter(piece) * static_cast<int>(raw_value(piece));
+    }
+
+    const bool forced_mate = board.get_piece_counter(create_piece(PieceType::QUEEN, strong)) ||
+        board.get_piece_counter(create_piece(PieceType::ROOK, strong)) ||
+        (bishops && board.get_piece_counter(create_piece(PieceType::KNIGHT, strong))) ||
+        ((bishops & DARK_SQUARES) && (bishops & ~DARK_SQUARES));
+
+    if (forced_mate) {
+        result += KNOWN_WIN;
+    }
+
+    return is_white(strong) ? result : -result;
+}
+
+/**
+ * @brief evaluate_KBNK(const Board&)
+ *
+ * King, bishop and knight against king, push the lone king to a corner of the color of the bishop.
+ *
+ * @tparam strong side with the bishop and the knight.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KBNK(const Board& board)
+{
+    constexpr ChessColor weak = opposite_color(strong);
+
+    const Square strong_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, strong))));
+    Square weak_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, weak))));
+
+    // the mate is only possible in the corners of the color of the bishop, mirror the light squares to the dark
+    if ((board.get_bitboard_piece(create_piece(PieceType::BISHOP, strong)) & DARK_SQUARES) == 0ULL) {
+        weak_king = flip_col(weak_king);
+    }
+
+    const int result = KNOWN_WIN + PUSH_CLOSE[PrecomputedEvalData::get_distance_chebyshev(strong_king, weak_king)] +
+        push_to_dark_corner(weak_king);
+
+    return is_white(strong) ? result : -result;
+}
+
+/**
+ * @brief evaluate_KPK(const Board&)
+ *
+ * King and pawn against king, exact result from the KPK bitbase.
+ *
+ * @tparam strong side with the pawn.
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation, positive if white is better, 0 if the position is a draw.
+ *
+ */
+template<ChessColor strong>
+int evaluate_KPK(const Board& board)
+{
+    constexpr ChessColor weak = opposite_color(strong);
+
+    Square strong_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, strong))));
+    Square weak_king(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, weak))));
+    Square pawn(lsb(board.get_bitboard_piece(create_piece(PieceType::PAWN, strong))));
+
+    // the bitbase is from the point of view of white
+    if constexpr (!is_white(strong)) {
+        strong_king = flip_row(strong_king);
+        weak_king = flip_row(weak_king);
+        pawn = flip_row(pawn);
+    }
+    const ChessColor side_to_move = board.state().side_to_move() == strong ? ChessColor::WHITE : ChessColor::BLACK;
+
+    if (!kpk_probe(strong_king, pawn, weak_king, side_to_move)) {
+        return 0;
+    }
+
+    const int result = KNOWN_WIN + static_cast<int>(raw_value(Piece::W_PAWN)) + static_cast<int>(pawn.row());
+
+    return is_white(strong) ? result : -result;
+}
+
+/**
+ * @brief scale_opposite_bishops(const Board&)
+ *
+ * Only bishops and pawns with one bishop each side, the bishops of opposite colors are drawish.
+ *
+ * @param[in] board chess position.
+ *
+ * @return (int) scale factor.
+ *
+ */
+int scale_opposite_bishops(const Board& board)
+{
+    const bool white_dark = (board.get_bitboard_piece(Piece::W_BISHOP) & DARK_SQUARES) != 0ULL;
+    const bool black_dark = (board.get_bitboard_piece(Piece::B_BISHOP) & DARK_SQUARES) != 0ULL;
+
+    return white_dark != black_dark ? SCALE_FACTOR_NORMAL / 2 : SCALE_FACTOR_NORMAL;
+}
+
+template int evaluate_KXK<ChessColor::WHITE>(const Board& board);
+template int evaluate_KXK<ChessColor::BLACK>(const Board& board);
+template int evaluate_KBNK<ChessColor::WHITE>(const Board& board);
+template int evaluate_KBNK<ChessColor::BLACK>(const Board& board);
+template int evaluate_KPK<ChessColor::WHITE>(const Board& board);
+template int evaluate_KPK<ChessColor::BLACK>(const Board& board);
+
+/**
+ * @brief push_to_edge(Square)
+ *
+ * @param[in] square square of the lone king.
+ *
+ * @return (int) bonus, higher when the square is far from the center.
+ *
+ */
+static constexpr inline int push_to_edge(Square square)
+{
+    const int row = static_cast<int>(square.row());
+    const int col = static_cast<int>(square.col());
+
+    return 40 * (std::max(3 - row, row - 4) + std::max(3 - col, col - 4));
+}
+
+/**
+ * @brief push_to_dark_corner(Square)
+ *
+ * @param[in] square square of the lone king.
+ *
+ * @return (int) bonus, higher when the square is close to A1 or H8.
+ *
+ */
+static constexpr inline int push_to_dark_corner(Square square)
+{
+    return 30 * std::abs(7 - static_cast<int>(square.row()) - static_cast<int>(square.col()));
+}
+
+/**
+ * @brief flip_row(Square)
+ *
+ * @return (Square) square in the same col and the opposite row (A1 <-> A8).
+ *
+ */
+static constexpr inline Square flip_row(Square square) { return Square(static_cast<uint8_t>(square.value() ^ 56U)); }
+
+/**
+ * @brief flip_col(Square)
+ *
+ * @return (Square) square in the same row and the opposite col (A1 <-> H1).
+ *
+ */
+static constexpr inline Square flip_col(Square square) { return Square(static_cast<uint8_t>(square.value() ^ 7U)); }
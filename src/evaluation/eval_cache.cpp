@@ -0,0 +1,72 @@
+/**
+ * @file eval_cache.cpp
+ * @brief evaluation cache implementation.
+ *
+ * Static evaluations cached by the zobrist key of the position.
+ *
+ * https://www.chessprogramming.org/Evaluation_Hash_Table
+ *
+ */
+
+#include "eval_cache.hpp"
+#include "table_pool.hpp"
+
+/**
+ * @brief EvalCache
+ *
+ * Allocates the entries.
+ *
+ */
+EvalCache::EvalCache() : entries(NUM_ENTRIES) {}
+
+/**
+ * @brief thread_cache()
+ *
+ * @return (EvalCache&) evaluation cache of the calling thread.
+ *
+ */
+EvalCache& EvalCache::thread_cache() { return TablePool<EvalCache>::thread_table(); }
+
+/**
+ * @brief clear_stats()
+ *
+ * Reset the probes and hits of all the caches.
+ *
+ * @note must not be called while a search is running.
+ *
+ */
+void EvalCache::clear_stats()
+{
+    TablePool<EvalCache>::for_each([](EvalCache& cache) {
+        cache.probeCount = 0ULL;
+        cache.hitCount = 0ULL;
+    });
+}
+
+/**
+ * @brief probes()
+ *
+ * @return (uint64_t) probes of all the caches since the last clear_stats.
+ *
+ */
+uint64_t EvalCache::probes()
+{
+    uint64_t probes = 0ULL;
+    TablePool<EvalCache>::for_each(
+        [&probes](const EvalCache& cache) { probes += cache.probeCount.load(std::memory_order_relaxed); });
+    return probes;
+}
+
+/**
+ * @brief hits()
+ *
+ * @return (uint64_t) hits of all the caches since the last clear_stats, each hit is an evaluation saved.
+ *
+ */
+uint64_t EvalCache::hits()
+{
+    uint64_t hits = 0ULL;
+    TablePool<EvalCache>::for_each(
+        [&hits](const EvalCache& cache) { hits += cache.hitCount.load(std::memory_order_relaxed); });
+    return hits;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file evaluation.cpp
+ * @brief evaluation services implementation.
+ *
+ * Evaluation with the algorithm selected in AlgorithmSelection.
+ *
+ */
+
+#include "evaluation.hpp"
+
+/**
+ * @brief evaluate_position
+ *
+ * Evaluate chess position with the evaluation algorithm selected in AlgorithmSelection.
+ *
+ * @note the search does not use this dispatch, it calls evaluate_position<EvaluationAlgorithm> directly.
+ *
+ * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
+ *
+ * @returns
+ *  - (0) if position is evaluated as equal.
+ *  - (+) if position is evaluated as white is better.
+ *  - (-) if position is evaluated as black is better.
+ */
+int evaluate_position(Board& board, int alpha, int beta)
+{
+    switch (AlgorithmSelection::evaluation()) {
+    case EvaluationAlgorithm::DYNAMIC: return evaluate_position<EvaluationAlgorithm::DYNAMIC>(board, alpha, beta);
+    case EvaluationAlgorithm::SAFETY_MOBILITY:
+        return evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(board, alpha, beta);
+    case EvaluationAlgorithm::NNUE: return evaluate_position<EvaluationAlgorithm::NNUE>(board, alpha, beta);
+    }
+
+    assert(false);
+    return 0;
+}
@@ -7,59 +7,60 @@
  * https://www.chessprogramming.org/Evaluation
  * https://www.chessprogramming.org/Simplified_Evaluation_Function
  * https://www.chessprogramming.org/Tapered_Eval
+ * https://www.chessprogramming.org/Pawn_Structure
+ * https://www.chessprogramming.org/Material_Hash_Table
  * 
  */
 #include "evaluation.hpp"
 #include "move_list.hpp"
 #include "move_generator.hpp"
 #include "precomputed_eval_data.hpp"
+#include "pawn_structure.hpp"
+#include "material.hpp"
 #include "precomputed_move_data.hpp"
 #include "bit_utilities.hpp"
 
 static constexpr inline int calculate_middlegame_percentage(const Board& board);
 
 /** 
- * @brief evaluate_position
+ * @brief evaluate_position_dynamic
  *
  * Evaluate chess position.
  *  
- * @note None.
+ * @note All the terms of this evaluation are incremental or cached, the window is not used.
  * 
  * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
  *
  * @returns
  *  - (0) if position is evaluated as equal.
  *  - (+) if position is evaluated as white is better.
  *  - (-) if position is evaluated as black is better.
  */
-int evaluate_position(Board& board)
+int evaluate_position_dynamic(Board& board, [[maybe_unused]] int alpha, [[maybe_unused]] int beta)
 {
-    board.update_attacks_bb();
+    // imbalance and known endgames are cached in the material table
+    const MaterialEntry& material_entry = MaterialTable::thread_table().probe(board);
 
-    int middlegame_eval = 0;
-    int endgame_eval = 0;
-
-    const int middlegame_percentage = calculate_middlegame_percentage(board);
-    const int endgame_percentage = 24 - calculate_middlegame_percentage(board);
+    if (material_entry.evaluation != nullptr) {
+        return material_entry.evaluation(board);
+    }
 
-    uint64_t pieces = board.get_bitboard_all();
+    // material and PST scores are updated incrementally in the board
+    int32_t score = board.get_pst_score() + material_entry.imbalance;
 
-    while (pieces) {
+    // pawn structure is cached in the pawn hash table
+    PawnEntry& pawn_entry = PawnHashTable::thread_table().probe(board);
+    score += pawn_entry.score + king_shelter(pawn_entry, board) + rooks_on_open_files(pawn_entry, board);
 
-        const Square square(pop_lsb(pieces));
-        const Piece piece = board.get_piece(square);
-        const ChessColor color = get_color(piece);
-        const int piece_raw_value = raw_value(piece);
-        const int bonus_middlegame = PrecomputedEvalData::get_piece_square_table<PST_TYPE_MIDDLEGAME>(piece, square);
-        const int bonus_endgame = PrecomputedEvalData::get_piece_square_table<PST_TYPE_ENDGAME>(piece, square);
+    const int middlegame_eval = middlegame_score(score);
+    const int endgame_eval = scale_endgame(endgame_score(score), material_entry, board);
 
-        const int piece_value_middlegame = piece_raw_value + bonus_middlegame;
-        const int piece_value_endgame = piece_raw_value + bonus_endgame;
+    const int middlegame_percentage = calculate_middlegame_percentage(board);
+    const int endgame_percentage = MAX_GAME_PHASE - middlegame_percentage;
 
-        middlegame_eval += is_white(color) ? piece_value_middlegame : -piece_value_middlegame;
-        endgame_eval += is_white(color) ? piece_value_endgame : -piece_value_endgame;
-    }
-    const int blended_eval = (middlegame_eval * middlegame_percentage + endgame_eval * endgame_percentage) / 24;
+    const int blended_eval = (middlegame_eval * middlegame_percentage + endgame_eval * endgame_percentage) / MAX_GAME_PHASE;
 
     return blended_eval;
 }
@@ -78,14 +79,5 @@ int evaluate_position(Board& board)
  */
 static constexpr inline int calculate_middlegame_percentage(const Board& board)
 {
-    const int queens = board.get_piece_counter(Piece::W_QUEEN) + board.get_piece_counter(Piece::B_QUEEN);
-
-    const int rooks = board.get_piece_counter(Piece::W_ROOK) + board.get_piece_counter(Piece::B_ROOK);
-
-    const int minor_pieces = board.get_piece_counter(Piece::W_KNIGHT) + board.get_piece_counter(Piece::B_KNIGHT) +
-        board.get_piece_counter(Piece::W_BISHOP) + board.get_piece_counter(Piece::B_BISHOP);
-
-    const int game_phase = minor_pieces + 2 * rooks + 4 * queens;
-
-    return std::min(game_phase, 24);   // max gamephase is 24
+    return std::min(board.get_game_phase(), MAX_GAME_PHASE);   // max gamephase is 24
 }
\ No newline at end of file
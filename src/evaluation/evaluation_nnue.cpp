@@ -0,0 +1,72 @@
+/**
+ * @file evaluation_nnue.cpp
+ * @brief evaluation services implementation.
+ *
+ * chess position neural network evaluation implementation.
+ *
+ * https://www.chessprogramming.org/Evaluation
+ * https://www.chessprogramming.org/NNUE
+ * https://www.chessprogramming.org/Material_Hash_Table
+ *
+ */
+#include "evaluation.hpp"
+#include "material.hpp"
+#include "nnue.hpp"
+#include "precomputed_eval_data.hpp"
+
+static constexpr inline int calculate_middlegame_percentage(const Board& board);
+
+/**
+ * @brief evaluate_position_nnue
+ *
+ * Evaluate chess position.
+ *
+ * @note The network is loaded with the EvalFile option, without network the position is evaluated
+ * with the material and PST scores. The window is not used.
+ *
+ * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
+ *
+ * @returns
+ *  - (0) if position is evaluated as equal.
+ *  - (+) if position is evaluated as white is better.
+ *  - (-) if position is evaluated as black is better.
+ */
+int evaluate_position_nnue(Board& board, [[maybe_unused]] int alpha, [[maybe_unused]] int beta)
+{
+    // known endgames are cached in the material table
+    const MaterialEntry& material_entry = MaterialTable::thread_table().probe(board);
+
+    if (material_entry.evaluation != nullptr) {
+        return material_entry.evaluation(board);
+    }
+
+    if (Nnue::is_loaded()) {
+        return Nnue::evaluate(board);
+    }
+
+    // material and PST scores are updated incrementally in the board
+    const int32_t score = board.get_pst_score() + material_entry.imbalance;
+
+    const int middlegame_eval = middlegame_score(score);
+    const int endgame_eval = scale_endgame(endgame_score(score), material_entry, board);
+
+    const int middlegame_percentage = calculate_middlegame_percentage(board);
+    const int endgame_percentage = MAX_GAME_PHASE - middlegame_percentage;
+
+    return (middlegame_eval * middlegame_percentage + endgame_eval * endgame_percentage) / MAX_GAME_PHASE;
+}
+
+/**
+ * @brief Calculate the middlegame percentage (0 = endgame, 24 = middlegame)
+ *
+ * @param[in] board Chess position
+ * @returns int
+ *  - (24) for full middlegame (8 minor pieces, 4 rooks and 2 queens)
+ *  - (0) for full endgame
+ */
+static constexpr inline int calculate_middlegame_percentage(const Board& board)
+{
+    return std::min(board.get_game_phase(), MAX_GAME_PHASE);   // max gamephase is 24
+}
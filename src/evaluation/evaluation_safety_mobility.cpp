@@ -7,66 +7,156 @@
  * https://www.chessprogramming.org/Evaluation
  * https://www.chessprogramming.org/Simplified_Evaluation_Function
  * https://www.chessprogramming.org/Tapered_Eval
+ * https://www.chessprogramming.org/Pawn_Structure
+ * https://www.chessprogramming.org/Evaluation_Hash_Table
+ * https://www.chessprogramming.org/Material_Hash_Table
  * 
  */
 #include "evaluation.hpp"
 #include "move_list.hpp"
 #include "move_generator.hpp"
 #include "precomputed_eval_data.hpp"
+#include "pawn_structure.hpp"
+#include "material.hpp"
+#include "eval_cache.hpp"
 #include "precomputed_move_data.hpp"
 #include "bit_utilities.hpp"
 
+/** 
+ * @brief difference between the max and min value of a group of EVAL_WEIGHTS
+ * 
+ * @param[in] first_weight index of the first weight of the group, see EvalWeight.
+ * @param[in] num_weights number of weights of the group.
+ * 
+ * @returns (int) max weight - min weight
+ */
+static constexpr int weights_range(int first_weight, int num_weights)
+{
+    int min_weight = EVAL_WEIGHTS[first_weight];
+    int max_weight = EVAL_WEIGHTS[first_weight];
+
+    for (int i = first_weight + 1; i < first_weight + num_weights; i++) {
+        min_weight = std::min(min_weight, EVAL_WEIGHTS[i]);
+        max_weight = std::max(max_weight, EVAL_WEIGHTS[i]);
+    }
+
+    return max_weight - min_weight;
+}
+
+// max change of the king safety and king shield terms, +2 for the rounding of the game phase and endgame scale,
+// the mobility terms are bounded in each position by max_mobility
+static constexpr int LAZY_MARGIN = weights_range(SAFETY_WEIGHTS, 100) + weights_range(KING_SHIELD_WEIGHTS, 4) + 2;
+
 static constexpr inline int calculate_middlegame_percentage(const Board& board);
 static inline int mobility_piece_score(Square square, Piece piece, const Board& board);
 template<ChessColor color>
 static int king_shield(Square king_sq, const Board& board);
 template<ChessColor color>
+static int king_shield_pawns(Square king_sq, const Board& board);
+template<ChessColor color>
 static int king_safety_penalization(Square king_sq, const Board& board);
+template<ChessColor color>
+static int king_safety_attacks(Square king_sq, const Board& board);
+template<ChessColor color>
+static inline int max_mobility(const Board& board);
 
 /** 
- * @brief evaluate_position
+ * @brief evaluate_position_safety_mobility
  *
  * Evaluate chess position.
  *  
- * @note None.
+ * @note The mobility and king safety terms are skipped when the rest of the evaluation is outside the
+ * (alpha, beta) window by more than the max value of these terms, the result is then only a bound and
+ * it is not cached: a lower bound >= beta or an upper bound <= alpha of the full evaluation.
  * 
  * @param[in] board board to evaluate.
+ * @param[in] alpha lower bound of the search window, from the white point of view.
+ * @param[in] beta upper bound of the search window, from the white point of view.
+ * @param[out] lazyExit (optional) return true if the evaluation exited lazily and the result is only a bound.
  *
  * @returns
  *  - (0) if position is evaluated as equal.
  *  - (+) if position is evaluated as white is better.
  *  - (-) if position is evaluated as black is better.
  */
-int evaluate_position(Board& board)
+int evaluate_position_safety_mobility(Board& board, int alpha, int beta, bool* lazyExit)
 {
-    board.update_attacks_bb();
+    if (lazyExit) {
+        *lazyExit = false;
+    }
+
+    // the same positions are evaluated again in the search, reuse the previous evaluation
+    EvalCache& eval_cache = EvalCache::thread_cache();
+    const uint64_t zobrist_key = board.state().get_zobrist_key();
+
+#ifdef EVAL_TUNING
+    // the tuner needs the trace of every evaluation
+    EvalTrace::current().complete = false;
+#else
+    int cached_eval;
+    if (eval_cache.probe(zobrist_key, cached_eval)) {
+        return cached_eval;
+    }
+#endif
 
-    int middlegame_eval = 0;
-    int endgame_eval = 0;
+    // imbalance and known endgames are cached in the material table
+    const MaterialEntry& material_entry = MaterialTable::thread_table().probe(board);
+
+    if (material_entry.evaluation != nullptr) {
+        const int endgame_evaluation = material_entry.evaluation(board);
+        eval_cache.store(zobrist_key, endgame_evaluation);
+        return endgame_evaluation;
+    }
+
+    // material and PST scores are updated incrementally in the board
+    int32_t score = board.get_pst_score() + material_entry.imbalance;
+
+    // pawn structure is cached in the pawn hash table, the king safety terms of this evaluation replace the shelter
+    const PawnEntry& pawn_entry = PawnHashTable::thread_table().probe(board);
+    score += pawn_entry.score + rooks_on_open_files(pawn_entry, board);
+
+    int middlegame_eval = middlegame_score(score);
+    int endgame_eval = endgame_score(score);
 
     const int middlegame_percentage = calculate_middlegame_percentage(board);
-    const int endgame_percentage = 24 - calculate_middlegame_percentage(board);
+    const int endgame_percentage = MAX_GAME_PHASE - middlegame_percentage;
+
+    // lazy exit, the mobility and king safety terms can not bring the evaluation back into the window
+    const int lazy_eval =
+        (middlegame_eval * middlegame_percentage +
+         scale_endgame(endgame_eval, material_entry, board) * endgame_percentage) /
+        MAX_GAME_PHASE;
+
+    // the evaluation without these terms is not a bound, the bounds are the evaluation with their max values
+    const int lower_bound = lazy_eval - LAZY_MARGIN - max_mobility<ChessColor::BLACK>(board);
+    const int upper_bound = lazy_eval + LAZY_MARGIN + max_mobility<ChessColor::WHITE>(board);
+
+    if (lower_bound >= beta || upper_bound <= alpha) {
+        LazyEvaluation::count_exit();
+        if (lazyExit) {
+            *lazyExit = true;
+        }
+        return lower_bound >= beta ? lower_bound : upper_bound;
+    }
+
+    board.update_attacks_bb();
 
     const Square white_king_sq = lsb(board.get_bitboard_piece(Piece::W_KING));
     const Square black_king_sq = lsb(board.get_bitboard_piece(Piece::B_KING));
 
-    uint64_t pieces = board.get_bitboard_all();
+    // only knights, bishops, rooks and queens have mobility score
+    const uint64_t pawns_and_kings = board.get_bitboard_piece(Piece::W_PAWN) | board.get_bitboard_piece(Piece::B_PAWN) |
+        board.get_bitboard_piece(Piece::W_KING) | board.get_bitboard_piece(Piece::B_KING);
+    uint64_t pieces = board.get_bitboard_all() & ~pawns_and_kings;
 
     while (pieces) {
 
         const Square square(pop_lsb(pieces));
         const Piece piece = board.get_piece(square);
-        const ChessColor color = get_color(piece);
-        const int piece_raw_value = raw_value(piece);
-        const int bonus_middlegame = PrecomputedEvalData::get_piece_square_table<PST_TYPE_MIDDLEGAME>(piece, square);
-        const int bonus_endgame = PrecomputedEvalData::get_piece_square_table<PST_TYPE_ENDGAME>(piece, square);
         const int mobility = mobility_piece_score(square, piece, board);
 
-        const int piece_value_middlegame = piece_raw_value + bonus_middlegame + mobility;
-        const int piece_value_endgame = piece_raw_value + bonus_endgame + mobility;
-
-        middlegame_eval += is_white(color) ? piece_value_middlegame : -piece_value_middlegame;
-        endgame_eval += is_white(color) ? piece_value_endgame : -piece_value_endgame;
+        middlegame_eval += is_white(get_color(piece)) ? mobility : -mobility;
+        endgame_eval += is_white(get_color(piece)) ? mobility : -mobility;
     }
 
     const int king_safety_penality_white = king_safety_penalization<ChessColor::WHITE>(white_king_sq, board);
@@ -79,7 +169,22 @@ int evaluate_position(Board& board)
 
     middlegame_eval += king_shield_bonus + king_safety_penality;
 
-    const int blended_eval = (middlegame_eval * middlegame_percentage + endgame_eval * endgame_percentage) / 24;
+#ifdef EVAL_TUNING
+    EvalTrace& trace = EvalTrace::current();
+    trace.complete = true;
+    trace.kingSafety[0] = king_safety_attacks<ChessColor::WHITE>(white_king_sq, board);
+    trace.kingSafety[1] = king_safety_attacks<ChessColor::BLACK>(black_king_sq, board);
+    trace.kingShield[0] = king_shield_pawns<ChessColor::WHITE>(white_king_sq, board);
+    trace.kingShield[1] = king_shield_pawns<ChessColor::BLACK>(black_king_sq, board);
+    trace.endgameScale =
+        material_entry.scale_factor(board, endgame_eval > 0 ? ChessColor::WHITE : ChessColor::BLACK);
+#endif
+
+    endgame_eval = scale_endgame(endgame_eval, material_entry, board);
+
+    const int blended_eval = (middlegame_eval * middlegame_percentage + endgame_eval * endgame_percentage) / MAX_GAME_PHASE;
+
+    eval_cache.store(zobrist_key, blended_eval);
 
     return blended_eval;
 }
@@ -101,10 +206,44 @@ static inline int mobility_piece_score(Square square, Piece piece, const Board&
     return number_of_1_bits(moves & ~(friendly_pieces | enemy_pawn_attacks));
 }
 
+/** 
+ * @brief upper bound of the mobility score of one side
+ *
+ * @note max squares reached by each piece in an empty board: knight 8, bishop 13, rook 14, queen 27.
+ * 
+ * @tparam color side to evaluate
+ * @param[in] board chess position
+ * 
+ * @returns (int) max mobility score of the pieces of the side
+ */
+template<ChessColor color>
+static inline int max_mobility(const Board& board)
+{
+    return 8 * number_of_1_bits(board.get_bitboard_piece(create_piece(PieceType::KNIGHT, color))) +
+        13 * number_of_1_bits(board.get_bitboard_piece(create_piece(PieceType::BISHOP, color))) +
+        14 * number_of_1_bits(board.get_bitboard_piece(create_piece(PieceType::ROOK, color))) +
+        27 * number_of_1_bits(board.get_bitboard_piece(create_piece(PieceType::QUEEN, color)));
+}
+
 /** 
  * @brief calculates the king shield bonus
  *
- * @note bonus between (0-100)
+ * @note bonus KING_SHIELD_WEIGHTS[number of shield pawns]
+ * 
+ * @tparam color side to evaluate
+ * @param[in] king_sq king square in the position
+ * @param[in] board chess position
+ * 
+ * @returns (int) king shield bonus
+ */
+template<ChessColor color>
+static int king_shield(Square king_sq, const Board& board)
+{
+    return PrecomputedEvalData::get_king_shield_bonus(king_shield_pawns<color>(king_sq, board));
+}
+
+/** 
+ * @brief counts the shield pawns of the king
  * 
  * the shield pawns are the pawns in the three squares in front of the king
  * 
@@ -112,19 +251,13 @@ static inline int mobility_piece_score(Square square, Piece piece, const Board&
  * @param[in] king_sq king square in the position
  * @param[in] board chess position
  * 
- * @returns (int)
- *  - (0) if no shield pawns
- *  - (33) if 1 shield pawn
- *  - (66) if 2 shield pawns
- *  - (100) if 3 shield pawns
+ * @returns (0-3) number of shield pawns
  */
 template<ChessColor color>
-static int king_shield(Square king_sq, const Board& board)
+static int king_shield_pawns(Square king_sq, const Board& board)
 {
     assert(king_sq == Square(lsb(board.get_bitboard_piece(is_white(color) ? Piece::W_KING : Piece::B_KING))));
 
-    static constexpr int shield_bonus[4] {0, 33, 66, 100};
-
     const uint64_t friendly_pawns = board.get_bitboard_piece(create_piece(PieceType::PAWN, color));
 
     const Row next_row = Row(is_white(color) ? king_sq.row() + 1 : king_sq.row() - 1);
@@ -134,11 +267,26 @@ static int king_shield(Square king_sq, const Board& board)
     const int number_of_shield_pawns = number_of_1_bits(king_shield_zone & friendly_pawns);
     assert(number_of_shield_pawns >= 0 && number_of_shield_pawns <= 3);
 
-    return shield_bonus[number_of_shield_pawns];
+    return number_of_shield_pawns;
 }
 
 template<ChessColor color>
 static int king_safety_penalization(Square king_sq, const Board& board)
+{
+    return PrecomputedEvalData::get_safety_table(king_safety_attacks<color>(king_sq, board));
+}
+
+/** 
+ * @brief counts the attacks to the king danger zone, weighted by the attacking piece
+ * 
+ * @tparam color side to evaluate
+ * @param[in] king_sq king square in the position
+ * @param[in] board chess position
+ * 
+ * @returns (0-99) index of the SAFETY_WEIGHTS penalization
+ */
+template<ChessColor color>
+static int king_safety_attacks(Square king_sq, const Board& board)
 {
     // ATTACK_VALUE : PAWN(1), KNIGHT(2), BISHOP(2), ROOK(3), QUEEN(4), KING(1)
     assert(king_sq == Square(lsb(board.get_bitboard_piece(is_white(color) ? Piece::W_KING : Piece::B_KING))));
@@ -163,7 +311,8 @@ static int king_safety_penalization(Square king_sq, const Board& board)
     // extra 3 point penalty for each square attacked by queen
     penalty += 3 * number_of_1_bits(zone & (board.get_attacks_bb(attack_queen)));
 
-    return PrecomputedEvalData::get_safety_table(penalty);
+    // the penalization is saturated long before the end of the table
+    return std::min(penalty, 99);
 }
 
 /**
@@ -180,14 +329,5 @@ static int king_safety_penalization(Square king_sq, const Board& board)
  */
 static constexpr inline int calculate_middlegame_percentage(const Board& board)
 {
-    const int queens = board.get_piece_counter(Piece::W_QUEEN) + board.get_piece_counter(Piece::B_QUEEN);
-
-    const int rooks = board.get_piece_counter(Piece::W_ROOK) + board.get_piece_counter(Piece::B_ROOK);
-
-    const int minor_pieces = board.get_piece_counter(Piece::W_KNIGHT) + board.get_piece_counter(Piece::B_KNIGHT) +
-        board.get_piece_counter(Piece::W_BISHOP) + board.get_piece_counter(Piece::B_BISHOP);
-
-    const int game_phase = minor_pieces + 2 * rooks + 4 * queens;
-
-    return std::min(game_phase, 24);   // max gamephase is 24
+    return std::min(board.get_game_phase(), MAX_GAME_PHASE);   // max gamephase is 24
 }
\ No newline at end of file
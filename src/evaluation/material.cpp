@@ -0,0 +1,223 @@
+/**
+ * @file material.cpp
+ * @brief material evaluation implementation.
+ *
+ * Material terms cached in a material table indexed by the material zobrist key.
+ *
+ * https://www.chessprogramming.org/Material_Hash_Table
+ * https://www.chessprogramming.org/Material
+ * https://www.chessprogramming.org/Draw_Evaluation
+ *
+ */
+
+#include "material.hpp"
+#include "precomputed_eval_data.hpp"
+#include "table_pool.hpp"
+
+// squares of the same color as A1
+static constexpr uint64_t DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+// imbalance scores
+static constexpr int32_t BISHOP_PAIR = make_score(30, 50);
+static constexpr int32_t KNIGHT_PER_PAWN = make_score(6, 6);     // knights are better with more pawns
+static constexpr int32_t ROOK_PER_PAWN = make_score(-12, -12);   // rooks are better in open positions
+
+/**
+ * @brief MaterialCount
+ *
+ * Number of pieces of each type of one side.
+ *
+ */
+struct MaterialCount
+{
+    int pawns;
+    int knights;
+    int bishops;
+    int rooks;
+    int queens;
+
+    /**
+     * @brief value of the pieces that are not pawns
+     */
+    int non_pawn_material;
+};
+
+static MaterialCount count_material(const Board& board, ChessColor color);
+static int32_t imbalance(const MaterialCount& material);
+static void select_endgame(const MaterialCount& strong, const MaterialCount& weak, ChessColor strong_color,
+                           MaterialEntry& entry);
+
+/**
+ * @brief is_draw(const Board&)
+ *
+ * @param[in] board chess position with this material.
+ *
+ * @return true if no side can checkmate.
+ *
+ */
+bool MaterialEntry::is_draw(const Board& board) const
+{
+    if (insufficientMaterial) {
+        return true;
+    }
+    if (onlyBishops) {
+        const uint64_t bishops = board.get_bitboard_piece(Piece::W_BISHOP) | board.get_bitboard_piece(Piece::B_BISHOP);
+        return (bishops & DARK_SQUARES) == 0ULL || (bishops & ~DARK_SQUARES) == 0ULL;
+    }
+    return false;
+}
+
+/**
+ * @brief MaterialTable
+ *
+ * Allocates the entries.
+ *
+ */
+MaterialTable::MaterialTable() : entries(NUM_ENTRIES) {}
+
+/**
+ * @brief thread_table()
+ *
+ * @return (MaterialTable&) material table of the calling thread.
+ *
+ */
+MaterialTable& MaterialTable::thread_table() { return TablePool<MaterialTable>::thread_table(); }
+
+/**
+ * @brief calculate_entry(const Board&, MaterialEntry&)
+ *
+ * Calculate the imbalance, the known endgames and the draws of the material of the position.
+ *
+ * @param[in] board chess position.
+ * @param[out] entry material entry of the position.
+ *
+ */
+void MaterialTable::calculate_entry(const Board& board, MaterialEntry& entry)
+{
+    entry = MaterialEntry();
+    entry.key = board.state().get_material_key();
+
+    const MaterialCount white = count_material(board, ChessColor::WHITE);
+    const MaterialCount black = count_material(board, ChessColor::BLACK);
+
+    entry.imbalance = imbalance(white) - imbalance(black);
+
+    const bool no_pawns = white.pawns == 0 && black.pawns == 0;
+    const bool no_major_pieces = white.rooks + white.queens + black.rooks + black.queens == 0;
+
+    // dead positions, no side can checkmate
+    const int knights = white.knights + black.knights;
+    const int bishops = white.bishops + black.bishops;
+
+    entry.insufficientMaterial = no_pawns && no_major_pieces && bishops == 0 && knights <= 1;
+    entry.onlyBishops = no_pawns && no_major_pieces && bishops > 0 && knights == 0;
+
+    if (entry.insufficientMaterial || entry.onlyBishops) {
+        return;
+    }
+
+    select_endgame(white, black, ChessColor::WHITE, entry);
+    select_endgame(black, white, ChessColor::BLACK, entry);
+
+    // one bishop each side and pawns, the bishops may be of opposite colors
+    if (no_major_pieces && knights == 0 && white.bishops == 1 && black.bishops == 1) {
+        entry.scaleFunction = scale_opposite_bishops;
+    }
+}
+
+/**
+ * @brief count_material(const Board&, ChessColor)
+ *
+ * @param[in] board chess position.
+ * @param[in] color side to count.
+ *
+ * @return (MaterialCount) number of pieces of each type of the side.
+ *
+ */
+static MaterialCount count_material(const Board& board, ChessColor color)
+{
+    MaterialCount material;
+
+    material.pawns = board.get_piece_counter(create_piece(PieceType::PAWN, color));
+    material.knights = board.get_piece_counter(create_piece(PieceType::KNIGHT, color));
+    material.bishops = board.get_piece_counter(create_piece(PieceType::BISHOP, color));
+    material.rooks = board.get_piece_counter(create_piece(PieceType::ROOK, color));
+    material.queens = board.get_piece_counter(create_piece(PieceType::QUEEN, color));
+
+    material.non_pawn_material = material.knights * raw_value(PieceType::KNIGHT) +
+        material.bishops * raw_value(PieceType::BISHOP) + material.rooks * raw_value(PieceType::ROOK) +
+        material.queens * raw_value(PieceType::QUEEN);
+
+    return material;
+}
+
+/**
+ * @brief imbalance(const MaterialCount&)
+ *
+ * Bishop pair bonus and knight and rook values adjusted by the number of own pawns.
+ *
+ * @param[in] material pieces of one side.
+ *
+ * @return (int32_t) packed score (make_score) of the side.
+ *
+ */
+static int32_t imbalance(const MaterialCount& material)
+{
+    int32_t score = 0;
+
+    if (material.bishops >= 2) {
+        score += BISHOP_PAIR;
+    }
+    score += material.knights * (material.pawns - 5) * KNIGHT_PER_PAWN;
+    score += material.rooks * (material.pawns - 5) * ROOK_PER_PAWN;
+
+    return score;
+}
+
+/**
+ * @brief select_endgame(const MaterialCount&, const MaterialCount&, ChessColor, MaterialEntry&)
+ *
+ * Known endgames where the strong side plays against a lone king, and the scale factor of the strong side
+ * when it has no pawns and not enough material advantage to win.
+ *
+ * @param[in] strong pieces of the side that may be winning.
+ * @param[in] weak pieces of the other side.
+ * @param[in] strong_color color of the strong side.
+ * @param[out] entry material entry of the position.
+ *
+ */
+static void select_endgame(const MaterialCount& strong, const MaterialCount& weak, ChessColor strong_color,
+                           MaterialEntry& entry)
+{
+    const bool white = is_white(strong_color);
+    const bool lone_king = weak.pawns == 0 && weak.non_pawn_material == 0;
+    const bool only_two_knights =
+        strong.pawns == 0 && strong.knights == 2 && strong.bishops + strong.rooks + strong.queens == 0;
+
+    if (lone_king && strong.pawns == 0 && strong.knights == 1 && strong.bishops == 1 &&
+        strong.rooks + strong.queens == 0) {
+        entry.evaluation = white ? evaluate_KBNK<ChessColor::WHITE> : evaluate_KBNK<ChessColor::BLACK>;
+        return;
+    }
+    if (lone_king && strong.non_pawn_material >= static_cast<int>(raw_value(PieceType::ROOK)) && !only_two_knights) {
+        entry.evaluation = white ? evaluate_KXK<ChessColor::WHITE> : evaluate_KXK<ChessColor::BLACK>;
+        return;
+    }
+    if (lone_king && strong.pawns == 1 && strong.non_pawn_material == 0) {
+        entry.evaluation = white ? evaluate_KPK<ChessColor::WHITE> : evaluate_KPK<ChessColor::BLACK>;
+        return;
+    }
+
+    // without pawns a minor piece of advantage is not enough to win
+    const int bishop_value = static_cast<int>(raw_value(PieceType::BISHOP));
+
+    if (strong.pawns == 0 && strong.non_pawn_material - weak.non_pawn_material <= bishop_value) {
+        const int scale = strong.non_pawn_material < static_cast<int>(raw_value(PieceType::ROOK)) ? SCALE_FACTOR_DRAW
+            : weak.non_pawn_material <= bishop_value                                            ? 4
+                                                                                                 : 14;
+        entry.scaleFactor[static_cast<int>(strong_color)] = static_cast<uint8_t>(scale);
+    }
+    else if (only_two_knights) {
+        entry.scaleFactor[static_cast<int>(strong_color)] = SCALE_FACTOR_DRAW;   // KNNK can not force the mate
+    }
+}
@@ -0,0 +1,516 @@
+/**
+ * @file nnue.cpp
+ * @brief efficiently updatable neural network implementation.
+ *
+ * HalfKP feature transformer with two quantized hidden layers, evaluated with AVX2, SSSE3 or scalar kernels.
+ *
+ * https://www.chessprogramming.org/NNUE
+ * https://github.com/official-stockfish/nnue-pytorch/blob/master/docs/nnue.md
+ *
+ */
+
+#include "nnue.hpp"
+#include "bit_utilities.hpp"
+#include "table_pool.hpp"
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+static constexpr uint32_t L1 = NnueNetwork::L1;
+static constexpr uint32_t L2 = NnueNetwork::L2;
+static constexpr uint32_t L3 = NnueNetwork::L3;
+
+// pieces of the HalfKP features, the kings are the buckets of the features
+static constexpr Piece NON_KING_PIECES[10] = {Piece::W_PAWN, Piece::W_KNIGHT, Piece::W_BISHOP, Piece::W_ROOK,
+                                              Piece::W_QUEEN, Piece::B_PAWN, Piece::B_KNIGHT, Piece::B_BISHOP,
+                                              Piece::B_ROOK, Piece::B_QUEEN};
+
+/**
+ * @brief NnueAccumulatorCache
+ *
+ * Accumulators of one search thread, one for each perspective and king square.
+ *
+ * Each accumulator keeps the bitboards of the pieces it was computed for, the next position with the same king
+ * square only adds and removes the features of the pieces that are different.
+ *
+ * The caches are kept in a TablePool, so the short lived threads of the search reuse the caches.
+ *
+ */
+class NnueAccumulatorCache
+{
+public:
+    struct Entry
+    {
+        alignas(64) int16_t accumulation[L1];
+        uint64_t pieces[10];   // bitboards of NON_KING_PIECES
+    };
+
+    NnueAccumulatorCache() : entries(2U * 64U) {}
+
+    NnueAccumulatorCache(const NnueAccumulatorCache&) = delete;
+    NnueAccumulatorCache& operator=(const NnueAccumulatorCache&) = delete;
+
+    /**
+     * @brief entry(ChessColor, Square, const NnueNetwork&)
+     *
+     * @param[in] perspective side of the accumulator.
+     * @param[in] king_square king square of the perspective side.
+     * @param[in] network loaded network, the cache is reset when the network changes.
+     *
+     * @return (Entry&) accumulator of the perspective and king square.
+     *
+     */
+    inline Entry& entry(ChessColor perspective, Square king_square, const NnueNetwork& network)
+    {
+        if (generation != Nnue::generation()) {
+            generation = Nnue::generation();
+            for (Entry& empty_entry : entries) {
+                reset(empty_entry, network);
+            }
+        }
+        return entries[static_cast<uint32_t>(perspective) * 64U + king_square.value()];
+    }
+
+    /**
+     * @brief reset(Entry&, const NnueNetwork&)
+     *
+     * Accumulator of an empty board.
+     *
+     * @param[out] empty_entry entry to reset.
+     * @param[in] network loaded network.
+     *
+     */
+    static inline void reset(Entry& empty_entry, const NnueNetwork& network)
+    {
+        std::copy(network.featureBiases, network.featureBiases + L1, empty_entry.accumulation);
+        std::fill(empty_entry.pieces, empty_entry.pieces + 10, 0ULL);
+    }
+
+private:
+    std::vector<Entry> entries;
+    uint32_t generation = 0U;
+};
+
+static void update_accumulator(NnueAccumulatorCache::Entry& entry, const Board& board, ChessColor perspective,
+                               Square king_square, const NnueNetwork& network);
+static int propagate(const int16_t* side_to_move, const int16_t* other_side, const NnueNetwork& network);
+static inline void add_feature(int16_t* accumulation, const int16_t* weights);
+static inline void remove_feature(int16_t* accumulation, const int16_t* weights);
+static inline void clipped_relu(const int16_t* accumulation, uint8_t* output);
+static inline void affine(const uint8_t* input, uint32_t input_size, const int8_t* weights, const int32_t* biases,
+                          uint32_t output_size, int32_t* output);
+static inline void clipped_relu_shift(const int32_t* input, uint32_t size, uint8_t* output);
+
+/**
+ * @brief read(std::istream&)
+ *
+ * @param[in] stream binary stream of a network file.
+ *
+ * @return true if the stream has a network with the dimensions of this build.
+ *
+ */
+bool NnueNetwork::read(std::istream& stream)
+{
+    char magic[sizeof(MAGIC)];
+    uint32_t dimensions[4];
+
+    stream.read(magic, sizeof(magic));
+    stream.read(reinterpret_cast<char*>(dimensions), sizeof(dimensions));
+
+    if (!stream || !std::equal(magic, magic + sizeof(MAGIC), MAGIC) || dimensions[0] != INPUT_DIMENSIONS ||
+        dimensions[1] != L1 || dimensions[2] != L2 || dimensions[3] != L3) {
+        return false;
+    }
+
+    stream.read(reinterpret_cast<char*>(featureBiases), sizeof(featureBiases));
+    stream.read(reinterpret_cast<char*>(featureWeights), sizeof(featureWeights));
+    stream.read(reinterpret_cast<char*>(hidden1Biases), sizeof(hidden1Biases));
+    stream.read(reinterpret_cast<char*>(hidden1Weights), sizeof(hidden1Weights));
+    stream.read(reinterpret_cast<char*>(hidden2Biases), sizeof(hidden2Biases));
+    stream.read(reinterpret_cast<char*>(hidden2Weights), sizeof(hidden2Weights));
+    stream.read(reinterpret_cast<char*>(&outputBias), sizeof(outputBias));
+    stream.read(reinterpret_cast<char*>(outputWeights), sizeof(outputWeights));
+
+    return static_cast<bool>(stream);
+}
+
+/**
+ * @brief write(std::ostream&)
+ *
+ * @param[out] stream binary stream of the network file.
+ *
+ * @return true if the network has been written.
+ *
+ */
+bool NnueNetwork::write(std::ostream& stream) const
+{
+    const uint32_t dimensions[4] = {INPUT_DIMENSIONS, L1, L2, L3};
+
+    stream.write(MAGIC, sizeof(MAGIC));
+    stream.write(reinterpret_cast<const char*>(dimensions), sizeof(dimensions));
+    stream.write(reinterpret_cast<const char*>(featureBiases), sizeof(featureBiases));
+    stream.write(reinterpret_cast<const char*>(featureWeights), sizeof(featureWeights));
+    stream.write(reinterpret_cast<const char*>(hidden1Biases), sizeof(hidden1Biases));
+    stream.write(reinterpret_cast<const char*>(hidden1Weights), sizeof(hidden1Weights));
+    stream.write(reinterpret_cast<const char*>(hidden2Biases), sizeof(hidden2Biases));
+    stream.write(reinterpret_cast<const char*>(hidden2Weights), sizeof(hidden2Weights));
+    stream.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    stream.write(reinterpret_cast<const char*>(outputWeights), sizeof(outputWeights));
+
+    return static_cast<bool>(stream);
+}
+
+/**
+ * @brief load(const std::string&)
+ *
+ * Load a network file, the previous network is kept if the file is invalid.
+ *
+ * @note must not be called while a search is running.
+ *
+ * @param[in] path path of the network file.
+ *
+ * @return true if the network has been loaded.
+ *
+ */
+bool Nnue::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::unique_ptr<NnueNetwork> new_network = std::make_unique<NnueNetwork>();
+
+    if (!file || !new_network->read(file)) {
+        return false;
+    }
+
+    set_network(std::move(new_network));
+    networkFile = path;
+    return true;
+}
+
+/**
+ * @brief set_network(std::unique_ptr<NnueNetwork>)
+ *
+ * Use a network already in memory.
+ *
+ * @note must not be called while a search is running.
+ *
+ * @param[in] new_network network to evaluate with.
+ *
+ */
+void Nnue::set_network(std::unique_ptr<NnueNetwork> new_network)
+{
+    network = std::move(new_network);
+    networkFile.clear();
+    networkGeneration.fetch_add(1U, std::memory_order_relaxed);
+}
+
+/**
+ * @brief evaluate(const Board&)
+ *
+ * Evaluate the position with the accumulators of the calling thread.
+ *
+ * @note a network must be loaded.
+ *
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation in centipawns, positive if white is better.
+ *
+ */
+int Nnue::evaluate(const Board& board)
+{
+    assert(is_loaded());
+
+    NnueAccumulatorCache& cache = TablePool<NnueAccumulatorCache>::thread_table();
+
+    const Square white_king(lsb(board.get_bitboard_piece(Piece::W_KING)));
+    const Square black_king(lsb(board.get_bitboard_piece(Piece::B_KING)));
+
+    NnueAccumulatorCache::Entry& white_entry = cache.entry(ChessColor::WHITE, white_king, *network);
+    NnueAccumulatorCache::Entry& black_entry = cache.entry(ChessColor::BLACK, black_king, *network);
+
+    update_accumulator(white_entry, board, ChessColor::WHITE, white_king, *network);
+    update_accumulator(black_entry, board, ChessColor::BLACK, black_king, *network);
+
+    if (is_white(board.state().side_to_move())) {
+        return propagate(white_entry.accumulation, black_entry.accumulation, *network);
+    }
+    return -propagate(black_entry.accumulation, white_entry.accumulation, *network);
+}
+
+/**
+ * @brief evaluate_refresh(const Board&)
+ *
+ * Evaluate the position computing the accumulators from scratch, used to verify the incremental updates.
+ *
+ * @note a network must be loaded.
+ *
+ * @param[in] board chess position.
+ *
+ * @return (int) evaluation in centipawns, positive if white is better.
+ *
+ */
+int Nnue::evaluate_refresh(const Board& board)
+{
+    assert(is_loaded());
+
+    NnueAccumulatorCache::Entry white_entry;
+    NnueAccumulatorCache::Entry black_entry;
+
+    NnueAccumulatorCache::reset(white_entry, *network);
+    NnueAccumulatorCache::reset(black_entry, *network);
+
+    update_accumulator(white_entry, board, ChessColor::WHITE, Square(lsb(board.get_bitboard_piece(Piece::W_KING))),
+                       *network);
+    update_accumulator(black_entry, board, ChessColor::BLACK, Square(lsb(board.get_bitboard_piece(Piece::B_KING))),
+                       *network);
+
+    if (is_white(board.state().side_to_move())) {
+        return propagate(white_entry.accumulation, black_entry.accumulation, *network);
+    }
+    return -propagate(black_entry.accumulation, white_entry.accumulation, *network);
+}
+
+/**
+ * @brief update_accumulator(NnueAccumulatorCache::Entry&, const Board&, ChessColor, Square, const NnueNetwork&)
+ *
+ * Remove the features of the pieces that are not in the board and add the features of the new pieces.
+ *
+ * @param[in,out] entry accumulator of the perspective and king square.
+ * @param[in] board chess position.
+ * @param[in] perspective side of the accumulator.
+ * @param[in] king_square king square of the perspective side.
+ * @param[in] network loaded network.
+ *
+ */
+static void update_accumulator(NnueAccumulatorCache::Entry& entry, const Board& board, ChessColor perspective,
+                               Square king_square, const NnueNetwork& network)
+{
+    for (int i = 0; i < 10; i++) {
+
+        const Piece piece = NON_KING_PIECES[i];
+        const uint64_t pieces = board.get_bitboard_piece(piece);
+        uint64_t removed = entry.pieces[i] & ~pieces;
+        uint64_t added = pieces & ~entry.pieces[i];
+
+        while (removed) {
+            const Square square(pop_lsb(removed));
+            const uint32_t feature = Nnue::feature_index(perspective, king_square, piece, square);
+            remove_feature(entry.accumulation, network.featureWeights + feature * L1);
+        }
+        while (added) {
+            const Square square(pop_lsb(added));
+            const uint32_t feature = Nnue::feature_index(perspective, king_square, piece, square);
+            add_feature(entry.accumulation, network.featureWeights + feature * L1);
+        }
+
+        entry.pieces[i] = pieces;
+    }
+}
+
+/**
+ * @brief propagate(const int16_t*, const int16_t*, const NnueNetwork&)
+ *
+ * Hidden layers and output of the network.
+ *
+ * @param[in] side_to_move accumulator of the side to move.
+ * @param[in] other_side accumulator of the other side.
+ * @param[in] network loaded network.
+ *
+ * @return (int) evaluation in centipawns from the point of view of the side to move.
+ *
+ */
+static int propagate(const int16_t* side_to_move, const int16_t* other_side, const NnueNetwork& network)
+{
+    alignas(64) uint8_t transformed[2U * L1];
+    alignas(64) int32_t hidden1_sums[L2];
+    alignas(64) uint8_t hidden1[L2];
+    alignas(64) int32_t hidden2_sums[L3];
+    alignas(64) uint8_t hidden2[L3];
+    int32_t output;
+
+    clipped_relu(side_to_move, transformed);
+    clipped_relu(other_side, transformed + L1);
+
+    affine(transformed, 2U * L1, network.hidden1Weights, network.hidden1Biases, L2, hidden1_sums);
+    clipped_relu_shift(hidden1_sums, L2, hidden1);
+
+    affine(hidden1, L2, network.hidden2Weights, network.hidden2Biases, L3, hidden2_sums);
+    clipped_relu_shift(hidden2_sums, L3, hidden2);
+
+    affine(hidden2, L3, network.outputWeights, &network.outputBias, 1U, &output);
+
+    // the output is in pawns scaled by ACTIVATION_SCALE * WEIGHT_SCALE
+    return output * 100 / (NnueNetwork::ACTIVATION_SCALE * NnueNetwork::WEIGHT_SCALE);
+}
+
+/**
+ * @brief add_feature(int16_t*, const int16_t*)
+ *
+ * @param[in,out] accumulation accumulator of L1 values.
+ * @param[in] weights weights of the feature.
+ *
+ */
+static inline void add_feature(int16_t* accumulation, const int16_t* weights)
+{
+#if defined(__AVX2__)
+    for (uint32_t i = 0; i < L1; i += 16U) {
+        __m256i* acc = reinterpret_cast<__m256i*>(accumulation + i);
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(acc, _mm256_add_epi16(_mm256_loadu_si256(acc), w));
+    }
+#elif defined(__SSSE3__)
+    for (uint32_t i = 0; i < L1; i += 8U) {
+        __m128i* acc = reinterpret_cast<__m128i*>(accumulation + i);
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(acc, _mm_add_epi16(_mm_loadu_si128(acc), w));
+    }
+#else
+    for (uint32_t i = 0; i < L1; i++) {
+        accumulation[i] = static_cast<int16_t>(accumulation[i] + weights[i]);
+    }
+#endif
+}
+
+/**
+ * @brief remove_feature(int16_t*, const int16_t*)
+ *
+ * @param[in,out] accumulation accumulator of L1 values.
+ * @param[in] weights weights of the feature.
+ *
+ */
+static inline void remove_feature(int16_t* accumulation, const int16_t* weights)
+{
+#if defined(__AVX2__)
+    for (uint32_t i = 0; i < L1; i += 16U) {
+        __m256i* acc = reinterpret_cast<__m256i*>(accumulation + i);
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(acc, _mm256_sub_epi16(_mm256_loadu_si256(acc), w));
+    }
+#elif defined(__SSSE3__)
+    for (uint32_t i = 0; i < L1; i += 8U) {
+        __m128i* acc = reinterpret_cast<__m128i*>(accumulation + i);
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(acc, _mm_sub_epi16(_mm_loadu_si128(acc), w));
+    }
+#else
+    for (uint32_t i = 0; i < L1; i++) {
+        accumulation[i] = static_cast<int16_t>(accumulation[i] - weights[i]);
+    }
+#endif
+}
+
+/**
+ * @brief clipped_relu(const int16_t*, uint8_t*)
+ *
+ * Clamp the L1 values of an accumulator to [0, ACTIVATION_SCALE].
+ *
+ * @param[in] accumulation accumulator of L1 values.
+ * @param[out] output L1 activations.
+ *
+ */
+static inline void clipped_relu(const int16_t* accumulation, uint8_t* output)
+{
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    for (uint32_t i = 0; i < L1; i += 32U) {
+        const __m256i low = _mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulation + i)), zero);
+        const __m256i high =
+            _mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulation + i + 16U)), zero);
+        // packs works in 128 bit lanes, reorder the 64 bit blocks
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0b11011000);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+#elif defined(__SSSE3__)
+    const __m128i zero = _mm_setzero_si128();
+    for (uint32_t i = 0; i < L1; i += 16U) {
+        const __m128i low = _mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulation + i)), zero);
+        const __m128i high = _mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulation + i + 8U)), zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi16(low, high));
+    }
+#else
+    for (uint32_t i = 0; i < L1; i++) {
+        output[i] = static_cast<uint8_t>(std::clamp<int>(accumulation[i], 0, NnueNetwork::ACTIVATION_SCALE));
+    }
+#endif
+}
+
+/**
+ * @brief affine(const uint8_t*, uint32_t, const int8_t*, const int32_t*, uint32_t, int32_t*)
+ *
+ * output = weights * input + biases
+ *
+ * @param[in] input activations, input_size values.
+ * @param[in] input_size number of inputs, multiple of 32.
+ * @param[in] weights output_size rows of input_size weights.
+ * @param[in] biases output_size biases.
+ * @param[in] output_size number of outputs.
+ * @param[out] output output_size sums.
+ *
+ */
+static inline void affine(const uint8_t* input, uint32_t input_size, const int8_t* weights, const int32_t* biases,
+                          uint32_t output_size, int32_t* output)
+{
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (uint32_t j = 0; j < output_size; j++) {
+        const int8_t* row = weights + j * input_size;
+        __m256i sum = _mm256_setzero_si256();
+        for (uint32_t i = 0; i < input_size; i += 32U) {
+            const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            // u8 * i8 pairs fit in int16 because the activations are at most 127
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+        }
+        __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b01001110));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b10110001));
+        output[j] = biases[j] + _mm_cvtsi128_si32(sum128);
+    }
+#elif defined(__SSSE3__)
+    const __m128i ones = _mm_set1_epi16(1);
+    for (uint32_t j = 0; j < output_size; j++) {
+        const int8_t* row = weights + j * input_size;
+        __m128i sum = _mm_setzero_si128();
+        for (uint32_t i = 0; i < input_size; i += 16U) {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(in, w), ones));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b01001110));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b10110001));
+        output[j] = biases[j] + _mm_cvtsi128_si32(sum);
+    }
+#else
+    for (uint32_t j = 0; j < output_size; j++) {
+        const int8_t* row = weights + j * input_size;
+        int32_t sum = biases[j];
+        for (uint32_t i = 0; i < input_size; i++) {
+            sum += static_cast<int32_t>(input[i]) * static_cast<int32_t>(row[i]);
+        }
+        output[j] = sum;
+    }
+#endif
+}
+
+/**
+ * @brief clipped_relu_shift(const int32_t*, uint32_t, uint8_t*)
+ *
+ * Remove the weight scale of the sums of a hidden layer and clamp them to [0, ACTIVATION_SCALE].
+ *
+ * @param[in] input sums of the hidden layer.
+ * @param[in] size number of sums.
+ * @param[out] output activations.
+ *
+ */
+static inline void clipped_relu_shift(const int32_t* input, uint32_t size, uint8_t* output)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        output[i] = static_cast<uint8_t>(
+            std::clamp(input[i] >> NnueNetwork::WEIGHT_SCALE_BITS, 0, NnueNetwork::ACTIVATION_SCALE));
+    }
+}
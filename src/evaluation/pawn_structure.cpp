@@ -0,0 +1,362 @@
+/**
+ * @file pawn_structure.cpp
+ * @brief pawn structure evaluation implementation.
+ *
+ * Pawn structure terms cached in a pawn hash table indexed by the pawn zobrist key.
+ *
+ * https://www.chessprogramming.org/Pawn_Structure
+ * https://www.chessprogramming.org/Pawn_Hash_Table
+ *
+ */
+
+#include "pawn_structure.hpp"
+#include "precomputed_eval_data.hpp"
+#include "bit_utilities.hpp"
+#include "table_pool.hpp"
+#include <algorithm>
+
+// pawn structure scores
+static constexpr int32_t ISOLATED_PAWN = make_score(-10, -15);
+static constexpr int32_t DOUBLED_PAWN = make_score(-10, -20);
+static constexpr int32_t BACKWARD_PAWN = make_score(-8, -10);
+
+// passed pawn bonus indexed by the relative row of the pawn
+static constexpr int32_t PASSED_PAWN[8] = {make_score(0, 0),   make_score(5, 10),  make_score(10, 15),
+                                           make_score(15, 25), make_score(25, 45), make_score(45, 70),
+                                           make_score(70, 110), make_score(0, 0)};
+
+// king shelter indexed by the distance to the closest pawn in front of the king in each file (0 = no pawn)
+static constexpr int SHIELD_PAWN[8] = {-15, 20, 10, 5, 0, 0, 0, 0};
+static constexpr int STORM_PAWN[8] = {0, -5, -25, -15, -5, 0, 0, 0};
+
+// rook in a file without pawns or without own pawns
+static constexpr int32_t ROOK_OPEN_FILE = make_score(20, 10);
+static constexpr int32_t ROOK_SEMI_OPEN_FILE = make_score(10, 5);
+
+template<ChessColor color>
+static int32_t evaluate_pawns(const Board& board, PawnEntry& entry);
+template<ChessColor color>
+static int king_shelter_score(Square king_sq, const Board& board);
+
+/**
+ * @brief rows in front of the row from the point of view of the color
+ *
+ * @param[in] color pawn color.
+ * @param[in] row selected row.
+ *
+ * @return (uint64_t) mask of the rows in front of the row.
+ */
+static constexpr inline uint64_t forward_rows_mask(ChessColor color, Row row)
+{
+    if (is_white(color)) {
+        return row == ROW_8 ? 0ULL : ~0ULL << ((static_cast<int>(row) + 1) * 8);
+    }
+    return (1ULL << (static_cast<int>(row) * 8)) - 1ULL;
+}
+
+/**
+ * @brief cols next to the col
+ *
+ * @param[in] col selected col.
+ *
+ * @return (uint64_t) mask of the adjacent cols.
+ */
+static constexpr inline uint64_t adjacent_cols_mask(Col col)
+{
+    return (col > COL_A ? get_col_mask(col - 1) : 0ULL) | (col < COL_H ? get_col_mask(col + 1) : 0ULL);
+}
+
+/**
+ * @brief squares attacked by all the pawns
+ *
+ * @param[in] color pawns color.
+ * @param[in] pawns pawns bitboard.
+ *
+ * @return (uint64_t) attacks bitboard.
+ */
+static constexpr inline uint64_t pawns_attacks(ChessColor color, uint64_t pawns)
+{
+    const uint64_t not_col_a = pawns & ~get_col_mask(COL_A);
+    const uint64_t not_col_h = pawns & ~get_col_mask(COL_H);
+
+    return is_white(color) ? (not_col_a << 7) | (not_col_h << 9) : (not_col_a >> 9) | (not_col_h >> 7);
+}
+
+/**
+ * @brief PawnHashTable
+ *
+ * Allocates the entries.
+ *
+ * @note the default entry is the entry of the positions without pawns (pawn key 0).
+ *
+ */
+PawnHashTable::PawnHashTable() : entries(NUM_ENTRIES) {}
+
+/**
+ * @brief thread_table()
+ *
+ * @return (PawnHashTable&) pawn hash table of the calling thread.
+ *
+ */
+PawnHashTable& PawnHashTable::thread_table() { return TablePool<PawnHashTable>::thread_table(); }
+
+/**
+ * @brief probe(const Board&)
+ *
+ * Get the pawn entry of the position, the entry is calculated if it is not in the table.
+ *
+ * @param[in] board chess position.
+ *
+ * @return (PawnEntry&) pawn entry of the position.
+ *
+ */
+PawnEntry& PawnHashTable::probe(const Board& board)
+{
+    const uint64_t key = board.state().get_pawn_key();
+    PawnEntry& entry = entries[key & (NUM_ENTRIES - 1U)];
+
+    // only this thread writes the counters, no need for atomic increments
+    probeCount.store(probeCount.load(std::memory_order_relaxed) + 1ULL, std::memory_order_relaxed);
+
+    if (entry.key == key) {
+        hitCount.store(hitCount.load(std::memory_order_relaxed) + 1ULL, std::memory_order_relaxed);
+        return entry;
+    }
+
+    entry.key = key;
+    entry.kingSquare[static_cast<int>(ChessColor::WHITE)] = Square::INVALID;
+    entry.kingSquare[static_cast<int>(ChessColor::BLACK)] = Square::INVALID;
+    entry.score = evaluate_pawns<ChessColor::WHITE>(board, entry) - evaluate_pawns<ChessColor::BLACK>(board, entry);
+
+    return entry;
+}
+
+/**
+ * @brief clear_stats()
+ *
+ * Reset the probes and hits of all the tables.
+ *
+ * @note must not be called while a search is running.
+ *
+ */
+void PawnHashTable::clear_stats()
+{
+    TablePool<PawnHashTable>::for_each([](PawnHashTable& table) {
+        table.probeCount = 0ULL;
+        table.hitCount = 0ULL;
+    });
+}
+
+/**
+ * @brief probes()
+ *
+ * @return (uint64_t) probes of all the tables since the last clear_stats.
+ *
+ */
+uint64_t PawnHashTable::probes()
+{
+    uint64_t probes = 0ULL;
+    TablePool<PawnHashTable>::for_each(
+        [&probes](const PawnHashTable& table) { probes += table.probeCount.load(std::memory_order_relaxed); });
+    return probes;
+}
+
+/**
+ * @brief hits()
+ *
+ * @return (uint64_t) hits of all the tables since the last clear_stats.
+ *
+ */
+uint64_t PawnHashTable::hits()
+{
+    uint64_t hits = 0ULL;
+    TablePool<PawnHashTable>::for_each(
+        [&hits](const PawnHashTable& table) { hits += table.hitCount.load(std::memory_order_relaxed); });
+    return hits;
+}
+
+/**
+ * @brief king_shelter(PawnEntry&, const Board&)
+ *
+ * Pawn shield and pawn storm in front of the kings, cached in the entry for the king squares.
+ *
+ * @param[in, out] entry pawn entry of the position.
+ * @param[in] board chess position.
+ *
+ * @return (int32_t) packed score (make_score), positive if white is better.
+ *
+ */
+int32_t king_shelter(PawnEntry& entry, const Board& board)
+{
+    constexpr int WHITE = static_cast<int>(ChessColor::WHITE);
+    constexpr int BLACK = static_cast<int>(ChessColor::BLACK);
+
+    const Square white_king_sq(lsb(board.get_bitboard_piece(Piece::W_KING)));
+    const Square black_king_sq(lsb(board.get_bitboard_piece(Piece::B_KING)));
+
+    if (entry.kingSquare[WHITE] != white_king_sq) {
+        entry.kingSquare[WHITE] = white_king_sq;
+        entry.kingShelter[WHITE] = make_score(king_shelter_score<ChessColor::WHITE>(white_king_sq, board), 0);
+    }
+    if (entry.kingSquare[BLACK] != black_king_sq) {
+        entry.kingSquare[BLACK] = black_king_sq;
+        entry.kingShelter[BLACK] = make_score(king_shelter_score<ChessColor::BLACK>(black_king_sq, board), 0);
+    }
+
+    return entry.kingShelter[WHITE] - entry.kingShelter[BLACK];
+}
+
+/**
+ * @brief rooks_on_open_files(const PawnEntry&, const Board&)
+ *
+ * Bonus for the rooks in files without pawns (open) or without own pawns (semi open).
+ *
+ * @param[in] entry pawn entry of the position.
+ * @param[in] board chess position.
+ *
+ * @return (int32_t) packed score (make_score), positive if white is better.
+ *
+ */
+int32_t rooks_on_open_files(const PawnEntry& entry, const Board& board)
+{
+    int32_t score = 0;
+
+    for (const ChessColor color : {ChessColor::WHITE, ChessColor::BLACK}) {
+        const uint8_t own_semi_open = entry.semiOpenFiles[static_cast<int>(color)];
+        const uint8_t enemy_semi_open = entry.semiOpenFiles[static_cast<int>(opposite_color(color))];
+
+        uint64_t rooks = board.get_bitboard_piece(create_piece(PieceType::ROOK, color));
+        int32_t color_score = 0;
+
+        while (rooks) {
+            const uint8_t file_bit = 1U << Square(pop_lsb(rooks)).col();
+            if (own_semi_open & file_bit) {
+                color_score += enemy_semi_open & file_bit ? ROOK_OPEN_FILE : ROOK_SEMI_OPEN_FILE;
+            }
+        }
+        score += is_white(color) ? color_score : -color_score;
+    }
+
+    return score;
+}
+
+/**
+ * @brief evaluate_pawns(const Board&, PawnEntry&)
+ *
+ * Passed, isolated, doubled and backward pawns of one side, fills the bitboards of the side in the entry.
+ *
+ * @tparam color side to evaluate.
+ * @param[in] board chess position.
+ * @param[out] entry pawn entry of the position.
+ *
+ * @return (int32_t) packed score (make_score), positive if the side is better.
+ *
+ */
+template<ChessColor color>
+static int32_t evaluate_pawns(const Board& board, PawnEntry& entry)
+{
+    constexpr ChessColor enemy_color = opposite_color(color);
+    constexpr int c = static_cast<int>(color);
+
+    const uint64_t own_pawns = board.get_bitboard_piece(create_piece(PieceType::PAWN, color));
+    const uint64_t enemy_pawns = board.get_bitboard_piece(create_piece(PieceType::PAWN, enemy_color));
+    const uint64_t enemy_attacks = pawns_attacks(enemy_color, enemy_pawns);
+
+    entry.pawnAttacks[c] = pawns_attacks(color, own_pawns);
+    entry.pawnAttacksSpan[c] = 0ULL;
+    entry.passedPawns[c] = 0ULL;
+    entry.semiOpenFiles[c] = 0xff;
+
+    int32_t score = 0;
+    uint64_t pawns = own_pawns;
+
+    while (pawns) {
+        const Square square(pop_lsb(pawns));
+        const Row row = square.row();
+        const Col col = square.col();
+        const int relative_row = is_white(color) ? static_cast<int>(row) : static_cast<int>(ROW_8) - row;
+
+        const uint64_t forward = forward_rows_mask(color, row);
+        const uint64_t col_mask = get_col_mask(col);
+        const uint64_t adjacent = adjacent_cols_mask(col);
+
+        entry.semiOpenFiles[c] &= ~(1U << col);
+        entry.pawnAttacksSpan[c] |= forward & adjacent;
+
+        const bool doubled = (forward & col_mask & own_pawns) != 0ULL;   // the front pawn is not penalized
+        const bool isolated = (adjacent & own_pawns) == 0ULL;
+        const bool passed = !doubled && (forward & (col_mask | adjacent) & enemy_pawns) == 0ULL;
+
+        // no own pawns in the adjacent files that can defend it and the square in front is attacked by a pawn
+        const Square stop_square(is_white(color) ? row + 1 : row - 1, col);
+        const bool backward = !isolated && !passed && (adjacent & own_pawns & ~forward) == 0ULL &&
+            stop_square.is_valid() && (enemy_attacks & stop_square.mask()) != 0ULL;
+
+        if (doubled) {
+            score += DOUBLED_PAWN;
+        }
+        if (isolated) {
+            score += ISOLATED_PAWN;
+        }
+        if (backward) {
+            score += BACKWARD_PAWN;
+        }
+        if (passed) {
+            score += PASSED_PAWN[relative_row];
+            entry.passedPawns[c] |= square.mask();
+        }
+    }
+
+    return score;
+}
+
+/**
+ * @brief king_shelter_score(Square, const Board&)
+ *
+ * Own pawns in front of the king (shield) and enemy pawns approaching the king (storm)
+ * in the file of the king and the adjacent files.
+ *
+ * @tparam color side of the king.
+ * @param[in] king_sq king square.
+ * @param[in] board chess position.
+ *
+ * @return (int) middlegame score, positive if the king is safe.
+ *
+ */
+template<ChessColor color>
+static int king_shelter_score(Square king_sq, const Board& board)
+{
+    constexpr ChessColor enemy_color = opposite_color(color);
+
+    const uint64_t own_pawns = board.get_bitboard_piece(create_piece(PieceType::PAWN, color));
+    const uint64_t enemy_pawns = board.get_bitboard_piece(create_piece(PieceType::PAWN, enemy_color));
+    const uint64_t forward = forward_rows_mask(color, king_sq.row());
+
+    const int king_col = static_cast<int>(king_sq.col());
+    const int king_row = static_cast<int>(king_sq.row());
+    const int first_col = std::max(static_cast<int>(COL_A), king_col - 1);
+    const int last_col = std::min(static_cast<int>(COL_H), king_col + 1);
+
+    int score = 0;
+
+    for (int col = first_col; col <= last_col; col++) {
+        const uint64_t own = own_pawns & forward & get_col_mask(static_cast<Col>(col));
+        const uint64_t enemy = enemy_pawns & forward & get_col_mask(static_cast<Col>(col));
+
+        // closest pawns to the king in the file
+        int own_distance = 0;
+        int enemy_distance = 0;
+        if (own) {
+            const Square own_sq(is_white(color) ? lsb(own) : msb(own));
+            own_distance = std::abs(static_cast<int>(own_sq.row()) - king_row);
+        }
+        if (enemy) {
+            const Square enemy_sq(is_white(color) ? lsb(enemy) : msb(enemy));
+            enemy_distance = std::abs(static_cast<int>(enemy_sq.row()) - king_row);
+        }
+
+        score += SHIELD_PAWN[own_distance] + STORM_PAWN[enemy_distance];
+    }
+
+    return score;
+}
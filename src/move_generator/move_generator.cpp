@@ -0,0 +1,45 @@
+/**
+ * @file move_generator.cpp
+ * @brief move generator services implementation.
+ *
+ * Move generation with the algorithm selected in AlgorithmSelection.
+ *
+ */
+
+#include "move_generator.hpp"
+
+/**
+ * @brief generate_legal_moves
+ *
+ * Calculate all the legal moves in the chess position with the move generator selected in AlgorithmSelection.
+ *
+ * @note the search does not use this dispatch, it calls generate_legal_moves<MoveGeneratorType,
+ * MoveGeneratorAlgorithm> directly.
+ *
+ * @param[out] moves move list.
+ * @param[in] board chess position.
+ * @param[out] inCheck (optional) return true if the king is in check.
+ *
+ */
+template<MoveGeneratorType genType>
+void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
+{
+    switch (AlgorithmSelection::move_generator()) {
+    case MoveGeneratorAlgorithm::BASIC:
+        generate_legal_moves<genType, MoveGeneratorAlgorithm::BASIC>(moves, board, inCheck);
+        break;
+    case MoveGeneratorAlgorithm::MAGIC_BITBOARDS:
+        generate_legal_moves<genType, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(moves, board, inCheck);
+        break;
+    }
+}
+
+/**
+ * @brief Explicit instantiation of generate_legal_moves for ALL_MOVES.
+ */
+template void generate_legal_moves<ALL_MOVES>(MoveList& moves, Board& board, bool* inCheck);
+
+/**
+ * @brief Explicit instantiation of generate_legal_moves for ONLY_CAPTURES.
+ */
+template void generate_legal_moves<ONLY_CAPTURES>(MoveList& moves, Board& board, bool* inCheck);
@@ -37,7 +37,7 @@ static void calculate_queen_moves(Square queen_sq, MoveGeneratorInfo& moveGenera
 static bool en_passant_move_doesnt_allow_king_capture(Move enPassant_move, MoveGeneratorInfo& moveGeneratorInfo);
 
 /**
- * @brief generate_legal_moves
+ * @brief generate_legal_moves_basic
  * 
  * Calculate all the legal moves in the chess position.
  * 
@@ -47,7 +47,7 @@ static bool en_passant_move_doesnt_allow_king_capture(Move enPassant_move, MoveG
  * 
  */
 template<MoveGeneratorType genType>
-void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
+void generate_legal_moves_basic(MoveList& moves, Board& board, bool* inCheck)
 {
     MoveGeneratorInfo moveGeneratorInfo(board, moves);
 
@@ -94,7 +94,7 @@ void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
 }
 
 /**
- * @brief generate_legal_moves
+ * @brief generate_legal_moves_basic
  * 
  * Calculate all the legal moves in the chess position.
  * 
@@ -102,10 +102,10 @@ void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
  * @param[in] board Chess position.
  * @param[out] inCheck (optional) Return true if the king is in check.
  */
-template void generate_legal_moves<ALL_MOVES>(MoveList& moves, Board& board, bool* inCheck);
+template void generate_legal_moves_basic<ALL_MOVES>(MoveList& moves, Board& board, bool* inCheck);
 
 /**
- * @brief generate_legal_moves
+ * @brief generate_legal_moves_basic
  * 
  * Calculate only captures moves in the chess position.
  * 
@@ -113,7 +113,7 @@ template void generate_legal_moves<ALL_MOVES>(MoveList& moves, Board& board, boo
  * @param[in] board Chess position.
  * @param[out] inCheck (optional) Return true if the king is in check.
  */
-template void generate_legal_moves<ONLY_CAPTURES>(MoveList& moves, Board& board, bool* inCheck);
+template void generate_legal_moves_basic<ONLY_CAPTURES>(MoveList& moves, Board& board, bool* inCheck);
 
 static void update_move_generator_info(MoveGeneratorInfo& moveGeneratorInfo)
 {
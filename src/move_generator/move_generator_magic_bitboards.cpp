@@ -38,7 +38,7 @@ static void calculate_queen_moves(Square queen_sq, MoveGeneratorInfo& moveGenera
 static bool en_passant_move_doesnt_allow_king_capture(Move enPassant_move, MoveGeneratorInfo& moveGeneratorInfo);
 
 /**
- * @brief generate_legal_moves
+ * @brief generate_legal_moves_magic_bitboards
  * 
  * Calculate all the legal moves in the chess position.
  * 
@@ -49,7 +49,7 @@ static bool en_passant_move_doesnt_allow_king_capture(Move enPassant_move, MoveG
  * 
  */
 template<MoveGeneratorType genType>
-void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
+void generate_legal_moves_magic_bitboards(MoveList& moves, Board& board, bool* inCheck)
 {
     board.update_attacks_bb();
 
@@ -93,7 +93,7 @@ void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
 }
 
 /**
- * @brief Explicit instantiation of generate_legal_moves for ALL_MOVES.
+ * @brief Explicit instantiation of generate_legal_moves_magic_bitboards for ALL_MOVES.
  *
  * This instantiation calculates all legal moves in the chess position,
  * including captures and non-captures.
@@ -102,10 +102,10 @@ void generate_legal_moves(MoveList& moves, Board& board, bool* inCheck)
  * @param[in] board Current chess position.
  * @param[out] inCheck (optional) Indicates if the king is in check.
  */
-template void generate_legal_moves<ALL_MOVES>(MoveList& moves, Board& board, bool* inCheck);
+template void generate_legal_moves_magic_bitboards<ALL_MOVES>(MoveList& moves, Board& board, bool* inCheck);
 
 /**
- * @brief Explicit instantiation of generate_legal_moves for ONLY_CAPTURES.
+ * @brief Explicit instantiation of generate_legal_moves_magic_bitboards for ONLY_CAPTURES.
  *
  * This instantiation calculates only capture moves in the chess position.
  *
@@ -113,7 +113,7 @@ template void generate_legal_moves<ALL_MOVES>(MoveList& moves, Board& board, boo
  * @param[in] board Current chess position.
  * @param[out] inCheck (optional) Indicates if the king is in check.
  */
-template void generate_legal_moves<ONLY_CAPTURES>(MoveList& moves, Board& board, bool* inCheck);
+template void generate_legal_moves_magic_bitboards<ONLY_CAPTURES>(MoveList& moves, Board& board, bool* inCheck);
 
 static void update_pins_and_checks(Square king_sq, MoveGeneratorInfo& moveGeneratorInfo)
 {
@@ -0,0 +1,169 @@
+/**
+ * @file static_exchange_evaluation.cpp
+ * @brief static exchange evaluation services.
+ *
+ * SEE (Static Exchange Evaluation) implementation with the swap algorithm.
+ *
+ * https://www.chessprogramming.org/Static_Exchange_Evaluation
+ * https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+ *
+ */
+
+#include "static_exchange_evaluation.hpp"
+#include "precomputed_move_data.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+
+/**
+ * @brief max number of captures in an exchange sequence (32 pieces on the board)
+ */
+static constexpr int MAX_EXCHANGE_LENGTH = 32;
+
+static uint64_t attackers_to(const Board& board, Square square, uint64_t occupied);
+
+static PieceType least_valuable_attacker(const Board& board, uint64_t attackers, ChessColor color, Square& attacker_sq);
+
+/**
+ * @brief static_exchange_evaluation(const Board&, Move)
+ *
+ * Calculates the material balance of the sequence of captures on the destination square of the move,
+ * both sides always recapture with their least valuable attacker and can stop the exchange at any time.
+ *
+ * @note move should be legal in the position.
+ *
+ * @param[in] board chess position.
+ * @param[in] move move to evaluate.
+ *
+ * @return (int) material gained by the side to move (centipawns), negative if the exchange loses material.
+ *
+ */
+int static_exchange_evaluation(const Board& board, Move move)
+{
+    assert(move.is_valid());
+
+    if (move.type() == MoveType::CASTLING) {
+        return 0;   // castling can not capture
+    }
+
+    const Square from = move.square_from();
+    const Square to = move.square_to();
+    const Piece moving_piece = board.get_piece(from);
+    ChessColor side = get_color(moving_piece);
+
+    int gain[MAX_EXCHANGE_LENGTH];
+    int d = 0;
+
+    uint64_t occupied = board.get_bitboard_all() ^ from.mask();
+
+    PieceType attacker = piece_to_pieceType(moving_piece);
+
+    if (move.type() == MoveType::EN_PASSANT) {
+        const Square captured_pawn_sq = is_white(side) ? to.south() : to.north();
+        occupied ^= captured_pawn_sq.mask();
+        gain[0] = static_cast<int>(raw_value(PieceType::PAWN));
+    }
+    else {
+        gain[0] = board.is_empty(to) ? 0 : static_cast<int>(raw_value(piece_to_pieceType(board.get_piece(to))));
+    }
+
+    if (move.type() == MoveType::PROMOTION) {
+        attacker = move.promotion_piece();
+        gain[0] += static_cast<int>(raw_value(attacker) - raw_value(PieceType::PAWN));
+    }
+
+    uint64_t attackers = attackers_to(board, to, occupied) & occupied;
+
+    side = opposite_color(side);
+
+    Square attacker_sq;
+
+    do {
+        d++;
+
+        gain[d] = static_cast<int>(raw_value(attacker)) - gain[d - 1];   // speculative store, if defended
+
+        if (std::max(-gain[d - 1], gain[d]) < 0) {
+            break;   // pruning does not influence the result
+        }
+
+        const PieceType next_attacker = least_valuable_attacker(board, attackers, side, attacker_sq);
+
+        // no more attackers, or the king can not recapture because the square is still defended
+        if (next_attacker == PieceType::EMPTY ||
+            (next_attacker == PieceType::KING && (attackers & board.get_bitboard_color(opposite_color(side))))) {
+            break;
+        }
+
+        occupied ^= attacker_sq.mask();
+        attackers = attackers_to(board, to, occupied) & occupied;   // reveal x-ray attackers
+        attacker = next_attacker;
+        side = opposite_color(side);
+
+    } while (d < MAX_EXCHANGE_LENGTH - 1);
+
+    while (--d) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    }
+
+    return gain[0];
+}
+
+/**
+ * @brief attackers_to(const Board&, Square, uint64_t)
+ *
+ * Calculates the bitboard with all the pieces (both colors) attacking the square.
+ *
+ * @param[in] board chess position.
+ * @param[in] square attacked square.
+ * @param[in] occupied occupancy bitboard, sliders are blocked by these pieces.
+ *
+ * @return (uint64_t) attackers bitboard
+ *
+ */
+static uint64_t attackers_to(const Board& board, Square square, uint64_t occupied)
+{
+    const uint64_t bishops_queens = board.get_bitboard_piece(Piece::W_BISHOP) |
+        board.get_bitboard_piece(Piece::B_BISHOP) | board.get_bitboard_piece(Piece::W_QUEEN) |
+        board.get_bitboard_piece(Piece::B_QUEEN);
+
+    const uint64_t rooks_queens = board.get_bitboard_piece(Piece::W_ROOK) | board.get_bitboard_piece(Piece::B_ROOK) |
+        board.get_bitboard_piece(Piece::W_QUEEN) | board.get_bitboard_piece(Piece::B_QUEEN);
+
+    const uint64_t knights = board.get_bitboard_piece(Piece::W_KNIGHT) | board.get_bitboard_piece(Piece::B_KNIGHT);
+    const uint64_t kings = board.get_bitboard_piece(Piece::W_KING) | board.get_bitboard_piece(Piece::B_KING);
+
+    return (PrecomputedMoveData::pawnAttacks(square, ChessColor::BLACK) & board.get_bitboard_piece(Piece::W_PAWN)) |
+        (PrecomputedMoveData::pawnAttacks(square, ChessColor::WHITE) & board.get_bitboard_piece(Piece::B_PAWN)) |
+        (PrecomputedMoveData::knightAttacks(square) & knights) | (PrecomputedMoveData::kingAttacks(square) & kings) |
+        (PrecomputedMoveData::bishopMoves(square, occupied) & bishops_queens) |
+        (PrecomputedMoveData::rookMoves(square, occupied) & rooks_queens);
+}
+
+/**
+ * @brief least_valuable_attacker(const Board&, uint64_t, ChessColor, Square&)
+ *
+ * Find the least valuable piece of the selected color in the attackers bitboard.
+ *
+ * @param[in] board chess position.
+ * @param[in] attackers attackers bitboard.
+ * @param[in] color attackers color.
+ * @param[out] attacker_sq square of the least valuable attacker.
+ *
+ * @return (PieceType) least valuable attacker, PieceType::EMPTY if there is no attacker
+ *
+ */
+static PieceType least_valuable_attacker(const Board& board, uint64_t attackers, ChessColor color, Square& attacker_sq)
+{
+    for (int type = static_cast<int>(PieceType::PAWN); type <= static_cast<int>(PieceType::KING); type++) {
+
+        const PieceType piece_type = static_cast<PieceType>(type);
+        const uint64_t piece_attackers = attackers & board.get_bitboard_piece(create_piece(piece_type, color));
+
+        if (piece_attackers) {
+            attacker_sq = Square(lsb(piece_attackers));
+            return piece_type;
+        }
+    }
+
+    return PieceType::EMPTY;
+}
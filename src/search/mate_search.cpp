@@ -0,0 +1,408 @@
+/**
+ * @file mate_search.cpp
+ * @brief mate search services.
+ *
+ * Depth-first proof-number search (df-pn) restricted to checking moves for the attacker.
+ * The nodes are the positions with the number of moves left to mate, so the search graph has no cycles
+ * and the proof of mate in N is reused when searching mate in N + 1.
+ *
+ * https://www.chessprogramming.org/Proof-Number_Search
+ * https://www.chessprogramming.org/Proof-number_search#Depth-First_Proof-Number_Search
+ *
+ */
+
+#include "mate_search.hpp"
+#include "move_generator.hpp"
+#include "move_list.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+#include <cassert>
+
+/**
+ * @brief proof or disproof number of a solved node
+ */
+static constexpr uint32_t PN_INF = 100000000U;
+
+std::vector<MateSearch::Entry> MateSearch::entries = initialization();
+uint64_t MateSearch::nodesVisited = 0ULL;
+TimeManager* MateSearch::timeManager = nullptr;
+
+static inline uint32_t add_saturated(uint32_t a, uint32_t b) { return std::min(a + b, PN_INF); }
+
+/**
+ * @brief MateSearch::search(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
+ *
+ * Search the shortest forced mate in at most limits.mate moves for the side to move.
+ * If a mate is found one result is inserted with the mate score and the mating line,
+ * if there is no mate no result is inserted.
+ *
+ * @param[in] stop stop search signal.
+ * @param[out] results struct where to store the results.
+ * @param[in] board chess position.
+ * @param[in] limits number of moves of the mate (limits.mate) and time manager
+ *
+ */
+void MateSearch::search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits)
+{
+    assert(stop == false);
+
+    start_search_results(results);
+
+    Move pv[MAX_PLY];
+    int pv_length = 0;
+
+    const int max_moves = std::clamp(limits.mate, 1, MAX_MATE_MOVES);
+
+    timeManager = limits.timeManager;
+    const int mate_moves = find_mate(stop, board, max_moves, pv, pv_length);
+    timeManager = nullptr;
+
+    results.nodes = nodesVisited;
+
+    if (mate_moves > 0) {
+        // same score as the alpha beta search, the mated king is at ply 2 * mate_moves - 1
+        const int plies = 2 * mate_moves - 1;
+        const int score = is_white(board.state().side_to_move()) ? MATE_IN_ONE_SCORE - plies
+                                                                 : -(MATE_IN_ONE_SCORE - plies);
+
+        insert_new_result(results, plies, score, pv[0], pv, pv_length);
+    }
+
+    // stop signal
+    stop = true;
+
+    // notify the reader thread that search has stopped
+    notify_search_finished(results);
+}
+
+/**
+ * @brief MateSearch::find_mate(std::atomic<bool>&, Board&, int, Move*, int&)
+ *
+ * Find the shortest forced mate for the side to move, first mate in 1, then mate in 2 ...
+ *
+ * @param[in] stop stop search signal.
+ * @param[in] board chess position.
+ * @param[in] max_moves max number of moves of the mate (1 <= max_moves <= MAX_MATE_MOVES).
+ * @param[out] pv mating line, at least MAX_PLY moves.
+ * @param[out] pv_length number of moves of the mating line.
+ *
+ * @return (int) number of moves of the mate, 0 if there is no mate in max_moves or the search was stopped.
+ *
+ */
+int MateSearch::find_mate(std::atomic<bool>& stop, Board& board, int max_moves, Move* pv, int& pv_length)
+{
+    assert(max_moves >= 1 && max_moves <= MAX_MATE_MOVES);
+
+    nodesVisited = 0ULL;
+    pv_length = 0;
+
+    int mate_moves = 0;
+
+    for (int moves_left = 1; moves_left <= max_moves && !stop; moves_left++) {
+        if (prove<true>(stop, board, moves_left)) {
+            mate_moves = moves_left;
+            break;
+        }
+    }
+
+    if (mate_moves == 0 || stop) {
+        return 0;
+    }
+
+    // mating line, the attacker plays a proven move and the defender the reply that delays the mate the most
+    const uint64_t root_zobrist = board.state().get_zobrist_key();
+    Move line[MAX_PLY];
+    GameState line_states[MAX_PLY];
+    MoveList moves;
+    int moves_left = mate_moves;
+    bool attacker = true;
+
+    while (pv_length < MAX_PLY) {
+        generate_legal_moves<ALL_MOVES>(moves, board);
+
+        if (moves.size() == 0 || (!attacker && moves_left == 0)) {
+            break;   // checkmate
+        }
+
+        Move chosen = attacker ? Move::null() : moves[0];
+
+        for (int i = 0; i < moves.size(); i++) {
+            if (attacker && !board.move_gives_check(moves[i])) {
+                continue;
+            }
+
+            const GameState state = board.state();
+            board.make_move(moves[i]);
+            const bool found = attacker ? prove<false>(stop, board, moves_left - 1)
+                                        : moves_left == 1 || !prove<true>(stop, board, moves_left - 1);
+            board.unmake_move(moves[i], state);
+
+            if (found) {
+                chosen = moves[i];
+                break;
+            }
+        }
+
+        if (!chosen.is_valid()) {
+            break;   // the mate table was overwritten and the proof was not found again (stopped)
+        }
+
+        line_states[pv_length] = board.state();
+        line[pv_length++] = chosen;
+        board.make_move(chosen);
+
+        if (attacker) {
+            moves_left--;
+        }
+        attacker = !attacker;
+    }
+
+    for (int i = pv_length - 1; i >= 0; i--) {
+        board.unmake_move(line[i], line_states[i]);
+    }
+
+    assert(board.state().get_zobrist_key() == root_zobrist);
+
+    std::copy(line, line + pv_length, pv);
+
+    return pv_length > 0 ? mate_moves : 0;
+}
+
+/**
+ * @brief MateSearch::prove(std::atomic<bool>&, Board&, int)
+ *
+ * Search the node until it is proven or disproven.
+ *
+ * @tparam attacker true if the attacker (side searching the mate) is to move
+ *
+ * @param[in] stop stop search signal.
+ * @param[in] board chess position.
+ * @param[in] moves_left moves of the attacker left to give mate.
+ *
+ * @return true if the attacker mates in moves_left moves.
+ *
+ */
+template<bool attacker>
+bool MateSearch::prove(std::atomic<bool>& stop, Board& board, int moves_left)
+{
+    uint32_t proof, disproof;
+    mid<attacker>(stop, board, moves_left, PN_INF, PN_INF, proof, disproof);
+
+    return proof == 0U;
+}
+
+/**
+ * @brief MateSearch::mid(std::atomic<bool>&, Board&, int, uint32_t, uint32_t, uint32_t&, uint32_t&)
+ *
+ * Multiple iterative deepening of df-pn, expands the most proving child until the proof or disproof
+ * number of the node reaches its threshold.
+ *
+ * In the attacker nodes (OR) proof = min(children proof), disproof = sum(children disproof).
+ * In the defender nodes (AND) proof = sum(children proof), disproof = min(children disproof).
+ *
+ * @tparam attacker true if the attacker is to move
+ *
+ * @param[in] stop stop search signal.
+ * @param[in] board chess position.
+ * @param[in] moves_left moves of the attacker left to give mate.
+ * @param[in] threshold_proof proof number threshold.
+ * @param[in] threshold_disproof disproof number threshold.
+ * @param[out] proof proof number of the node.
+ * @param[out] disproof disproof number of the node.
+ *
+ */
+template<bool attacker>
+void MateSearch::mid(std::atomic<bool>& stop, Board& board, int moves_left, uint32_t threshold_proof,
+                     uint32_t threshold_disproof, uint32_t& proof, uint32_t& disproof)
+{
+    nodesVisited++;
+
+    if (timeManager != nullptr && (nodesVisited % 1024ULL) == 0ULL && timeManager->hard_limit_reached()) {
+        stop = true;   // maximum time of the search
+    }
+
+    const uint64_t zobrist = board.state().get_zobrist_key();
+
+    MoveList moves;
+    bool in_check;
+    generate_legal_moves<ALL_MOVES>(moves, board, &in_check);
+
+    if constexpr (attacker) {
+        moves.filter([&board](const Move& move) { return board.move_gives_check(move); });
+    }
+
+    // terminal nodes
+    if (!attacker && moves.size() == 0 && in_check) {
+        proof = 0U;   // checkmate
+        disproof = PN_INF;
+        store(zobrist, moves_left, proof, disproof);
+        return;
+    }
+    if (moves.size() == 0 || moves_left == 0 || board.state().fifty_move_rule_counter() >= 100U) {
+        proof = PN_INF;   // no checks, stalemate, draw or no moves left to mate
+        disproof = 0U;
+        store(zobrist, moves_left, proof, disproof);
+        return;
+    }
+
+    constexpr bool child_attacker = !attacker;
+    const int child_moves_left = attacker ? moves_left - 1 : moves_left;
+    const GameState game_state = board.state();
+
+    uint32_t child_proof[MAX_CHESS_MOVES];
+    uint32_t child_disproof[MAX_CHESS_MOVES];
+
+    for (int i = 0; i < moves.size(); i++) {
+        board.make_move(moves[i]);
+        if (!lookup(board.state().get_zobrist_key(), child_moves_left, child_proof[i], child_disproof[i])) {
+            child_proof[i] = 1U;
+            child_disproof[i] = 1U;
+        }
+        board.unmake_move(moves[i], game_state);
+    }
+
+    while (true) {
+        // proof and disproof numbers of the node, index of the best child and second best value
+        int best = 0;
+        uint32_t second_best = PN_INF;
+
+        if constexpr (attacker) {
+            proof = PN_INF;
+            disproof = 0U;
+            for (int i = 0; i < moves.size(); i++) {
+                disproof = add_saturated(disproof, child_disproof[i]);
+                if (child_proof[i] < proof) {
+                    second_best = proof;
+                    proof = child_proof[i];
+                    best = i;
+                }
+                else if (child_proof[i] < second_best) {
+                    second_best = child_proof[i];
+                }
+            }
+        }
+        else {
+            proof = 0U;
+            disproof = PN_INF;
+            for (int i = 0; i < moves.size(); i++) {
+                proof = add_saturated(proof, child_proof[i]);
+                if (child_disproof[i] < disproof) {
+                    second_best = disproof;
+                    disproof = child_disproof[i];
+                    best = i;
+                }
+                else if (child_disproof[i] < second_best) {
+                    second_best = child_disproof[i];
+                }
+            }
+        }
+
+        if (proof >= threshold_proof || disproof >= threshold_disproof || stop) {
+            break;
+        }
+
+        uint32_t child_threshold_proof, child_threshold_disproof;
+
+        if constexpr (attacker) {
+            child_threshold_proof = std::min(threshold_proof, add_saturated(second_best, 1U));
+            child_threshold_disproof = threshold_disproof >= PN_INF
+                ? PN_INF
+                : threshold_disproof - disproof + child_disproof[best];
+        }
+        else {
+            child_threshold_disproof = std::min(threshold_disproof, add_saturated(second_best, 1U));
+            child_threshold_proof = threshold_proof >= PN_INF ? PN_INF
+                                                              : threshold_proof - proof + child_proof[best];
+        }
+
+        board.make_move(moves[best]);
+        mid<child_attacker>(stop, board, child_moves_left, child_threshold_proof, child_threshold_disproof,
+                            child_proof[best], child_disproof[best]);
+        board.unmake_move(moves[best], game_state);
+    }
+
+    store(zobrist, moves_left, proof, disproof);
+}
+
+/**
+ * @brief MateSearch::lookup(uint64_t, int, uint32_t&, uint32_t&)
+ *
+ * Reads the proof and disproof numbers of a node in the mate table.
+ *
+ * @param[in] zobrist zobrist key of the position.
+ * @param[in] moves_left moves of the attacker left to give mate.
+ * @param[out] proof proof number.
+ * @param[out] disproof disproof number.
+ *
+ * @return true if the node is in the table.
+ *
+ */
+bool MateSearch::lookup(uint64_t zobrist, int moves_left, uint32_t& proof, uint32_t& disproof)
+{
+    const uint64_t key = zobrist ^ (static_cast<uint64_t>(moves_left) * 0x9E3779B97F4A7C15ULL);
+    const Entry& entry = entries[key & (entries.size() - 1)];
+
+    if (entry.key != key) {
+        return false;
+    }
+
+    proof = entry.proof;
+    disproof = entry.disproof;
+    return true;
+}
+
+/**
+ * @brief MateSearch::store(uint64_t, int, uint32_t, uint32_t)
+ *
+ * Stores the proof and disproof numbers of a node in the mate table, always replace.
+ *
+ * @param[in] zobrist zobrist key of the position.
+ * @param[in] moves_left moves of the attacker left to give mate.
+ * @param[in] proof proof number.
+ * @param[in] disproof disproof number.
+ *
+ */
+void MateSearch::store(uint64_t zobrist, int moves_left, uint32_t proof, uint32_t disproof)
+{
+    const uint64_t key = zobrist ^ (static_cast<uint64_t>(moves_left) * 0x9E3779B97F4A7C15ULL);
+
+    entries[key & (entries.size() - 1)] = Entry{key, proof, disproof};
+}
+
+/**
+ * @brief MateSearch::resize(int)
+ *
+ * resize the mate table, the table is cleared.
+ *
+ * @param[in] size_mb new size of the table in MB, must be power of two
+ *
+ */
+void MateSearch::resize(int size_mb)
+{
+    assert(size_mb > 0 && is_power_of_two(static_cast<uint64_t>(size_mb)));
+
+    const uint64_t num_entries = mb_to_bytes(static_cast<uint64_t>(size_mb)) / sizeof(Entry);
+
+    entries.assign(next_power_of_two(num_entries + 1) >> 1, Entry{0ULL, 0U, 0U});
+}
+
+/**
+ * @brief MateSearch::clear()
+ *
+ * remove all the entries of the mate table.
+ *
+ */
+void MateSearch::clear() { std::fill(entries.begin(), entries.end(), Entry{0ULL, 0U, 0U}); }
+
+/**
+ * @brief MateSearch::initialization()
+ *
+ * @return std::vector<Entry> mate table with the default size
+ *
+ */
+std::vector<MateSearch::Entry> MateSearch::initialization()
+{
+    const uint64_t num_entries = mb_to_bytes(static_cast<uint64_t>(DEFAULT_SIZE_MB)) / sizeof(Entry);
+
+    return std::vector<Entry>(next_power_of_two(num_entries + 1) >> 1, Entry{0ULL, 0U, 0U});
+}
@@ -0,0 +1,95 @@
+/**
+ * @file search.cpp
+ * @brief search services.
+ *
+ * Search with the algorithms selected in AlgorithmSelection. The selection is dispatched once per search to the
+ * template instantiation of the search, evaluation and move generator combination, the search calls the
+ * evaluation and the move generator directly.
+ *
+ */
+
+#include "search.hpp"
+
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void dispatch_search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+
+template<EvaluationAlgorithm evaluation>
+static void dispatch_move_generator(std::atomic<bool>& stop, SearchResults& results, Board& board,
+                                    const SearchLimits& limits);
+
+/**
+ * @brief search(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
+ *
+ * Search the best legal move in the chess position with the search, evaluation and move generator algorithms
+ * selected in AlgorithmSelection.
+ *
+ * @param[in] stop stop search signal.
+ * @param[out] results struct where to store the results.
+ * @param[in] board chess position.
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
+ *
+ */
+void search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits)
+{
+    switch (AlgorithmSelection::evaluation()) {
+    case EvaluationAlgorithm::DYNAMIC:
+        dispatch_move_generator<EvaluationAlgorithm::DYNAMIC>(stop, results, board, limits);
+        break;
+    case EvaluationAlgorithm::SAFETY_MOBILITY:
+        dispatch_move_generator<EvaluationAlgorithm::SAFETY_MOBILITY>(stop, results, board, limits);
+        break;
+    case EvaluationAlgorithm::NNUE:
+        dispatch_move_generator<EvaluationAlgorithm::NNUE>(stop, results, board, limits);
+        break;
+    }
+}
+
+/**
+ * @brief dispatch_move_generator(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
+ *
+ * Dispatch the selected move generator algorithm.
+ *
+ * @tparam evaluation [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ *
+ */
+template<EvaluationAlgorithm evaluation>
+static void dispatch_move_generator(std::atomic<bool>& stop, SearchResults& results, Board& board,
+                                    const SearchLimits& limits)
+{
+    switch (AlgorithmSelection::move_generator()) {
+    case MoveGeneratorAlgorithm::BASIC:
+        dispatch_search<evaluation, MoveGeneratorAlgorithm::BASIC>(stop, results, board, limits);
+        break;
+    case MoveGeneratorAlgorithm::MAGIC_BITBOARDS:
+        dispatch_search<evaluation, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(stop, results, board, limits);
+        break;
+    }
+}
+
+/**
+ * @brief dispatch_search(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
+ *
+ * Dispatch the selected search algorithm.
+ *
+ * @tparam evaluation [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ * @tparam moveGenerator [BASIC, MAGIC_BITBOARDS]
+ *
+ */
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void dispatch_search(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits)
+{
+    switch (AlgorithmSelection::search()) {
+    case SearchAlgorithm::BASIC:
+        search_basic<evaluation, moveGenerator>(stop, results, board, limits);
+        break;
+    case SearchAlgorithm::MULTITHREAD:
+        search_multithread<evaluation, moveGenerator>(stop, results, board, limits);
+        break;
+    case SearchAlgorithm::TRANSPOSITION_TABLE:
+        search_transposition_table<evaluation, moveGenerator>(stop, results, board, limits);
+        break;
+    case SearchAlgorithm::TT_REDUCTIONS:
+        search_tt_reductions<evaluation, moveGenerator>(stop, results, board, limits);
+        break;
+    }
+}
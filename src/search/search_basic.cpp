@@ -13,48 +13,63 @@
 #include "search.hpp"
 #include "move_generator.hpp"
 #include "evaluation.hpp"
+#include "material.hpp"
 #include "move_ordering.hpp"
 #include "move_list.hpp"
 #include "history.hpp"
 #include "killer_moves.hpp"
 
-static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, int max_depth, SearchContext& context);
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, const SearchLimits& limits,
+                                SearchContext& context);
 
-template<SearchType searchType>
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
 static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context);
 
-template<SearchType searchType>
-static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int beta, SearchContext& context);
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int quiescence_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context);
 
 /**
- * @brief search(std::atomic<bool>&, SearchResults&, Board&, int32_t)
+ * @brief search_basic(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
  * 
  * Search the best legal move in the chess position.
  * 
+ * @tparam evaluation [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ * @tparam moveGenerator [BASIC, MAGIC_BITBOARDS]
+ * 
  * @param[in] stop stop search signal.
  * @param[out] results struct where to store the results.
  * @param[in] board chess position.
- * @param[in] max_depth maximum depth of search, default value is INFINITE_DEPTH
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
  * 
  */
-void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint32_t max_depth)
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_basic(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits)
 {
     assert(stop.load() == false);
-    assert(results.depthReached == 0);
 
     SearchContext context(board);
+    context.nodesLimit = limits.nodes;
+    context.timeManager = limits.timeManager;
+
+    context.results = &results;
+
+    start_search_results(results);
 
     const ChessColor side_to_move = board.state().side_to_move();
 
     context.bestEvalFound = is_white(side_to_move) ? -INF_EVAL : +INF_EVAL;
     context.bestMoveFound = Move::null();
 
-    iterative_deepening(stop, results, max_depth, context);
+    iterative_deepening<evaluation, moveGenerator>(stop, results, limits, context);
+
+    // search statistics
+    results.nodes = context.nodes;
 
     if (!context.bestMoveFound.is_valid()) {
         // if none move found choose one
         MoveList moves;
-        generate_legal_moves<ALL_MOVES>(moves, board);
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);
         context.bestMoveFound = moves[0];
         context.bestEvalFound = 0;
         const int depth = 1;
@@ -64,11 +79,27 @@ void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint3
     stop = true;
 
     //notify the reader thread that search has stopped
-    results.data_available_cv.notify_one();
+    notify_search_finished(results);
 }
 
 /**
- * @brief iterative_deepening(SearchResults&,Board&,int,SearchContext)
+ * @brief Explicit instantiations of search_basic for every evaluation and move generator algorithm.
+ */
+template void search_basic<EvaluationAlgorithm::DYNAMIC, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_basic<EvaluationAlgorithm::DYNAMIC, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_basic<EvaluationAlgorithm::SAFETY_MOBILITY, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_basic<EvaluationAlgorithm::SAFETY_MOBILITY, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_basic<EvaluationAlgorithm::NNUE, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_basic<EvaluationAlgorithm::NNUE, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+
+/**
+ * @brief iterative_deepening(std::atomic<bool>&, SearchResults&, const SearchLimits&, SearchContext&)
  * 
  * Realize an iterative search, first at depth 1, then depth 2 ... until max_depth.
  * 
@@ -76,22 +107,33 @@ void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint3
  * 
  * @param[in] stop stop search signal
  * @param[out] results struct where to store the results.
- * @param[in] max_depth maximum depth of search, default value is INFINITE_DEPTH
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
  * @param[in, out] context  board and best moves so far in the search
  * 
  */
-static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, int max_depth, SearchContext& context)
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, const SearchLimits& limits,
+                                SearchContext& context)
 {
     Board& board = context.board;
     const ChessColor side_to_move = board.state().side_to_move();
+    const int max_depth = static_cast<int>(limits.depth);
     KillerMoves::clear();
 
+    // root moves, ordered by move ordering in the first iteration and by the previous results in the rest
+    MoveList root_moves;
+    generate_legal_moves<ALL_MOVES, moveGenerator>(root_moves, board);
+    order_moves(root_moves, board, 0);
+    context.rootMoves.init(root_moves, limits.searchMoves, limits.multiPV);
+
     int alpha = -INF_EVAL;
     int beta = +INF_EVAL;
 
     for (int depth = 1; depth <= max_depth; depth++) {
         context.bestMoveInIteration = Move::null();
         context.bestEvalInIteration = is_white(side_to_move) ? -INF_EVAL : +INF_EVAL;
+        is_white(side_to_move) ? context.rootMoves.new_iteration<MAXIMIZE_WHITE>()
+                               : context.rootMoves.new_iteration<MINIMIZE_BLACK>();
 
         // if it is not the first iteration, adjust alpha and beta
         if (depth > 1) {
@@ -99,16 +141,28 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
             beta  = context.bestEvalFound + ASPIRATION_MARGIN;
         }
 
-        is_white(side_to_move) ? alpha_beta_search<MAXIMIZE_WHITE>(stop, depth, 0, alpha, beta, context)
-                               : alpha_beta_search<MINIMIZE_BLACK>(stop, depth, 0, alpha, beta, context);
+        is_white(side_to_move)
+            ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context)
+            : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context);
 
         // if the evaluation is out of bounds of the window, redo the search with -INF_EVAL and +INF_EVAL
         if (context.bestEvalInIteration <= alpha || context.bestEvalInIteration >= beta) {
+
+            if (!stop && context.bestMoveInIteration.is_valid()) {
+                // report the failed window, lowerbound if the evaluation is better for white
+                const ScoreBound bound = context.bestEvalInIteration >= beta ? ScoreBound::LOWER : ScoreBound::UPPER;
+                results.nodes = context.nodes;
+                results.selDepth = context.selDepth;
+                insert_new_result(results, depth, context.bestEvalInIteration, context.bestMoveInIteration, nullptr, 0,
+                                  1, bound);
+            }
+
             alpha = -INF_EVAL;
             beta  = +INF_EVAL;
 
-            is_white(side_to_move) ? alpha_beta_search<MAXIMIZE_WHITE>(stop, depth, 0, alpha, beta, context)
-                                   : alpha_beta_search<MINIMIZE_BLACK>(stop, depth, 0, alpha, beta, context);
+            is_white(side_to_move)
+                ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context)
+                : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context);
         }
 
         if (stop) {
@@ -120,11 +174,54 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
 
         assert(context.bestMoveFound.is_valid());
 
-        insert_new_result(results, depth, context.bestEvalFound, context.bestMoveFound);
+        is_white(side_to_move) ? context.rootMoves.sort<MAXIMIZE_WHITE>() : context.rootMoves.sort<MINIMIZE_BLACK>();
+
+        results.nodes = context.nodes;
+        results.selDepth = context.selDepth;
+        results.bestMoveNodes = context.rootMoves[0].nodes;
+
+        const SearchStackFrame& root = context.stack[0];
+        insert_new_result(results, depth, context.bestEvalFound, context.bestMoveFound, root.pv, root.pvLength);
+
+        // MultiPV, search the next lines without the best moves of the previous lines. Like the first line they use
+        // the full window, the lines are sorted by score and a fail low bound could not be ordered
+        const int multi_pv = std::min(limits.multiPV, context.rootMoves.size());
+
+        for (int pv_index = 1; pv_index < multi_pv; pv_index++) {
+            context.rootMoves.set_pv_index(pv_index);
+
+            is_white(side_to_move)
+                ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context)
+                : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context);
+
+            if (stop) {
+                break;
+            }
+
+            is_white(side_to_move) ? context.rootMoves.sort<MAXIMIZE_WHITE>() : context.rootMoves.sort<MINIMIZE_BLACK>();
+
+            results.nodes = context.nodes;
+            results.selDepth = context.selDepth;
+
+            const RootMove& line = context.rootMoves[pv_index];
+            insert_new_result(results, depth, line.score, line.move, line.pv, line.pvLength, pv_index + 1);
+        }
+
+        context.rootMoves.set_pv_index(0);
 
         if (abs(context.bestEvalFound) > MATE_THRESHOLD) {
             break;   // We found a checkmate, we stop because we cant find a shorter checkMate
         }
+
+        // soft time limit, there is no time for another iteration
+        if (limits.timeManager != nullptr &&
+            limits.timeManager->stop_after_iteration(
+                context.bestMoveFound, is_white(side_to_move) ? context.bestEvalFound : -context.bestEvalFound,
+                context.rootMoves[0].nodes, context.nodes, context.rootMoves.size())) {
+            break;
+        }
     }
 }
 
@@ -145,7 +242,7 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
   * @return best score possible for black (minimum score), for white (maximum score)
   * 
   */
-template<SearchType searchType>
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
 static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context)
 {
     constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
@@ -154,11 +251,25 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
     Board& board = context.board;
     const uint64_t zobrist_key = board.state().get_zobrist_key();
 
+    context.nodes++;
+    context.selDepth = std::max(context.selDepth, ply);
+
     if (ply > 0) History::push_position(zobrist_key);
 
-    MoveList moves;
+    if (context.poll_stop(stop)) {
+        return 0;   // unwind now, the evaluation of a stopped search is discarded
+    }
+
+    if (ply >= MAX_PLY) {
+        return evaluate_position<evaluation>(board);
+    }
+
+    SearchStackFrame& frame = context.stack[ply];
+    frame.pvLength = 0;
+
+    MoveList& moves = frame.moves;
     bool isCheck;
-    generate_legal_moves<ALL_MOVES>(moves, board, &isCheck);
+    generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board, &isCheck);
     const bool isCheckMate = isCheck && moves.size() == 0;
     const bool isStaleMate = !isCheck && moves.size() == 0;
     const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
@@ -176,20 +287,28 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
     else if (isStaleMate) {
         return 0;
     }
-    else if (ply > 0 && (fify_move_rule_draw || History::threefold_repetition_detected(fifty_move_rule_counter))) {
+    else if (ply > 0 &&
+             (fify_move_rule_draw || History::threefold_repetition_detected(fifty_move_rule_counter) ||
+              is_draw_by_material(board))) {
         return 0;
     }
     else if (isCheck) {
         depth++;   // check extension, never enter quiescence search while in check
     }
     else if (depth == 0) {
-        return quiescence_search<searchType>(stop, ply, alpha, beta, context);
+        return quiescence_search<searchType, evaluation, moveGenerator>(stop, DEPTH_QS_CHECKS, ply, alpha, beta,
+                                                                        context);
     }
 
     int final_node_evaluation = MAXIMIZING_WHITE ? -INF_EVAL : +INF_EVAL;
     const GameState game_state = board.state();
 
-    order_moves(moves, board, ply);
+    if (ply == 0) {
+        context.rootMoves.copy_moves(moves);   // order of the previous iteration
+    }
+    else {
+        order_moves(moves, board, ply);
+    }
 
     for (int i = 0; i < moves.size(); i++) {
 
@@ -198,11 +317,22 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
         }
         constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
 
+        if (ply == 0) {
+            insert_currmove(*context.results, depth, moves[i], i + 1, context.nodes);
+        }
+
+        const uint64_t nodes_before = context.nodes;
+        frame.currentMove = moves[i];
         board.make_move(moves[i]);
-        int eval = alpha_beta_search<nextSearchType>(stop, depth - 1, ply + 1, alpha, beta, context);
+        int eval = alpha_beta_search<nextSearchType, evaluation, moveGenerator>(stop, depth - 1, ply + 1, alpha, beta,
+                                                                                context);
         board.unmake_move(moves[i], game_state);
         History::pop_position();
 
+        if (ply == 0) {
+            context.rootMoves.update(i, eval, context.nodes - nodes_before, context.stack[1]);
+        }
+
         if constexpr (MAXIMIZING_WHITE) {
             if (ply == 0 && eval > context.bestEvalInIteration) {
                 // if we are in the root node update the best move
@@ -210,6 +340,10 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
                 context.bestMoveInIteration = moves[i];
             }
 
+            if (eval > final_node_evaluation) {
+                context.stack.update_pv(ply, moves[i]);
+            }
+
             final_node_evaluation = std::max(final_node_evaluation, eval);
             alpha = std::max(alpha, eval);
 
@@ -227,6 +361,10 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
                 context.bestMoveInIteration = moves[i];
             }
 
+            if (eval < final_node_evaluation) {
+                context.stack.update_pv(ply, moves[i]);
+            }
+
             final_node_evaluation = std::min(final_node_evaluation, eval);
             beta = std::min(beta, eval);
 
@@ -243,7 +381,7 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
 }
 
 /**
-  * @brief quiescence_search(Board&, int, int, int)
+  * @brief quiescence_search(std::atomic<bool>&, int, int, int, int, SearchContext&)
   * 
   * Alpha beta search only considering the capture moves, this is called when we reach the maximum depth
   * and it is paramaunt in order to avoid the 'horizon effect', for example if we stop the search in the
@@ -252,9 +390,13 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
   * The search continues until there are no more capture moves, to also implement cutoffs we first calculate
   * the static evaluation of the position (stand_pat)
   * 
+  * When the side to move is in check there is no stand pat and all the evasions are searched.
+  * At the first quiescence ply (DEPTH_QS_CHECKS) the quiet moves that give check are also searched.
+  * 
   * @tparam searchType [MAXIMIZE_WHITE, MINIMIZE_BLACK]
   * 
   * @param[in] stop  stop search signal
+  * @param[in] depth quiescence depth, DEPTH_QS_CHECKS or DEPTH_QS_NO_CHECKS
   * @param[in] ply   current ply in the tree
   * @param[in] alpha minimum value that the maximizing player(white) can guarantee
   * @param[in] beta  maximum value that the minimizing player(black) can guarantee
@@ -263,65 +405,96 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
   * @return best score possible for black (minimum score possible), for white (maximum score possible)
   * 
   */
-template<SearchType searchType>
-static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int beta, SearchContext& context)
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int quiescence_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context)
 {
     constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
     constexpr bool MINIMIZING_BLACK = searchType == MINIMIZE_BLACK;
+    constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
 
     Board& board = context.board;
     const uint64_t zobrist_key = board.state().get_zobrist_key();
 
+    context.nodes++;
+    context.selDepth = std::max(context.selDepth, ply);
+
+    if (context.poll_stop(stop)) {
+        return 0;   // unwind now, the evaluation of a stopped search is discarded
+    }
+
     const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
     const bool fify_move_rule_draw = fifty_move_rule_counter >= 100U;
 
-    if (History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw) {
+    if (History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw ||
+        is_draw_by_material(board)) {
         return 0;
     }
 
-    int static_evaluation = evaluate_position(board);
-
     if (ply >= MAX_PLY) {
-        return static_evaluation;
+        return evaluate_position<evaluation>(board);
     }
 
-    if constexpr (MAXIMIZING_WHITE) {
-        if (static_evaluation >= beta) {
-            return beta;   // beta cutoff
+    const bool isCheck = board.in_check();
+
+    constexpr int worst_evaluation = MAXIMIZING_WHITE ? -INF_EVAL : +INF_EVAL;
+    int static_evaluation = 0;
+    int final_node_evaluation = worst_evaluation;
+
+    if (!isCheck) {
+        // stand pat, the side to move can choose to not capture
+        static_evaluation = evaluate_position<evaluation>(board, alpha, beta);
+        final_node_evaluation = static_evaluation;
+
+        if constexpr (MAXIMIZING_WHITE) {
+            if (static_evaluation >= beta) {
+                return beta;   // beta cutoff
+            }
+            alpha = std::max(alpha, static_evaluation);
         }
-        alpha = std::max(alpha, static_evaluation);
-    }
-    else if constexpr (MINIMIZING_BLACK) {
-        if (static_evaluation <= alpha) {
-            return alpha;   // Alpha cutoff
+        else if constexpr (MINIMIZING_BLACK) {
+            if (static_evaluation <= alpha) {
+                return alpha;   // Alpha cutoff
+            }
+            beta = std::min(beta, static_evaluation);
         }
-        beta = std::min(beta, static_evaluation);
     }
 
-    MoveList capture_moves;
-    generate_legal_moves<ONLY_CAPTURES>(capture_moves, board);
+    MoveList& moves = context.stack[ply].moves;
 
-    if (capture_moves.size() == 0) {
-        return static_evaluation;   // No captures: return static evaluation
+    if (isCheck) {
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);   // all the evasions
+
+        if (moves.size() == 0) {
+            // we substract ply so checkMate in less moves has a higher score
+            return MAXIMIZING_WHITE ? -(MATE_IN_ONE_SCORE - ply) : MATE_IN_ONE_SCORE - ply;
+        }
+    }
+    else if (depth >= DEPTH_QS_CHECKS) {
+        // captures and quiet checks
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);
+        moves.filter([&board](const Move& move) {
+            return board.move_is_capture(move) || board.move_gives_check(move);
+        });
+    }
+    else {
+        generate_legal_moves<ONLY_CAPTURES, moveGenerator>(moves, board);
     }
 
-    order_moves(capture_moves, board, ply);
+    order_moves(moves, board, ply);
 
     const GameState game_state = board.state();
-    int final_node_evaluation = static_evaluation;
 
-    for (int i = 0; i < capture_moves.size(); i++) {
+    for (int i = 0; i < moves.size(); i++) {
 
         if (stop) {
             return 0;
         }
 
-        constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
-
         History::push_position(zobrist_key);
-        board.make_move(capture_moves[i]);
-        int eval = quiescence_search<nextSearchType>(stop, ply + 1, alpha, beta, context);
-        board.unmake_move(capture_moves[i], game_state);
+        board.make_move(moves[i]);
+        int eval = quiescence_search<nextSearchType, evaluation, moveGenerator>(stop, DEPTH_QS_NO_CHECKS, ply + 1,
+                                                                                alpha, beta, context);
+        board.unmake_move(moves[i], game_state);
         History::pop_position();
 
         if constexpr (MAXIMIZING_WHITE) {
@@ -343,4 +516,5 @@ static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int be
     }
 
     return final_node_evaluation;
-}
\ No newline at end of file
+}
+
@@ -16,6 +16,7 @@
 #include "search.hpp"
 #include "move_generator.hpp"
 #include "evaluation.hpp"
+#include "material.hpp"
 #include "move_ordering.hpp"
 #include "move_list.hpp"
 #include "transposition_table.hpp"
@@ -23,70 +24,94 @@
 #include "killer_moves.hpp"
 #include <thread>
 
-static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, int max_depth, SearchContext& context);
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, const SearchLimits& limits,
+                                SearchContext& context);
 
-template<SearchType searchType>
-static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context, Board board);
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context);
 
-template<SearchType searchType>
-static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int beta, Board& board);
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int quiescence_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context);
 
-static bool get_entry_in_transposition_table(uint64_t zobrist, int depth, int alpha, int beta, int& eval, Move& move);
+static bool get_entry_in_transposition_table(uint64_t zobrist, int depth, int ply, int alpha, int beta, int& eval,
+                                             Move& move);
+
+template<EvaluationAlgorithm evaluation>
+static int get_static_evaluation(Board& board, uint64_t zobrist, int alpha, int beta, bool* lazyExit = nullptr);
 
 /**
- * @brief search(std::atomic<bool>&, SearchResults&, Board&, int32_t)
+ * @brief search_multithread(std::atomic<bool>&, SearchResults&, Board&, const SearchLimits&)
  * 
  * Search the best legal move in the chess position.
  * 
+ * @tparam evaluation [DYNAMIC, SAFETY_MOBILITY, NNUE]
+ * @tparam moveGenerator [BASIC, MAGIC_BITBOARDS]
+ * 
  * @param[in] stop stop search signal.
  * @param[out] results struct where to store the results.
  * @param[in] board chess position.
- * @param[in] max_depth maximum depth of search, default value is INFINITE_DEPTH
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
  * 
  */
-void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint32_t max_depth)
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+void search_multithread(std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits)
 {
     assert(stop == false);
-    assert(results.depthReached == 0);
 
     SearchContext context(board);
+    context.nodesLimit = limits.nodes;
+    context.timeManager = limits.timeManager;
+
+    context.results = &results;
+
+    start_search_results(results);
 
     const ChessColor side_to_move = board.state().side_to_move();
 
     context.bestEvalFound = is_white(side_to_move) ? -INF_EVAL : +INF_EVAL;
     context.bestMoveFound = Move::null();
 
-    iterative_deepening(stop, results, max_depth, context);
+    iterative_deepening<evaluation, moveGenerator>(stop, results, limits, context);
+
+    // search statistics
+    results.nodes = context.nodes;
 
     if (!context.bestMoveFound.is_valid()) {
         // if none move found choose one
         MoveList moves;
-        generate_legal_moves<ALL_MOVES>(moves, board);
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);
         context.bestMoveFound = moves[0];
         context.bestEvalFound = 0;
         const int depth = 1;
         insert_new_result(results, depth, context.bestEvalFound, context.bestMoveFound);
     }
 
-    // store ponder move
-    const GameState state = board.state();
-    board.make_move(context.bestMoveFound);
-    const Move ponder_move_tt = TranspositionTable::get_entry(board.state().get_zobrist_key()).move;
-
-    results.ponderMove_data = ponder_move_tt.raw_data();
-    assert(ponder_move_tt.is_valid());
-
-    board.unmake_move(context.bestMoveFound, state);
-
     // stop signal
     stop = true;
 
     // notify the reader thread that search has stopped
-    results.data_available_cv.notify_one();
+    notify_search_finished(results);
 }
 
 /**
- * @brief iterative_deepening(SearchResults&,Board&,int,SearchContext)
+ * @brief Explicit instantiations of search_multithread for every evaluation and move generator algorithm.
+ */
+template void search_multithread<EvaluationAlgorithm::DYNAMIC, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_multithread<EvaluationAlgorithm::DYNAMIC, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_multithread<EvaluationAlgorithm::SAFETY_MOBILITY, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_multithread<EvaluationAlgorithm::SAFETY_MOBILITY, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_multithread<EvaluationAlgorithm::NNUE, MoveGeneratorAlgorithm::BASIC>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+template void search_multithread<EvaluationAlgorithm::NNUE, MoveGeneratorAlgorithm::MAGIC_BITBOARDS>(
+    std::atomic<bool>& stop, SearchResults& results, Board& board, const SearchLimits& limits);
+
+/**
+ * @brief iterative_deepening(std::atomic<bool>&, SearchResults&, const SearchLimits&, SearchContext&)
  * 
  * Realize an iterative search, first at depth 1, then depth 2 ... until max_depth.
  * 
@@ -94,23 +119,34 @@ void search(std::atomic<bool>& stop, SearchResults& results, Board& board, uint3
  * 
  * @param[in] stop stop search signal
  * @param[out] results struct where to store the results.
- * @param[in] max_depth maximum depth of search, default value is INFINITE_DEPTH
+ * @param[in] limits maximum depth, number of principal variations (MultiPV) and root moves to search
  * @param[in, out] context  board and best moves so far in the search
  * 
  */
-static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, int max_depth, SearchContext& context)
+template<EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results, const SearchLimits& limits,
+                                SearchContext& context)
 {
     Board& board = context.board;
     const ChessColor side_to_move = board.state().side_to_move();
+    const int max_depth = static_cast<int>(limits.depth);
     KillerMoves::clear();
 
+    // root moves, ordered by move ordering in the first iteration and by the previous results in the rest
+    MoveList root_moves;
+    generate_legal_moves<ALL_MOVES, moveGenerator>(root_moves, board);
+    order_moves(root_moves, board, 0);
+    context.rootMoves.init(root_moves, limits.searchMoves, limits.multiPV);
+
     int alpha = -INF_EVAL;
     int beta = +INF_EVAL;
-    int eval = 0;
+    [[maybe_unused]] int eval = 0;
 
     for (int depth = 1; depth <= max_depth; depth++) {
         context.bestMoveInIteration = Move::null();
         context.bestEvalInIteration = is_white(side_to_move) ? -INF_EVAL : +INF_EVAL;
+        is_white(side_to_move) ? context.rootMoves.new_iteration<MAXIMIZE_WHITE>()
+                               : context.rootMoves.new_iteration<MINIMIZE_BLACK>();
 
         // Set aspiration window for depths > 1 using the previous iteration's score
         /*if (depth > 1) {
@@ -118,8 +154,9 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
             beta = eval + ASPIRATION_MARGIN;
         }*/
 
-        eval = is_white(side_to_move) ? alpha_beta_search<MAXIMIZE_WHITE>(stop, depth, 0, alpha, beta, context, board)
-                                      : alpha_beta_search<MINIMIZE_BLACK>(stop, depth, 0, alpha, beta, context, board);
+        eval = is_white(side_to_move)
+            ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context)
+            : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, alpha, beta, context);
 
         if (stop) {
             break;
@@ -130,8 +167,10 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
             // Re-search with full window to get the exact score
 
             eval = is_white(side_to_move)
-                ? alpha_beta_search<MAXIMIZE_WHITE>(stop, depth, 0, -INF_EVAL, +INF_EVAL, context, board)
-                : alpha_beta_search<MINIMIZE_BLACK>(stop, depth, 0, -INF_EVAL, +INF_EVAL, context, board);
+                ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context)
+                : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context);
         }*/
 
         context.bestMoveFound = context.bestMoveInIteration;
@@ -139,11 +178,54 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
 
         assert(context.bestMoveFound.is_valid());
 
-        insert_new_result(results, depth, context.bestEvalFound, context.bestMoveFound);
+        is_white(side_to_move) ? context.rootMoves.sort<MAXIMIZE_WHITE>() : context.rootMoves.sort<MINIMIZE_BLACK>();
+
+        results.nodes = context.nodes;
+        results.selDepth = context.selDepth;
+        results.bestMoveNodes = context.rootMoves[0].nodes;
+
+        const SearchStackFrame& root = context.stack[0];
+        insert_new_result(results, depth, context.bestEvalFound, context.bestMoveFound, root.pv, root.pvLength);
+
+        // MultiPV, search the next lines without the best moves of the previous lines. Like the first line they use
+        // the full window, the lines are sorted by score and a fail low bound could not be ordered
+        const int multi_pv = std::min(limits.multiPV, context.rootMoves.size());
+
+        for (int pv_index = 1; pv_index < multi_pv; pv_index++) {
+            context.rootMoves.set_pv_index(pv_index);
+
+            is_white(side_to_move)
+                ? alpha_beta_search<MAXIMIZE_WHITE, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context)
+                : alpha_beta_search<MINIMIZE_BLACK, evaluation, moveGenerator>(stop, depth, 0, -INF_EVAL, +INF_EVAL,
+                                                                               context);
+
+            if (stop) {
+                break;
+            }
+
+            is_white(side_to_move) ? context.rootMoves.sort<MAXIMIZE_WHITE>() : context.rootMoves.sort<MINIMIZE_BLACK>();
+
+            results.nodes = context.nodes;
+            results.selDepth = context.selDepth;
+
+            const RootMove& line = context.rootMoves[pv_index];
+            insert_new_result(results, depth, line.score, line.move, line.pv, line.pvLength, pv_index + 1);
+        }
+
+        context.rootMoves.set_pv_index(0);
 
         if (abs(context.bestEvalFound) > MATE_THRESHOLD) {
             break;   // We found a checkmate, we stop because we cant find a shorter checkMate
         }
+
+        // soft time limit, there is no time for another iteration
+        if (limits.timeManager != nullptr &&
+            limits.timeManager->stop_after_iteration(
+                context.bestMoveFound, is_white(side_to_move) ? context.bestEvalFound : -context.bestEvalFound,
+                context.rootMoves[0].nodes, context.nodes, context.rootMoves.size())) {
+            break;
+        }
     }
 }
 
@@ -164,31 +246,48 @@ static void iterative_deepening(std::atomic<bool>& stop, SearchResults& results,
   * @return best score possible for black (minimum score), for white (maximum score)
   * 
   */
-template<SearchType searchType>
-static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context, Board board)
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context)
 {
     constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
     constexpr bool MINIMIZING_BLACK = searchType == MINIMIZE_BLACK;
 
+    Board& board = context.board;
     const uint64_t zobrist_key = board.state().get_zobrist_key();
 
+    context.nodes++;
+    context.selDepth = std::max(context.selDepth, ply);
+
     if (ply > 0) History::push_position(zobrist_key);
 
-    // check transposition table
-    if (ply == 0) {
+    if (context.poll_stop(stop)) {
+        return 0;   // unwind now, the evaluation of a stopped search is discarded
+    }
+
+    if (ply >= MAX_PLY) {
+        return evaluate_position<evaluation>(board);
+    }
+
+    SearchStackFrame& frame = context.stack[ply];
+    frame.pvLength = 0;
+
+    // check transposition table, only if the root is not restricted by searchmoves or MultiPV
+    if (ply == 0 && context.rootMoves.searching_all_moves()) {
         int eval_tt;
         Move move_tt;
-        if (get_entry_in_transposition_table(zobrist_key, depth, alpha, beta, eval_tt, move_tt)) {
+        if (get_entry_in_transposition_table(zobrist_key, depth, ply, alpha, beta, eval_tt, move_tt)) {
             // std::lock_guard<std::mutex> lock(context.context_mutex);
             context.bestEvalInIteration = eval_tt;
             context.bestMoveInIteration = move_tt;
+            frame.pv[0] = move_tt;
+            frame.pvLength = 1;
             return eval_tt;
         }
     }
 
-    MoveList moves;
+    MoveList& moves = frame.moves;
     bool isCheck;
-    generate_legal_moves<ALL_MOVES>(moves, board, &isCheck);
+    generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board, &isCheck);
     const bool isCheckMate = isCheck && moves.size() == 0;
     const bool isStaleMate = !isCheck && moves.size() == 0;
     const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
@@ -206,11 +305,14 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
     else if (isStaleMate) {
         return 0;
     }
-    else if (ply > 0 && (fify_move_rule_draw || History::threefold_repetition_detected(fifty_move_rule_counter))) {
+    else if (ply > 0 &&
+             (fify_move_rule_draw || History::threefold_repetition_detected(fifty_move_rule_counter) ||
+              is_draw_by_material(board))) {
         return 0;
     }
     else if (depth == 0) {
-        return quiescence_search<searchType>(stop, ply, alpha, beta, board);
+        return quiescence_search<searchType, evaluation, moveGenerator>(stop, DEPTH_QS_CHECKS, ply, alpha, beta,
+                                                                        context);
     }
 
     TranspositionTable::NodeType node_tt = TranspositionTable::NodeType::EXACT;
@@ -221,7 +323,12 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
 
     const GameState game_state = board.state();
 
-    order_moves(moves, board, ply);
+    if (ply == 0) {
+        context.rootMoves.copy_moves(moves);   // order of the previous iteration
+    }
+    else {
+        order_moves(moves, board, ply);
+    }
 
     if (stop) {
         return 0;
@@ -230,11 +337,22 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
     constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
 
     // Search the first move sequentially
+    if (ply == 0) {
+        insert_currmove(*context.results, depth, moves[0], 1, context.nodes);
+    }
+
+    const uint64_t nodes_before = context.nodes;
+    frame.currentMove = moves[0];
     board.make_move(moves[0]);
-    int eval = alpha_beta_search<nextSearchType>(stop, depth - 1, ply + 1, alpha, beta, context, board);
+    int eval =
+        alpha_beta_search<nextSearchType, evaluation, moveGenerator>(stop, depth - 1, ply + 1, alpha, beta, context);
     board.unmake_move(moves[0], game_state);
     History::pop_position();
 
+    if (ply == 0) {
+        context.rootMoves.update(0, eval, context.nodes - nodes_before, context.stack[1]);
+    }
+
     std::thread thread;
 
     if constexpr (MAXIMIZING_WHITE) {
@@ -242,6 +360,7 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
         if (eval > best_eval_for_tt) {
             best_eval_for_tt = eval;
             best_move_for_tt = moves[0];
+            context.stack.update_pv(ply, moves[0]);
         }
 
         // std::lock_guard<std::mutex> lock(context.context_mutex);
@@ -266,6 +385,7 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
         if (eval < best_eval_for_tt) {
             best_eval_for_tt = eval;
             best_move_for_tt = moves[0];
+            context.stack.update_pv(ply, moves[0]);
         }
 
         // std::lock_guard<std::mutex> lock(context.context_mutex);
@@ -295,16 +415,28 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
 
             constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
 
+            if (ply == 0) {
+                insert_currmove(*context.results, depth, moves[i], i + 1, context.nodes);
+            }
+
+            const uint64_t nodes_before = context.nodes;
+            frame.currentMove = moves[i];
             board.make_move(moves[i]);
-            int eval = alpha_beta_search<nextSearchType>(stop, depth - 1, ply + 1, alpha, beta, context, board);
+            int eval = alpha_beta_search<nextSearchType, evaluation, moveGenerator>(stop, depth - 1, ply + 1, alpha,
+                                                                                    beta, context);
             board.unmake_move(moves[i], game_state);
             History::pop_position();
 
+            if (ply == 0) {
+                context.rootMoves.update(i, eval, context.nodes - nodes_before, context.stack[1]);
+            }
+
             if constexpr (MAXIMIZING_WHITE) {
 
                 if (eval > best_eval_for_tt) {
                     best_eval_for_tt = eval;
                     best_move_for_tt = moves[i];
+                    context.stack.update_pv(ply, moves[i]);
                 }
 
                 // std::lock_guard<std::mutex> lock(context.context_mutex);
@@ -329,6 +461,7 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
                 if (eval < best_eval_for_tt) {
                     best_eval_for_tt = eval;
                     best_move_for_tt = moves[i];
+                    context.stack.update_pv(ply, moves[i]);
                 }
 
                 // std::lock_guard<std::mutex> lock(context.context_mutex);
@@ -356,15 +489,20 @@ static int alpha_beta_search(std::atomic<bool>& stop, int depth, int ply, int al
     }
 
 end_search:
-    if (best_move_for_tt.is_valid()) {
-        TranspositionTable::store_entry(zobrist_key, best_eval_for_tt, best_move_for_tt, node_tt, depth);
+    if (stop) {
+        return 0;   // aborted search, the evaluation is not valid and must not be stored in the tt
+    }
+
+    if (best_move_for_tt.is_valid() && (ply > 0 || context.rootMoves.searching_all_moves())) {
+        TranspositionTable::store_entry(zobrist_key, score_to_tt(best_eval_for_tt, ply), best_move_for_tt, node_tt,
+                                        depth);
     }
 
     return final_node_evaluation;
 }
 
 /**
-  * @brief quiescence_search(Board&, int, int, int)
+  * @brief quiescence_search(std::atomic<bool>&, int, int, int, int, SearchContext&)
   * 
   * Alpha beta search only considering the capture moves, this is called when we reach the maximum depth
   * and it is paramaunt in order to avoid the 'horizon effect', for example if we stop the search in the
@@ -373,9 +511,15 @@ end_search:
   * The search continues until there are no more capture moves, to also implement cutoffs we first calculate
   * the static evaluation of the position (stand_pat)
   * 
+  * When the side to move is in check there is no stand pat and all the evasions are searched.
+  * At the first quiescence ply (DEPTH_QS_CHECKS) the quiet moves that give check are also searched.
+  * Positions are probed and stored in the transposition table at the quiescence depth, the stored static
+  * evaluation is reused.
+  * 
   * @tparam searchType [MAXIMIZE_WHITE, MINIMIZE_BLACK]
   * 
   * @param[in] stop  stop search signal
+  * @param[in] depth quiescence depth, DEPTH_QS_CHECKS or DEPTH_QS_NO_CHECKS
   * @param[in] ply   current ply in the tree
   * @param[in] alpha minimum value that the maximizing player(white) can guarantee
   * @param[in] beta  maximum value that the minimizing player(black) can guarantee
@@ -384,67 +528,125 @@ end_search:
   * @return best score possible for black (minimum score possible), for white (maximum score possible)
   * 
   */
-template<SearchType searchType>
-static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int beta, Board& board)
+template<SearchType searchType, EvaluationAlgorithm evaluation, MoveGeneratorAlgorithm moveGenerator>
+static int quiescence_search(std::atomic<bool>& stop, int depth, int ply, int alpha, int beta, SearchContext& context)
 {
     constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
     constexpr bool MINIMIZING_BLACK = searchType == MINIMIZE_BLACK;
+    constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
 
+    Board& board = context.board;
     const uint64_t zobrist_key = board.state().get_zobrist_key();
 
+    context.nodes++;
+    context.selDepth = std::max(context.selDepth, ply);
+
+    if (context.poll_stop(stop)) {
+        return 0;   // unwind now, the evaluation of a stopped search is discarded
+    }
+
     const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
     const bool fify_move_rule_draw = fifty_move_rule_counter >= 100U;
 
-    if (History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw) {
+    if (History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw ||
+        is_draw_by_material(board)) {
         return 0;
     }
 
-    int static_evaluation = evaluate_position(board);
+    // check transposition table
+    int eval_tt;
+    Move move_tt;
+    if (get_entry_in_transposition_table(zobrist_key, depth, ply, alpha, beta, eval_tt, move_tt)) {
+        return eval_tt;
+    }
+
+    const int original_alpha = alpha;
+    const int original_beta = beta;
 
     if (ply >= MAX_PLY) {
-        return static_evaluation;
+        return evaluate_position<evaluation>(board);
     }
 
-    if constexpr (MAXIMIZING_WHITE) {
-        if (static_evaluation >= beta) {
-            return beta;   // beta cutoff
+    const bool isCheck = board.in_check();
+
+    constexpr int worst_evaluation = MAXIMIZING_WHITE ? -INF_EVAL : +INF_EVAL;
+    int static_evaluation = TranspositionTable::NO_STATIC_EVAL;
+    int tt_static_evaluation = TranspositionTable::NO_STATIC_EVAL;   // none if the evaluation is only a bound
+    int final_node_evaluation = worst_evaluation;
+
+    if (!isCheck) {
+        // stand pat, the side to move can choose to not capture
+        bool lazy_exit;
+        static_evaluation = get_static_evaluation<evaluation>(board, zobrist_key, alpha, beta, &lazy_exit);
+        final_node_evaluation = static_evaluation;
+
+        if (!lazy_exit) {
+            tt_static_evaluation = static_evaluation;
         }
-        alpha = std::max(alpha, static_evaluation);
-    }
-    else if constexpr (MINIMIZING_BLACK) {
-        if (static_evaluation <= alpha) {
-            return alpha;   // Alpha cutoff
+
+        if constexpr (MAXIMIZING_WHITE) {
+            if (static_evaluation >= beta) {
+                TranspositionTable::store_quiescence_entry(zobrist_key, score_to_tt(static_evaluation, ply),
+                                                           Move::null(), TranspositionTable::NodeType::LOWER_BOUND,
+                                                           depth, tt_static_evaluation);
+                return beta;   // beta cutoff
+            }
+            alpha = std::max(alpha, static_evaluation);
+        }
+        else if constexpr (MINIMIZING_BLACK) {
+            if (static_evaluation <= alpha) {
+                TranspositionTable::store_quiescence_entry(zobrist_key, score_to_tt(static_evaluation, ply),
+                                                           Move::null(), TranspositionTable::NodeType::UPPER_BOUND,
+                                                           depth, tt_static_evaluation);
+                return alpha;   // Alpha cutoff
+            }
+            beta = std::min(beta, static_evaluation);
         }
-        beta = std::min(beta, static_evaluation);
     }
 
-    MoveList capture_moves;
-    generate_legal_moves<ONLY_CAPTURES>(capture_moves, board);
+    MoveList& moves = context.stack[ply].moves;
+
+    if (isCheck) {
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);   // all the evasions
 
-    if (capture_moves.size() == 0) {
-        return static_evaluation;   // No captures: return static evaluation
+        if (moves.size() == 0) {
+            // we substract ply so checkMate in less moves has a higher score
+            return MAXIMIZING_WHITE ? -(MATE_IN_ONE_SCORE - ply) : MATE_IN_ONE_SCORE - ply;
+        }
+    }
+    else if (depth >= DEPTH_QS_CHECKS) {
+        // captures and quiet checks
+        generate_legal_moves<ALL_MOVES, moveGenerator>(moves, board);
+        moves.filter([&board](const Move& move) {
+            return board.move_is_capture(move) || board.move_gives_check(move);
+        });
+    }
+    else {
+        generate_legal_moves<ONLY_CAPTURES, moveGenerator>(moves, board);
     }
 
-    order_moves(capture_moves, board, ply);
+    order_moves(moves, board, ply);
 
     const GameState game_state = board.state();
-    int final_node_evaluation = static_evaluation;
+    Move best_move_for_tt = Move::null();
 
-    for (int i = 0; i < capture_moves.size(); i++) {
+    for (int i = 0; i < moves.size(); i++) {
 
         if (stop) {
             return 0;
         }
 
-        constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
-
         History::push_position(zobrist_key);
-        board.make_move(capture_moves[i]);
-        int eval = quiescence_search<nextSearchType>(stop, ply + 1, alpha, beta, board);
-        board.unmake_move(capture_moves[i], game_state);
+        board.make_move(moves[i]);
+        int eval = quiescence_search<nextSearchType, evaluation, moveGenerator>(stop, DEPTH_QS_NO_CHECKS, ply + 1,
+                                                                                alpha, beta, context);
+        board.unmake_move(moves[i], game_state);
         History::pop_position();
 
         if constexpr (MAXIMIZING_WHITE) {
+            if (eval > final_node_evaluation) {
+                best_move_for_tt = moves[i];
+            }
             final_node_evaluation = std::max(final_node_evaluation, eval);
             alpha = std::max(alpha, eval);
 
@@ -453,6 +655,9 @@ static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int be
             }
         }
         else if constexpr (MINIMIZING_BLACK) {
+            if (eval < final_node_evaluation) {
+                best_move_for_tt = moves[i];
+            }
             final_node_evaluation = std::min(final_node_evaluation, eval);
             beta = std::min(beta, eval);
 
@@ -462,6 +667,22 @@ static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int be
         }
     }
 
+    if (stop) {
+        return 0;   // aborted search, the evaluation is not valid and must not be stored in the tt
+    }
+
+    TranspositionTable::NodeType node_tt = TranspositionTable::NodeType::EXACT;
+
+    if (final_node_evaluation >= original_beta) {
+        node_tt = TranspositionTable::NodeType::LOWER_BOUND;
+    }
+    else if (final_node_evaluation <= original_alpha) {
+        node_tt = TranspositionTable::NodeType::UPPER_BOUND;
+    }
+
+    TranspositionTable::store_quiescence_entry(zobrist_key, score_to_tt(final_node_evaluation, ply), best_move_for_tt,
+                                               node_tt, depth, tt_static_evaluation);
+
     return final_node_evaluation;
 }
 
@@ -480,11 +701,12 @@ static int quiescence_search(std::atomic<bool>& stop, int ply, int alpha, int be
  * @return True if Entry in the tt is valid
  * 
  */
-static bool get_entry_in_transposition_table(uint64_t zobrist, int depth, int alpha, int beta, int& eval, Move& move)
+static bool get_entry_in_transposition_table(uint64_t zobrist, int depth, int ply, int alpha, int beta, int& eval,
+                                             Move& move)
 {
     const TranspositionTable::Entry entry = TranspositionTable::get_entry(zobrist);
 
-    eval = entry.evaluation;
+    eval = score_from_tt(entry.evaluation, ply);
     move = entry.move;
 
     if (!entry.is_valid() || entry.node_type == TranspositionTable::NodeType::PERFT) {
@@ -501,12 +723,39 @@ static bool get_entry_in_transposition_table(uint64_t zobrist, int depth, int al
         break;
     case TranspositionTable::NodeType::UPPER_BOUND:
         // entry with upper bound evaluation, only valid if eval less than alpha
-        return entry.evaluation <= alpha ? true : false;
+        return eval <= alpha ? true : false;
         break;
     case TranspositionTable::NodeType::LOWER_BOUND:
         // entry with lower bound evaluation, only valid if eval more than beta
-        return entry.evaluation >= beta ? true : false;
+        return eval >= beta ? true : false;
         break;
     default: return false; break;
     }
-}
\ No newline at end of file
+}
+
+/**
+  * @brief Reads the static evaluation stored in the transposition table, evaluates the position if there is none
+  * 
+  * @param[in] board chess position
+  * @param[in] zobrist hash key of the position
+  * @param[in] alpha lower bound of the window, a lazy evaluation outside the window is only a bound
+  * @param[in] beta upper bound of the window
+  * @param[out] lazyExit (optional) return true if the evaluation exited lazily, the bound must not be stored in the tt
+  * 
+  * @return static evaluation of the position
+  * 
+  */
+template<EvaluationAlgorithm evaluation>
+static int get_static_evaluation(Board& board, uint64_t zobrist, int alpha, int beta, bool* lazyExit)
+{
+    const TranspositionTable::Entry entry = TranspositionTable::get_entry(zobrist);
+
+    if (entry.is_valid() && entry.static_eval != TranspositionTable::NO_STATIC_EVAL) {
+        if (lazyExit) {
+            *lazyExit = false;
+        }
+        return entry.static_eval;
+    }
+
+    return evaluate_position<evaluation>(board, alpha, beta, lazyExit);
+}
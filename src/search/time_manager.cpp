@@ -0,0 +1,155 @@
+/**
+ * @file time_manager.cpp
+ * @brief time manager implementation.
+ *
+ * https://www.chessprogramming.org/Time_Management
+ *
+ */
+
+#include "time_manager.hpp"
+#include <algorithm>
+
+/**
+ * @brief moves to go assumed in sudden death
+ */
+static constexpr uint32_t SUDDEN_DEATH_MOVES_TO_GO = 40U;
+
+/**
+ * @brief max moves to go used to split the remaining time
+ */
+static constexpr uint32_t MAX_MOVES_TO_GO = 50U;
+
+/**
+ * @brief the maximum time is at most this number of optimum times
+ */
+static constexpr double MAX_TIME_RATIO = 5.0;
+
+/**
+ * @brief the maximum time never uses more than this fraction of the remaining time
+ */
+static constexpr double MAX_TIME_FRACTION = 0.8;
+
+/**
+ * @brief the next iteration takes longer than all the previous ones, do not start it after this fraction of the
+ *        soft limit
+ */
+static constexpr double NEXT_ITERATION_RATIO = 0.5;
+
+/**
+ * @brief init(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, bool)
+ *
+ * Calculate the optimum and maximum time of the move, the clock starts now (or on ponderhit).
+ *
+ * The remaining time plus the expected increments is split between the moves to go, the time
+ * reserved for the move overhead is discounted in every move.
+ *
+ * @param[in] time remaining time of the side to move (ms), 0 if not provided.
+ * @param[in] increment increment per move of the side to move (ms).
+ * @param[in] moves_to_go moves until the next time control, 0 in sudden death.
+ * @param[in] movetime explicit think time (ms), 0 if not provided.
+ * @param[in] move_overhead time reserved for the communication with the gui (ms).
+ * @param[in] ponder true if the search starts pondering, the clock starts on ponderhit.
+ *
+ */
+void TimeManager::init(uint32_t time, uint32_t increment, uint32_t moves_to_go, uint32_t movetime,
+                       uint32_t move_overhead, bool ponder)
+{
+    startTime = now();
+    pondering = ponder;
+
+    previousBestMove = Move::null();
+    previousEvaluation = 0;
+    bestMoveChanges = 0.0;
+    iterations = 0;
+
+    if (movetime != 0U) {
+        // think time is explicitly provided
+        fixedTime = true;
+        optimumTime = maximumTime = std::max<int64_t>(int64_t(movetime) - int64_t(move_overhead), 1);
+        return;
+    }
+
+    fixedTime = false;
+
+    const int64_t mtg = moves_to_go != 0U ? std::min(moves_to_go, MAX_MOVES_TO_GO) : SUDDEN_DEATH_MOVES_TO_GO;
+
+    // time for the rest of the moves until the time control, keeping the overhead of each move
+    const int64_t budget = std::max<int64_t>(
+        int64_t(time) + int64_t(increment) * (mtg - 1) - int64_t(move_overhead) * (mtg + 1), 1);
+
+    // never use more than a fraction of the clock in one move, so the side to move can not lose on time
+    const int64_t max_by_clock = std::max<int64_t>(int64_t(time * MAX_TIME_FRACTION) - int64_t(move_overhead), 1);
+
+    const int64_t optimum = budget / mtg;
+
+    maximumTime = static_cast<uint64_t>(std::min<int64_t>(int64_t(optimum * MAX_TIME_RATIO), max_by_clock));
+    maximumTime = std::max<uint64_t>(maximumTime, 1ULL);
+    optimumTime = std::clamp<uint64_t>(static_cast<uint64_t>(optimum), 1ULL, maximumTime);
+}
+
+/**
+ * @brief ponderhit()
+ *
+ * The opponent played the expected move, restart the clock and apply the time limits.
+ *
+ */
+void TimeManager::ponderhit()
+{
+    startTime = now();
+    pondering = false;
+}
+
+/**
+ * @brief stop_after_iteration(Move, int, uint64_t, uint64_t, int)
+ *
+ * Called after every completed iteration, updates the best move stability and decides if
+ * there is time for another iteration.
+ *
+ * The optimum time is scaled by:
+ *      - best move changes in the last iterations (unstable search, more time).
+ *      - evaluation drop since the previous iteration (more time).
+ *      - share of the nodes spent in the best move (easy move, less time).
+ *
+ * @param[in] best_move best move of the iteration.
+ * @param[in] evaluation evaluation of the iteration from the point of view of the side to move.
+ * @param[in] best_move_nodes nodes spent in the best root move.
+ * @param[in] nodes nodes of the search.
+ * @param[in] num_root_moves number of legal moves in the root.
+ *
+ * @return true if the search should stop.
+ *
+ */
+bool TimeManager::stop_after_iteration(Move best_move, int evaluation, uint64_t best_move_nodes, uint64_t nodes,
+                                       int num_root_moves)
+{
+    iterations++;
+
+    // the changes of the older iterations lose weight
+    bestMoveChanges = bestMoveChanges * 0.5 + (iterations > 1 && best_move != previousBestMove ? 1.0 : 0.0);
+
+    const int evaluation_drop = iterations > 1 ? previousEvaluation - evaluation : 0;
+
+    previousBestMove = best_move;
+    previousEvaluation = evaluation;
+
+    if (pondering) {
+        return false;   // the time limits apply after ponderhit
+    }
+
+    if (num_root_moves == 1) {
+        return true;   // only one legal move, do not waste time
+    }
+
+    if (fixedTime) {
+        return false;   // movetime, search until the hard limit
+    }
+
+    const double instability = 1.0 + 1.5 * bestMoveChanges;
+    const double falling_eval = std::clamp(1.0 + 0.005 * evaluation_drop, 0.75, 1.5);
+    const double best_move_share = nodes != 0ULL ? double(best_move_nodes) / double(nodes) : 0.0;
+    const double node_effort = std::clamp(1.25 - 0.75 * best_move_share, 0.5, 1.25);
+
+    const double soft_limit = double(optimumTime) * instability * falling_eval * node_effort;
+
+    return double(elapsed()) >= std::min(soft_limit * NEXT_ITERATION_RATIO, double(maximumTime));
+}
@@ -0,0 +1,109 @@
+/**
+ * @file batch_evaluator.cpp
+ * @brief batch evaluator tool.
+ *
+ * Label positions with the batch material and PST evaluation and report its throughput.
+ *
+ * Usage: BatchEvaluator <positions> [output]
+ *
+ * Positions: one position per line, the FEN is the text before the first ';' so datasets can be labelled directly.
+ * Output: one evaluation per line in centipawns from the white point of view, nothing is written without output.
+ *
+ */
+
+#include "batch_evaluation.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// the evaluation is repeated until it takes this long, to measure small files
+static constexpr double MIN_MEASURE_SECONDS = 0.5;
+
+template<typename Function>
+static double positions_per_second(size_t num_positions, Function function);
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: BatchEvaluator <positions> [output]\n";
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        std::cerr << "Can not open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<CompactPosition> positions;
+    std::string line;
+    Board board;
+
+    while (std::getline(input, line)) {
+        try {
+            board.load_fen(line.substr(0, line.find(';')));
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid position: " << line << "\n";
+            return 1;
+        }
+        positions.push_back(CompactPosition::from_board(board));
+    }
+
+    std::vector<int> evaluations(positions.size());
+
+    const double batch_speed = positions_per_second(positions.size(), [&]() {
+        BatchEvaluation::evaluate(positions.data(), positions.size(), evaluations.data());
+    });
+
+    const double single_speed = positions_per_second(positions.size(), [&]() {
+        for (size_t i = 0; i < positions.size(); i++) {
+            evaluations[i] = BatchEvaluation::evaluate(positions[i]);
+        }
+    });
+
+    BatchEvaluation::evaluate(positions.data(), positions.size(), evaluations.data());
+
+    std::cout << "positions " << positions.size() << "\n"
+              << "batch positions/s " << static_cast<uint64_t>(batch_speed) << "\n"
+              << "single positions/s " << static_cast<uint64_t>(single_speed) << std::endl;
+
+    if (argc == 3) {
+        std::ofstream output(argv[2]);
+        for (const int evaluation : evaluations) {
+            output << evaluation << "\n";
+        }
+        if (!output) {
+            std::cerr << "Can not write " << argv[2] << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief positions_per_second(size_t, Function)
+ *
+ * @param[in] num_positions positions evaluated by each call of function.
+ * @param[in] function evaluation of all the positions.
+ *
+ * @return (double) positions evaluated per second.
+ *
+ */
+template<typename Function>
+static double positions_per_second(size_t num_positions, Function function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    uint64_t repetitions = 0ULL;
+
+    do {
+        function();
+        repetitions++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_MEASURE_SECONDS && num_positions > 0U);
+
+    return double(num_positions) * double(repetitions) / std::max(seconds, 1e-9);
+}
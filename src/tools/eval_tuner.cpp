@@ -0,0 +1,665 @@
+/**
+ * @file eval_tuner.cpp
+ * @brief evaluation tuner tool.
+ *
+ * Texel tuning of the handcrafted evaluation weights, EVAL_WEIGHTS in eval_weights.hpp.
+ *
+ * Usage: EvalTuner <dataset> <eval_weights.hpp> [iterations <n>] [threads <n>] [lr <x>] [lambda <x>] [k <x>]
+ *
+ * Dataset: one quiet position per line, "fen;score;result"
+ *  - score : evaluation in centipawns from the white point of view.
+ *  - result : game result from the white point of view, 1 win, 0.5 draw, 0 loss.
+ *
+ * The tunable terms of the evaluation are linear in the weights, so every position is evaluated once with
+ * evaluate_position (built with EVAL_TUNING to trace the king terms) and stored as the coefficient of each weight
+ * plus the constant part of the evaluation. The parameterised evaluation is then
+ * eval(w) = constant + sum(coefficient_i * w_i), and the error mean((sigmoid(eval(w)) - target)^2) is minimised
+ * with Adam, the gradient of each iteration computed in parallel by all the threads.
+ *
+ * https://www.chessprogramming.org/Texel%27s_Tuning_Method
+ * https://arxiv.org/abs/1412.6980
+ *
+ */
+
+#include "evaluation.hpp"
+#include "material.hpp"
+#include "precomputed_eval_data.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// iterations between progress reports, the header is written at every report
+static constexpr int REPORT_INTERVAL = 50;
+
+/**
+ * @brief TunerOptions
+ *
+ * Command line options of the tuner.
+ *
+ */
+struct TunerOptions
+{
+    std::string datasetPath;
+    std::string outputPath;
+    int iterations = 1000;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    double learningRate = 1.0;   // centipawns
+    double lambda = 0.0;         // weight of the score against the result in the target
+    double k = 0.0;              // sigmoid scale, 0 to fit it to the dataset
+};
+
+/**
+ * @brief TraceEntry
+ *
+ * Number of times a weight is used by a position, positive for white and negative for black.
+ *
+ */
+struct TraceEntry
+{
+    uint16_t index;
+    int16_t count;
+};
+
+/**
+ * @brief TunerPosition
+ *
+ * Traced position, the coefficients of its weights are stored in the entries [firstEntry, firstEntry + numEntries).
+ *
+ */
+struct TunerPosition
+{
+    uint32_t firstEntry;
+    uint16_t numEntries;
+    uint8_t middlegamePhase;   // 0 to MAX_GAME_PHASE
+    uint8_t endgameScale;      // 0 to SCALE_FACTOR_NORMAL
+    double constant;           // evaluation without the tunable terms, from the white point of view
+    double target;             // win probability of white
+};
+
+/**
+ * @brief TunerDataset
+ *
+ * Traced positions and their entries.
+ *
+ */
+struct TunerDataset
+{
+    std::vector<TunerPosition> positions;
+    std::vector<TraceEntry> entries;
+};
+
+static bool parse_options(int argc, char* argv[], TunerOptions& options);
+static bool load_dataset(const TunerOptions& options, TunerDataset& dataset);
+static bool trace_position(const std::string& line, double lambda, Board& board, TunerPosition& position,
+                           std::vector<TraceEntry>& entries);
+static inline double coefficient(const TunerPosition& position, const TraceEntry& entry);
+static inline double evaluate(const TunerDataset& dataset, const TunerPosition& position,
+                              const std::vector<double>& weights);
+static inline double sigmoid(double k, double eval);
+static double mean_error(const TunerDataset& dataset, const std::vector<double>& weights, double k, int threads);
+static double fit_k(const TunerDataset& dataset, const std::vector<double>& weights, int threads);
+static double compute_gradient(const TunerDataset& dataset, const std::vector<double>& weights, double k,
+                               int threads, std::vector<double>& gradient);
+static bool write_header(const std::string& path, const std::vector<double>& weights);
+template<typename Function>
+static void parallel_for(int threads, Function function);
+
+int main(int argc, char* argv[])
+{
+    TunerOptions options;
+
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "Usage: EvalTuner <dataset> <eval_weights.hpp> [iterations <n>] [threads <n>] [lr <x>] "
+                     "[lambda <x>] [k <x>]\n";
+        return 1;
+    }
+
+    TunerDataset dataset;
+
+    if (!load_dataset(options, dataset)) {
+        std::cerr << "Can not open the dataset " << options.datasetPath << "\n";
+        return 1;
+    }
+
+    std::cout << "positions " << dataset.positions.size() << " entries " << dataset.entries.size() << std::endl;
+
+    std::vector<double> weights(EVAL_WEIGHTS, EVAL_WEIGHTS + NUM_EVAL_WEIGHTS);
+    const double k = options.k > 0.0 ? options.k : fit_k(dataset, weights, options.threads);
+
+    std::cout << "k " << k << " error " << mean_error(dataset, weights, k, options.threads) << std::endl;
+
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    constexpr double EPSILON = 1e-8;
+
+    std::vector<double> gradient(NUM_EVAL_WEIGHTS);
+    std::vector<double> first_moment(NUM_EVAL_WEIGHTS, 0.0);
+    std::vector<double> second_moment(NUM_EVAL_WEIGHTS, 0.0);
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int iteration = 1; iteration <= options.iterations; iteration++) {
+
+        const double error = compute_gradient(dataset, weights, k, options.threads, gradient);
+
+        const double correction1 = 1.0 - std::pow(BETA1, iteration);
+        const double correction2 = 1.0 - std::pow(BETA2, iteration);
+
+        for (int i = 0; i < NUM_EVAL_WEIGHTS; i++) {
+            first_moment[i] = BETA1 * first_moment[i] + (1.0 - BETA1) * gradient[i];
+            second_moment[i] = BETA2 * second_moment[i] + (1.0 - BETA2) * gradient[i] * gradient[i];
+            weights[i] -= options.learningRate * (first_moment[i] / correction1) /
+                (std::sqrt(second_moment[i] / correction2) + EPSILON);
+        }
+
+        if (iteration % REPORT_INTERVAL == 0 || iteration == options.iterations) {
+            const double seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << "iteration " << iteration << " error " << error << " positions/s "
+                      << static_cast<uint64_t>(double(dataset.positions.size()) * iteration / std::max(seconds, 1e-9))
+                      << std::endl;
+
+            if (!write_header(options.outputPath, weights)) {
+                std::cerr << "Can not write " << options.outputPath << "\n";
+                return 1;
+            }
+        }
+    }
+
+    if (options.iterations == 0 && !write_header(options.outputPath, weights)) {
+        std::cerr << "Can not write " << options.outputPath << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief parse_options(int, char*[], TunerOptions&)
+ *
+ * @param[in] argc number of arguments.
+ * @param[in] argv arguments.
+ * @param[out] options tuner options.
+ *
+ * @return true if the arguments are valid.
+ *
+ */
+static bool parse_options(int argc, char* argv[], TunerOptions& options)
+{
+    if (argc < 3 || argc % 2 == 0) {
+        return false;
+    }
+
+    options.datasetPath = argv[1];
+    options.outputPath = argv[2];
+
+    try {
+        for (int i = 3; i < argc; i += 2) {
+            const std::string name = argv[i];
+            const std::string value = argv[i + 1];
+
+            if (name == "iterations") {
+                options.iterations = std::max(0, std::stoi(value));
+            }
+            else if (name == "threads") {
+                options.threads = std::max(1, std::stoi(value));
+            }
+            else if (name == "lr") {
+                options.learningRate = std::stod(value);
+            }
+            else if (name == "lambda") {
+                options.lambda = std::clamp(std::stod(value), 0.0, 1.0);
+            }
+            else if (name == "k") {
+                options.k = std::stod(value);
+            }
+            else {
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief load_dataset(const TunerOptions&, TunerDataset&)
+ *
+ * Read the dataset and trace its positions in parallel, positions in check or in known endgames are skipped.
+ *
+ * @param[in] options tuner options.
+ * @param[out] dataset traced positions.
+ *
+ * @return true if the dataset has been read.
+ *
+ */
+static bool load_dataset(const TunerOptions& options, TunerDataset& dataset)
+{
+    std::ifstream file(options.datasetPath);
+
+    if (!file) {
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        lines.push_back(std::move(line));
+    }
+
+    std::vector<TunerDataset> thread_datasets(options.threads);
+
+    parallel_for(options.threads, [&](int thread) {
+        TunerDataset& thread_dataset = thread_datasets[thread];
+        Board board;
+        TunerPosition position;
+
+        for (size_t i = thread; i < lines.size(); i += options.threads) {
+            position.firstEntry = static_cast<uint32_t>(thread_dataset.entries.size());
+            if (trace_position(lines[i], options.lambda, board, position, thread_dataset.entries)) {
+                thread_dataset.positions.push_back(position);
+            }
+        }
+    });
+
+    for (const TunerDataset& thread_dataset : thread_datasets) {
+        const uint32_t offset = static_cast<uint32_t>(dataset.entries.size());
+
+        dataset.entries.insert(dataset.entries.end(), thread_dataset.entries.begin(), thread_dataset.entries.end());
+        for (TunerPosition position : thread_dataset.positions) {
+            position.firstEntry += offset;
+            dataset.positions.push_back(position);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief trace_position
+ *
+ * Evaluate a position and store the coefficients of the weights it uses.
+ *
+ * @param[in] line dataset line, "fen;score;result".
+ * @param[in] lambda weight of the score against the result in the target.
+ * @param[in,out] board board of the thread.
+ * @param[in,out] position traced position, firstEntry must be set.
+ * @param[in,out] entries entries of the thread, the entries of the position are appended.
+ *
+ * @return true if the position is valid and quiet, entries is unchanged otherwise.
+ *
+ */
+static bool trace_position(const std::string& line, double lambda, Board& board, TunerPosition& position,
+                           std::vector<TraceEntry>& entries)
+{
+    const size_t first_separator = line.find(';');
+    const size_t second_separator = line.find(';', first_separator + 1U);
+
+    if (first_separator == std::string::npos || second_separator == std::string::npos) {
+        return false;
+    }
+
+    double score;
+    double result;
+
+    try {
+        score = std::stod(line.substr(first_separator + 1U, second_separator - first_separator - 1U));
+        result = std::stod(line.substr(second_separator + 1U));
+        board.load_fen(line.substr(0, first_separator));
+    } catch (const std::exception& e) {
+        return false;
+    }
+
+    if (board.get_bitboard_piece(Piece::W_KING) == 0ULL || board.get_bitboard_piece(Piece::B_KING) == 0ULL ||
+        board.in_check()) {
+        return false;
+    }
+
+    const int eval = evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(board);
+    const EvalTrace& trace = EvalTrace::current();
+
+    if (!trace.complete) {
+        return false;   // known endgame, the weights are not used
+    }
+
+    std::vector<TraceEntry> position_entries;
+    uint64_t pieces = board.get_bitboard_all();
+
+    while (pieces) {
+        const Square square(pop_lsb(pieces));
+        const Piece piece = board.get_piece(square);
+        const ChessColor color = get_color(piece);
+        const int piece_type = static_cast<int>(piece_to_pieceType(piece));
+        const int index_sq = PrecomputedEvalData::pst_index_sq(square, color);
+        const int16_t count = is_white(color) ? 1 : -1;
+
+        position_entries.push_back(
+            {static_cast<uint16_t>(PrecomputedEvalData::pst_weight_index<PST_TYPE_MIDDLEGAME>(piece_type, index_sq)),
+             count});
+        position_entries.push_back(
+            {static_cast<uint16_t>(PrecomputedEvalData::pst_weight_index<PST_TYPE_ENDGAME>(piece_type, index_sq)),
+             count});
+    }
+
+    // penalization of the own king and bonus of the own shield
+    position_entries.push_back({static_cast<uint16_t>(SAFETY_WEIGHTS + trace.kingSafety[0]), -1});
+    position_entries.push_back({static_cast<uint16_t>(SAFETY_WEIGHTS + trace.kingSafety[1]), 1});
+    position_entries.push_back({static_cast<uint16_t>(KING_SHIELD_WEIGHTS + trace.kingShield[0]), 1});
+    position_entries.push_back({static_cast<uint16_t>(KING_SHIELD_WEIGHTS + trace.kingShield[1]), -1});
+
+    // merge the entries of the same weight, a white and a black piece in mirrored squares cancel
+    std::sort(position_entries.begin(), position_entries.end(),
+              [](const TraceEntry& a, const TraceEntry& b) { return a.index < b.index; });
+
+    const size_t first_entry = entries.size();
+
+    for (const TraceEntry& entry : position_entries) {
+        if (entries.size() > first_entry && entries.back().index == entry.index) {
+            entries.back().count += entry.count;
+        }
+        else {
+            entries.push_back(entry);
+        }
+    }
+    entries.erase(std::remove_if(entries.begin() + first_entry, entries.end(),
+                                 [](const TraceEntry& entry) { return entry.count == 0; }),
+                  entries.end());
+
+    position.numEntries = static_cast<uint16_t>(entries.size() - first_entry);
+    position.middlegamePhase = static_cast<uint8_t>(std::min(board.get_game_phase(), MAX_GAME_PHASE));
+    position.endgameScale = static_cast<uint8_t>(trace.endgameScale);
+
+    // constant part, the evaluation without the tunable terms
+    double tunable = 0.0;
+    for (size_t i = first_entry; i < entries.size(); i++) {
+        tunable += coefficient(position, entries[i]) * EVAL_WEIGHTS[entries[i].index];
+    }
+    position.constant = eval - tunable;
+
+    const double score_probability = sigmoid(1.0, score);
+    position.target = lambda * score_probability + (1.0 - lambda) * result;
+
+    return true;
+}
+
+/**
+ * @brief coefficient(const TunerPosition&, const TraceEntry&)
+ *
+ * Weight of a tunable term in the tapered evaluation of the position.
+ *
+ * @param[in] position traced position.
+ * @param[in] entry entry of the position.
+ *
+ * @return (double) derivative of the evaluation of the position with respect to the weight.
+ *
+ */
+static inline double coefficient(const TunerPosition& position, const TraceEntry& entry)
+{
+    const double middlegame = double(position.middlegamePhase) / MAX_GAME_PHASE;
+
+    if (entry.index >= PST_ENDGAME_WEIGHTS && entry.index < SAFETY_WEIGHTS) {
+        return entry.count * (1.0 - middlegame) * position.endgameScale / SCALE_FACTOR_NORMAL;
+    }
+    return entry.count * middlegame;
+}
+
+/**
+ * @brief evaluate(const TunerDataset&, const TunerPosition&, const std::vector<double>&)
+ *
+ * Parameterised evaluation of a traced position.
+ *
+ * @param[in] dataset traced positions.
+ * @param[in] position traced position.
+ * @param[in] weights evaluation weights.
+ *
+ * @return (double) evaluation from the white point of view.
+ *
+ */
+static inline double evaluate(const TunerDataset& dataset, const TunerPosition& position,
+                              const std::vector<double>& weights)
+{
+    double eval = position.constant;
+
+    for (uint32_t i = position.firstEntry; i < position.firstEntry + position.numEntries; i++) {
+        eval += coefficient(position, dataset.entries[i]) * weights[dataset.entries[i].index];
+    }
+
+    return eval;
+}
+
+/**
+ * @brief sigmoid(double, double)
+ *
+ * @param[in] k sigmoid scale.
+ * @param[in] eval evaluation in centipawns.
+ *
+ * @return (double) win probability of an evaluation.
+ *
+ */
+static inline double sigmoid(double k, double eval)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -k * eval / 400.0));
+}
+
+/**
+ * @brief mean_error(const TunerDataset&, const std::vector<double>&, double, int)
+ *
+ * @param[in] dataset traced positions.
+ * @param[in] weights evaluation weights.
+ * @param[in] k sigmoid scale.
+ * @param[in] threads number of threads.
+ *
+ * @return (double) mean of (sigmoid(eval) - target)^2.
+ *
+ */
+static double mean_error(const TunerDataset& dataset, const std::vector<double>& weights, double k, int threads)
+{
+    std::vector<double> errors(threads, 0.0);
+
+    parallel_for(threads, [&](int thread) {
+        for (size_t i = thread; i < dataset.positions.size(); i += threads) {
+            const TunerPosition& position = dataset.positions[i];
+            const double error = sigmoid(k, evaluate(dataset, position, weights)) - position.target;
+            errors[thread] += error * error;
+        }
+    });
+
+    double error = 0.0;
+    for (const double thread_error : errors) {
+        error += thread_error;
+    }
+
+    return dataset.positions.empty() ? 0.0 : error / double(dataset.positions.size());
+}
+
+/**
+ * @brief fit_k(const TunerDataset&, const std::vector<double>&, int)
+ *
+ * Sigmoid scale that minimises the error of the current weights, narrowing the search step by step.
+ *
+ * @param[in] dataset traced positions.
+ * @param[in] weights evaluation weights.
+ * @param[in] threads number of threads.
+ *
+ * @return (double) best sigmoid scale.
+ *
+ */
+static double fit_k(const TunerDataset& dataset, const std::vector<double>& weights, int threads)
+{
+    double best_k = 1.0;
+    double best_error = mean_error(dataset, weights, best_k, threads);
+
+    for (double step = 0.5; step > 0.001; step /= 10.0) {
+        const double center = best_k;
+        for (int i = -9; i <= 9; i++) {
+            const double k = center + i * step;
+            if (k <= 0.0) {
+                continue;
+            }
+            const double error = mean_error(dataset, weights, k, threads);
+            if (error < best_error) {
+                best_error = error;
+                best_k = k;
+            }
+        }
+    }
+
+    return best_k;
+}
+
+/**
+ * @brief compute_gradient
+ *
+ * Gradient of the mean error, each thread accumulates its share of the positions and the results are reduced.
+ *
+ * @param[in] dataset traced positions.
+ * @param[in] weights evaluation weights.
+ * @param[in] k sigmoid scale.
+ * @param[in] threads number of threads.
+ * @param[out] gradient derivative of the mean error with respect to each weight.
+ *
+ * @return (double) mean error of the weights.
+ *
+ */
+static double compute_gradient(const TunerDataset& dataset, const std::vector<double>& weights, double k,
+                               int threads, std::vector<double>& gradient)
+{
+    std::vector<std::vector<double>> thread_gradients(threads, std::vector<double>(NUM_EVAL_WEIGHTS, 0.0));
+    std::vector<double> errors(threads, 0.0);
+
+    parallel_for(threads, [&](int thread) {
+        std::vector<double>& thread_gradient = thread_gradients[thread];
+        const size_t begin = dataset.positions.size() * thread / threads;
+        const size_t end = dataset.positions.size() * (thread + 1) / threads;
+
+        for (size_t i = begin; i < end; i++) {
+            const TunerPosition& position = dataset.positions[i];
+            const double probability = sigmoid(k, evaluate(dataset, position, weights));
+            const double error = probability - position.target;
+
+            // d(error^2)/d(eval)
+            const double eval_gradient = 2.0 * error * probability * (1.0 - probability) * std::log(10.0) * k / 400.0;
+
+            for (uint32_t e = position.firstEntry; e < position.firstEntry + position.numEntries; e++) {
+                thread_gradient[dataset.entries[e].index] += eval_gradient * coefficient(position, dataset.entries[e]);
+            }
+            errors[thread] += error * error;
+        }
+    });
+
+    const double num_positions = std::max<double>(1.0, double(dataset.positions.size()));
+    double error = 0.0;
+
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+    for (int thread = 0; thread < threads; thread++) {
+        for (int i = 0; i < NUM_EVAL_WEIGHTS; i++) {
+            gradient[i] += thread_gradients[thread][i] / num_positions;
+        }
+        error += errors[thread];
+    }
+
+    return error / num_positions;
+}
+
+/**
+ * @brief write_header(const std::string&, const std::vector<double>&)
+ *
+ * Write eval_weights.hpp with the rounded weights.
+ *
+ * @param[in] path path of the header.
+ * @param[in] weights evaluation weights.
+ *
+ * @return true if the header has been written.
+ *
+ */
+static bool write_header(const std::string& path, const std::vector<double>& weights)
+{
+    std::ofstream header(path);
+
+    if (!header) {
+        return false;
+    }
+
+    header << "#pragma once\n"
+              "\n"
+              "/**\n"
+              " * @file eval_weights.hpp\n"
+              " * @brief handcrafted evaluation weights.\n"
+              " *\n"
+              " * Tunable weights of the handcrafted evaluation, indexed by EvalWeight (precomputed_eval_data.hpp).\n"
+              " *\n"
+              " * @note generated by the EvalTuner tool (src/tools/eval_tuner.cpp), tune the weights again after "
+              "changing\n"
+              " * the evaluation terms.\n"
+              " *\n"
+              " */\n"
+              "\n"
+              "// clang-format off\n"
+              "\n"
+              "inline constexpr int EVAL_WEIGHTS[] = {\n";
+
+    auto write_group = [&](const std::string& name, int offset, int size, int row_size) {
+        header << "    // " << name << "\n";
+        for (int i = 0; i < size; i++) {
+            header << (i % row_size == 0 ? "    " : " ") << std::setw(4)
+                   << static_cast<int>(std::lround(weights[offset + i])) << ",";
+            if (i % row_size == row_size - 1 || i == size - 1) {
+                header << "\n";
+            }
+        }
+    };
+
+    static const std::string PIECE_TYPE_NAMES[] = {"PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"};
+
+    for (int piece_type = 0; piece_type < NUM_CHESS_PIECE_TYPES - 1; piece_type++) {
+        write_group("PST_MIDDLEGAME_WEIGHTS " + PIECE_TYPE_NAMES[piece_type],
+                    PST_MIDDLEGAME_WEIGHTS + piece_type * 64, 64, 8);
+    }
+    for (int piece_type = 0; piece_type < NUM_CHESS_PIECE_TYPES - 1; piece_type++) {
+        write_group("PST_ENDGAME_WEIGHTS " + PIECE_TYPE_NAMES[piece_type], PST_ENDGAME_WEIGHTS + piece_type * 64,
+                    64, 8);
+    }
+    write_group("SAFETY_WEIGHTS", SAFETY_WEIGHTS, KING_SHIELD_WEIGHTS - SAFETY_WEIGHTS, 10);
+    write_group("KING_SHIELD_WEIGHTS", KING_SHIELD_WEIGHTS, NUM_EVAL_WEIGHTS - KING_SHIELD_WEIGHTS, 4);
+
+    header << "};\n"
+              "\n"
+              "// clang-format on\n";
+
+    return static_cast<bool>(header);
+}
+
+/**
+ * @brief parallel_for(int, Function)
+ *
+ * Run function(thread) in threads threads and wait for all of them.
+ *
+ * @param[in] threads number of threads.
+ * @param[in] function work of each thread, receives the thread index.
+ *
+ */
+template<typename Function>
+static void parallel_for(int threads, Function function)
+{
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    for (int thread = 1; thread < threads; thread++) {
+        workers.emplace_back(function, thread);
+    }
+    function(0);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,718 @@
+/**
+ * @file nnue_trainer.cpp
+ * @brief nnue trainer tool.
+ *
+ * Trains the network of the NNUE evaluation on the CPU and exports the quantized network file.
+ *
+ * Usage: NnueTrainer <dataset> <output.nnue> [epochs <n>] [threads <n>] [batch <n>] [lr <x>] [lambda <x>]
+ *
+ * Dataset: one position per line, "fen;score;result"
+ *  - score : evaluation in centipawns from the white point of view.
+ *  - result : game result from the white point of view, 1 win, 0.5 draw, 0 loss.
+ *
+ * The dataset is streamed in chunks, so it does not need to fit in memory. Each minibatch is split between the
+ * threads: every thread propagates its samples and accumulates the gradients of the hidden layers, then the
+ * gradient of the feature transformer is accumulated by slices of the accumulator, only in the rows of the
+ * features present in the minibatch. Adam updates the hidden layers and the touched rows of the transformer.
+ *
+ * https://www.chessprogramming.org/NNUE
+ * https://github.com/official-stockfish/nnue-pytorch/blob/master/docs/nnue.md
+ * https://arxiv.org/abs/1412.6980
+ *
+ */
+
+#include "nnue.hpp"
+#include "bit_utilities.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr uint32_t INPUTS = NnueNetwork::INPUT_DIMENSIONS;
+static constexpr uint32_t L1 = NnueNetwork::L1;
+static constexpr uint32_t L2 = NnueNetwork::L2;
+static constexpr uint32_t L3 = NnueNetwork::L3;
+
+// at most 30 pieces without kings
+static constexpr uint32_t MAX_FEATURES = 30U;
+
+// centipawns of the sigmoid that maps evaluations to win probabilities
+static constexpr float SIGMOID_SCALE = 400.0f;
+
+// largest hidden layer weight that fits in int8 after the quantization
+static constexpr float MAX_HIDDEN_WEIGHT = 127.0f / NnueNetwork::WEIGHT_SCALE;
+
+// positions read from the dataset at once
+static constexpr size_t CHUNK_SIZE = 1U << 20;
+
+/**
+ * @brief TrainerOptions
+ *
+ * Command line options of the trainer.
+ *
+ */
+struct TrainerOptions
+{
+    std::string datasetPath;
+    std::string outputPath;
+    int epochs = 10;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int batchSize = 16384;
+    float learningRate = 1e-3f;
+    float learningRateDecay = 0.9f;   // per epoch
+    float lambda = 0.75f;             // weight of the score against the result in the target
+};
+
+/**
+ * @brief Sample
+ *
+ * Training position, the HalfKP features of both perspectives and the target from the side to move.
+ *
+ */
+struct Sample
+{
+    uint16_t features[2][MAX_FEATURES];   // [side to move, other side]
+    uint8_t numFeatures[2];
+    float target;   // win probability of the side to move
+};
+
+/**
+ * @brief Parameter
+ *
+ * Float weights of one layer with its gradient and Adam moments.
+ *
+ */
+struct Parameter
+{
+    std::vector<float> value;
+    std::vector<float> gradient;
+    std::vector<float> firstMoment;
+    std::vector<float> secondMoment;
+
+    explicit Parameter(size_t size) : value(size, 0.0f), gradient(size, 0.0f), firstMoment(size, 0.0f),
+                                      secondMoment(size, 0.0f) {}
+};
+
+/**
+ * @brief FloatNetwork
+ *
+ * Float network trained, same layers as NnueNetwork.
+ *
+ */
+struct FloatNetwork
+{
+    Parameter featureWeights{size_t(INPUTS) * L1};   // [feature][L1]
+    Parameter featureBiases{L1};
+    Parameter hidden1Weights{size_t(L2) * 2U * L1};   // [output][input]
+    Parameter hidden1Biases{L2};
+    Parameter hidden2Weights{size_t(L3) * L2};
+    Parameter hidden2Biases{L3};
+    Parameter outputWeights{L3};
+    Parameter outputBias{1U};
+};
+
+/**
+ * @brief ThreadGradients
+ *
+ * Gradients of the hidden layers accumulated by one thread.
+ *
+ */
+struct ThreadGradients
+{
+    std::vector<float> featureBiases = std::vector<float>(L1, 0.0f);
+    std::vector<float> hidden1Weights = std::vector<float>(size_t(L2) * 2U * L1, 0.0f);
+    std::vector<float> hidden1Biases = std::vector<float>(L2, 0.0f);
+    std::vector<float> hidden2Weights = std::vector<float>(size_t(L3) * L2, 0.0f);
+    std::vector<float> hidden2Biases = std::vector<float>(L3, 0.0f);
+    std::vector<float> outputWeights = std::vector<float>(L3, 0.0f);
+    float outputBias = 0.0f;
+    double loss = 0.0;
+};
+
+static bool parse_options(int argc, char* argv[], TrainerOptions& options);
+static bool parse_sample(const std::string& line, float lambda, Sample& sample);
+static size_t read_chunk(std::ifstream& dataset, const TrainerOptions& options, std::vector<Sample>& samples);
+static void initialize(FloatNetwork& network, std::mt19937& generator);
+static void train_batch(FloatNetwork& network, const Sample* batch, size_t batch_size, const TrainerOptions& options,
+                        float learning_rate, uint64_t step, std::vector<ThreadGradients>& thread_gradients,
+                        std::vector<float>& accumulator_gradients, std::vector<uint8_t>& touched, double& loss);
+static double propagate_sample(const FloatNetwork& network, const Sample& sample, ThreadGradients& gradients,
+                               float* accumulator_gradient);
+static void adam_update(Parameter& parameter, size_t begin, size_t end, float learning_rate, uint64_t step,
+                        float min_value, float max_value);
+static std::unique_ptr<NnueNetwork> quantize(const FloatNetwork& network);
+template<typename Function>
+static void parallel_for(int threads, Function function);
+
+int main(int argc, char* argv[])
+{
+    TrainerOptions options;
+
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "Usage: NnueTrainer <dataset> <output.nnue> [epochs <n>] [threads <n>] [batch <n>] [lr <x>] "
+                     "[lambda <x>]\n";
+        return 1;
+    }
+
+    std::mt19937 generator(20250101U);
+    std::unique_ptr<FloatNetwork> network = std::make_unique<FloatNetwork>();
+    initialize(*network, generator);
+
+    std::vector<Sample> samples;
+    std::vector<ThreadGradients> thread_gradients(options.threads);
+    std::vector<float> accumulator_gradients(size_t(options.batchSize) * 2U * L1);
+    std::vector<uint8_t> touched(INPUTS, 0U);
+    float learning_rate = options.learningRate;
+    uint64_t step = 0ULL;
+
+    for (int epoch = 1; epoch <= options.epochs; epoch++) {
+
+        std::ifstream dataset(options.datasetPath);
+        if (!dataset) {
+            std::cerr << "Can not open the dataset " << options.datasetPath << "\n";
+            return 1;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        double epoch_loss = 0.0;
+        uint64_t epoch_samples = 0ULL;
+
+        while (read_chunk(dataset, options, samples) > 0U) {
+
+            std::shuffle(samples.begin(), samples.end(), generator);
+
+            for (size_t first = 0; first < samples.size(); first += options.batchSize) {
+                const size_t batch_size = std::min(samples.size() - first, size_t(options.batchSize));
+                double batch_loss = 0.0;
+
+                train_batch(*network, samples.data() + first, batch_size, options, learning_rate, ++step,
+                            thread_gradients, accumulator_gradients, touched, batch_loss);
+
+                epoch_loss += batch_loss;
+                epoch_samples += batch_size;
+            }
+        }
+
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream output(options.outputPath, std::ios::binary);
+        if (!output || !quantize(*network)->write(output)) {
+            std::cerr << "Can not write the network " << options.outputPath << "\n";
+            return 1;
+        }
+
+        std::cout << "epoch " << epoch << " loss " << (epoch_samples ? epoch_loss / double(epoch_samples) : 0.0)
+                  << " positions " << epoch_samples << " positions/s "
+                  << static_cast<uint64_t>(double(epoch_samples) / std::max(seconds, 1e-9)) << " lr " << learning_rate
+                  << std::endl;
+
+        learning_rate *= options.learningRateDecay;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief parse_options(int, char*[], TrainerOptions&)
+ *
+ * @param[in] argc number of arguments.
+ * @param[in] argv arguments.
+ * @param[out] options trainer options.
+ *
+ * @return true if the arguments are valid.
+ *
+ */
+static bool parse_options(int argc, char* argv[], TrainerOptions& options)
+{
+    if (argc < 3 || argc % 2 == 0) {
+        return false;
+    }
+
+    options.datasetPath = argv[1];
+    options.outputPath = argv[2];
+
+    try {
+        for (int i = 3; i < argc; i += 2) {
+            const std::string name = argv[i];
+            const std::string value = argv[i + 1];
+
+            if (name == "epochs") {
+                options.epochs = std::stoi(value);
+            }
+            else if (name == "threads") {
+                options.threads = std::max(1, std::stoi(value));
+            }
+            else if (name == "batch") {
+                options.batchSize = std::max(1, std::stoi(value));
+            }
+            else if (name == "lr") {
+                options.learningRate = std::stof(value);
+            }
+            else if (name == "lambda") {
+                options.lambda = std::clamp(std::stof(value), 0.0f, 1.0f);
+            }
+            else {
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse_sample(const std::string&, float, Sample&)
+ *
+ * @param[in] line dataset line, "fen;score;result".
+ * @param[in] lambda weight of the score against the result in the target.
+ * @param[out] sample training position.
+ *
+ * @return true if the line is a valid position.
+ *
+ */
+static bool parse_sample(const std::string& line, float lambda, Sample& sample)
+{
+    const size_t first_separator = line.find(';');
+    const size_t second_separator = line.find(';', first_separator + 1U);
+
+    if (first_separator == std::string::npos || second_separator == std::string::npos) {
+        return false;
+    }
+
+    Board board;
+    float score;
+    float result;
+
+    try {
+        score = std::stof(line.substr(first_separator + 1U, second_separator - first_separator - 1U));
+        result = std::stof(line.substr(second_separator + 1U));
+        board.load_fen(line.substr(0, first_separator));
+    } catch (const std::exception& e) {
+        return false;
+    }
+
+    if (board.get_bitboard_piece(Piece::W_KING) == 0ULL || board.get_bitboard_piece(Piece::B_KING) == 0ULL) {
+        return false;
+    }
+
+    const ChessColor side_to_move = board.state().side_to_move();
+    const ChessColor perspectives[2] = {side_to_move, opposite_color(side_to_move)};
+
+    for (int p = 0; p < 2; p++) {
+
+        const ChessColor perspective = perspectives[p];
+        const Square king_square(lsb(board.get_bitboard_piece(create_piece(PieceType::KING, perspective))));
+        uint64_t pieces = board.get_bitboard_all() &
+            ~(board.get_bitboard_piece(Piece::W_KING) | board.get_bitboard_piece(Piece::B_KING));
+
+        sample.numFeatures[p] = 0U;
+
+        while (pieces && sample.numFeatures[p] < MAX_FEATURES) {
+            const Square square(pop_lsb(pieces));
+            sample.features[p][sample.numFeatures[p]++] =
+                static_cast<uint16_t>(Nnue::feature_index(perspective, king_square, board.get_piece(square), square));
+        }
+    }
+
+    // labels from the point of view of the side to move, in win probability
+    if (!is_white(side_to_move)) {
+        score = -score;
+        result = 1.0f - result;
+    }
+    const float score_probability = 1.0f / (1.0f + std::exp(-score / SIGMOID_SCALE));
+    sample.target = lambda * score_probability + (1.0f - lambda) * result;
+
+    return true;
+}
+
+/**
+ * @brief read_chunk(std::ifstream&, const TrainerOptions&, std::vector<Sample>&)
+ *
+ * Read the next CHUNK_SIZE lines of the dataset and parse them in parallel.
+ *
+ * @param[in] dataset dataset file.
+ * @param[in] options trainer options.
+ * @param[out] samples valid positions of the chunk.
+ *
+ * @return (size_t) number of valid positions.
+ *
+ */
+static size_t read_chunk(std::ifstream& dataset, const TrainerOptions& options, std::vector<Sample>& samples)
+{
+    std::vector<std::string> lines;
+    std::string line;
+
+    lines.reserve(CHUNK_SIZE);
+    while (lines.size() < CHUNK_SIZE && std::getline(dataset, line)) {
+        lines.push_back(std::move(line));
+    }
+
+    std::vector<Sample> parsed(lines.size());
+    std::vector<uint8_t> valid(lines.size(), 0U);
+
+    parallel_for(options.threads, [&](int thread) {
+        for (size_t i = thread; i < lines.size(); i += options.threads) {
+            valid[i] = parse_sample(lines[i], options.lambda, parsed[i]);
+        }
+    });
+
+    samples.clear();
+    for (size_t i = 0; i < parsed.size(); i++) {
+        if (valid[i]) {
+            samples.push_back(parsed[i]);
+        }
+    }
+
+    return samples.size();
+}
+
+/**
+ * @brief initialize(FloatNetwork&, std::mt19937&)
+ *
+ * Random weights, the accumulators of a position start around the middle of the activation.
+ *
+ * @param[out] network network to initialize.
+ * @param[in] generator random generator.
+ *
+ */
+static void initialize(FloatNetwork& network, std::mt19937& generator)
+{
+    auto fill_uniform = [&generator](Parameter& parameter, float limit) {
+        std::uniform_real_distribution<float> distribution(-limit, limit);
+        for (float& value : parameter.value) {
+            value = distribution(generator);
+        }
+    };
+
+    fill_uniform(network.featureWeights, 1.0f / std::sqrt(float(MAX_FEATURES)));
+    std::fill(network.featureBiases.value.begin(), network.featureBiases.value.end(), 0.5f);
+    fill_uniform(network.hidden1Weights, 1.0f / std::sqrt(float(2U * L1)));
+    fill_uniform(network.hidden2Weights, 1.0f / std::sqrt(float(L2)));
+    fill_uniform(network.outputWeights, 1.0f / std::sqrt(float(L3)));
+}
+
+/**
+ * @brief train_batch
+ *
+ * Gradient of the minibatch and Adam step.
+ *
+ * @param[in,out] network float network.
+ * @param[in] batch samples of the minibatch.
+ * @param[in] batch_size number of samples.
+ * @param[in] options trainer options.
+ * @param[in] learning_rate learning rate of the step.
+ * @param[in] step number of the step, starting at 1.
+ * @param[in,out] thread_gradients gradient buffers of each thread.
+ * @param[in,out] accumulator_gradients gradient of the accumulators of each sample.
+ * @param[in,out] touched features present in the minibatch, cleared before returning.
+ * @param[out] loss sum of the loss of the samples.
+ *
+ */
+static void train_batch(FloatNetwork& network, const Sample* batch, size_t batch_size, const TrainerOptions& options,
+                        float learning_rate, uint64_t step, std::vector<ThreadGradients>& thread_gradients,
+                        std::vector<float>& accumulator_gradients, std::vector<uint8_t>& touched, double& loss)
+{
+    const int threads = options.threads;
+
+    // propagate the samples, each thread its share of the batch
+    parallel_for(threads, [&](int thread) {
+        ThreadGradients& gradients = thread_gradients[thread];
+        gradients = ThreadGradients();
+
+        for (size_t i = thread; i < batch_size; i += threads) {
+            gradients.loss += propagate_sample(network, batch[i], gradients, &accumulator_gradients[i * 2U * L1]);
+        }
+    });
+
+    // features of the batch, only their rows of the transformer are updated
+    std::vector<uint16_t> touched_features;
+    for (size_t i = 0; i < batch_size; i++) {
+        for (int p = 0; p < 2; p++) {
+            for (uint8_t f = 0; f < batch[i].numFeatures[p]; f++) {
+                const uint16_t feature = batch[i].features[p][f];
+                if (!touched[feature]) {
+                    touched[feature] = 1U;
+                    touched_features.push_back(feature);
+                }
+            }
+        }
+    }
+
+    // sparse transformer gradient, each thread a slice of the accumulator for all the samples
+    parallel_for(threads, [&](int thread) {
+        const uint32_t begin = L1 * thread / threads;
+        const uint32_t end = L1 * (thread + 1) / threads;
+        float* gradient = network.featureWeights.gradient.data();
+
+        for (size_t i = 0; i < batch_size; i++) {
+            for (int p = 0; p < 2; p++) {
+                const float* accumulator_gradient = &accumulator_gradients[(i * 2U + p) * L1];
+                for (uint8_t f = 0; f < batch[i].numFeatures[p]; f++) {
+                    float* row = gradient + size_t(batch[i].features[p][f]) * L1;
+                    for (uint32_t j = begin; j < end; j++) {
+                        row[j] += accumulator_gradient[j];
+                    }
+                }
+            }
+        }
+
+        for (const uint16_t feature : touched_features) {
+            const size_t row = size_t(feature) * L1;
+            adam_update(network.featureWeights, row + begin, row + end, learning_rate, step, -INFINITY, INFINITY);
+        }
+    });
+
+    for (const uint16_t feature : touched_features) {
+        touched[feature] = 0U;
+    }
+
+    // reduce the gradients of the hidden layers
+    loss = 0.0;
+    for (const ThreadGradients& gradients : thread_gradients) {
+        auto add = [](std::vector<float>& total, const std::vector<float>& partial) {
+            for (size_t i = 0; i < total.size(); i++) {
+                total[i] += partial[i];
+            }
+        };
+        add(network.featureBiases.gradient, gradients.featureBiases);
+        add(network.hidden1Weights.gradient, gradients.hidden1Weights);
+        add(network.hidden1Biases.gradient, gradients.hidden1Biases);
+        add(network.hidden2Weights.gradient, gradients.hidden2Weights);
+        add(network.hidden2Biases.gradient, gradients.hidden2Biases);
+        add(network.outputWeights.gradient, gradients.outputWeights);
+        network.outputBias.gradient[0] += gradients.outputBias;
+        loss += gradients.loss;
+    }
+
+    adam_update(network.featureBiases, 0U, L1, learning_rate, step, -INFINITY, INFINITY);
+    adam_update(network.hidden1Weights, 0U, size_t(L2) * 2U * L1, learning_rate, step, -MAX_HIDDEN_WEIGHT,
+                MAX_HIDDEN_WEIGHT);
+    adam_update(network.hidden1Biases, 0U, L2, learning_rate, step, -INFINITY, INFINITY);
+    adam_update(network.hidden2Weights, 0U, size_t(L3) * L2, learning_rate, step, -MAX_HIDDEN_WEIGHT,
+                MAX_HIDDEN_WEIGHT);
+    adam_update(network.hidden2Biases, 0U, L3, learning_rate, step, -INFINITY, INFINITY);
+    adam_update(network.outputWeights, 0U, L3, learning_rate, step, -MAX_HIDDEN_WEIGHT, MAX_HIDDEN_WEIGHT);
+    adam_update(network.outputBias, 0U, 1U, learning_rate, step, -INFINITY, INFINITY);
+}
+
+/**
+ * @brief propagate_sample(const FloatNetwork&, const Sample&, ThreadGradients&, float*)
+ *
+ * Forward and backward pass of one sample, loss (sigmoid(eval) - target)^2.
+ *
+ * @param[in] network float network.
+ * @param[in] sample training position.
+ * @param[in,out] gradients gradients of the hidden layers of the thread.
+ * @param[out] accumulator_gradient gradient of the two accumulators of the sample, 2 * L1 values.
+ *
+ * @return (double) loss of the sample.
+ *
+ */
+static double propagate_sample(const FloatNetwork& network, const Sample& sample, ThreadGradients& gradients,
+                               float* accumulator_gradient)
+{
+    float accumulator[2U * L1];
+    float hidden0[2U * L1];
+    float hidden1[L2];
+    float hidden2[L3];
+
+    // feature transformer, side to move first
+    for (int p = 0; p < 2; p++) {
+        float* acc = accumulator + p * L1;
+        std::copy(network.featureBiases.value.begin(), network.featureBiases.value.end(), acc);
+        for (uint8_t f = 0; f < sample.numFeatures[p]; f++) {
+            const float* row = &network.featureWeights.value[size_t(sample.features[p][f]) * L1];
+            for (uint32_t j = 0; j < L1; j++) {
+                acc[j] += row[j];
+            }
+        }
+    }
+    for (uint32_t j = 0; j < 2U * L1; j++) {
+        hidden0[j] = std::clamp(accumulator[j], 0.0f, 1.0f);
+    }
+
+    for (uint32_t k = 0; k < L2; k++) {
+        const float* row = &network.hidden1Weights.value[size_t(k) * 2U * L1];
+        float sum = network.hidden1Biases.value[k];
+        for (uint32_t j = 0; j < 2U * L1; j++) {
+            sum += row[j] * hidden0[j];
+        }
+        hidden1[k] = sum;
+    }
+
+    for (uint32_t k = 0; k < L3; k++) {
+        const float* row = &network.hidden2Weights.value[size_t(k) * L2];
+        float sum = network.hidden2Biases.value[k];
+        for (uint32_t j = 0; j < L2; j++) {
+            sum += row[j] * std::clamp(hidden1[j], 0.0f, 1.0f);
+        }
+        hidden2[k] = sum;
+    }
+
+    float output = network.outputBias.value[0];
+    for (uint32_t j = 0; j < L3; j++) {
+        output += network.outputWeights.value[j] * std::clamp(hidden2[j], 0.0f, 1.0f);
+    }
+
+    // the output is in pawns, the sigmoid scale in centipawns
+    const float probability = 1.0f / (1.0f + std::exp(-output * 100.0f / SIGMOID_SCALE));
+    const float error = probability - sample.target;
+    const float output_gradient = 2.0f * error * probability * (1.0f - probability) * 100.0f / SIGMOID_SCALE;
+
+    // backward, the clipped relu passes the gradient only inside (0, 1)
+    float hidden2_gradient[L3];
+    gradients.outputBias += output_gradient;
+    for (uint32_t j = 0; j < L3; j++) {
+        const bool active = hidden2[j] > 0.0f && hidden2[j] < 1.0f;
+        gradients.outputWeights[j] += output_gradient * std::clamp(hidden2[j], 0.0f, 1.0f);
+        hidden2_gradient[j] = active ? output_gradient * network.outputWeights.value[j] : 0.0f;
+    }
+
+    float hidden1_gradient[L2] = {};
+    for (uint32_t k = 0; k < L3; k++) {
+        if (hidden2_gradient[k] == 0.0f) {
+            continue;
+        }
+        const float* row = &network.hidden2Weights.value[size_t(k) * L2];
+        float* row_gradient = &gradients.hidden2Weights[size_t(k) * L2];
+        gradients.hidden2Biases[k] += hidden2_gradient[k];
+        for (uint32_t j = 0; j < L2; j++) {
+            row_gradient[j] += hidden2_gradient[k] * std::clamp(hidden1[j], 0.0f, 1.0f);
+            hidden1_gradient[j] += hidden2_gradient[k] * row[j];
+        }
+    }
+    for (uint32_t j = 0; j < L2; j++) {
+        hidden1_gradient[j] = hidden1[j] > 0.0f && hidden1[j] < 1.0f ? hidden1_gradient[j] : 0.0f;
+    }
+
+    std::fill(accumulator_gradient, accumulator_gradient + 2U * L1, 0.0f);
+    for (uint32_t k = 0; k < L2; k++) {
+        if (hidden1_gradient[k] == 0.0f) {
+            continue;
+        }
+        const float* row = &network.hidden1Weights.value[size_t(k) * 2U * L1];
+        float* row_gradient = &gradients.hidden1Weights[size_t(k) * 2U * L1];
+        gradients.hidden1Biases[k] += hidden1_gradient[k];
+        for (uint32_t j = 0; j < 2U * L1; j++) {
+            row_gradient[j] += hidden1_gradient[k] * hidden0[j];
+            accumulator_gradient[j] += hidden1_gradient[k] * row[j];
+        }
+    }
+    for (uint32_t j = 0; j < 2U * L1; j++) {
+        const bool active = accumulator[j] > 0.0f && accumulator[j] < 1.0f;
+        accumulator_gradient[j] = active ? accumulator_gradient[j] : 0.0f;
+        gradients.featureBiases[j % L1] += accumulator_gradient[j];   // both perspectives share the transformer
+    }
+
+    return double(error) * double(error);
+}
+
+/**
+ * @brief adam_update(Parameter&, size_t, size_t, float, uint64_t, float, float)
+ *
+ * Adam step of the values [begin, end) of a parameter, the gradient is cleared.
+ *
+ * @param[in,out] parameter parameter to update.
+ * @param[in] begin first value.
+ * @param[in] end last value, not included.
+ * @param[in] learning_rate learning rate.
+ * @param[in] step number of the step, starting at 1.
+ * @param[in] min_value lower bound of the values.
+ * @param[in] max_value upper bound of the values.
+ *
+ */
+static void adam_update(Parameter& parameter, size_t begin, size_t end, float learning_rate, uint64_t step,
+                        float min_value, float max_value)
+{
+    constexpr float BETA1 = 0.9f;
+    constexpr float BETA2 = 0.999f;
+    constexpr float EPSILON = 1e-8f;
+
+    const float correction1 = 1.0f - std::pow(BETA1, float(step));
+    const float correction2 = 1.0f - std::pow(BETA2, float(step));
+    const float step_size = learning_rate * std::sqrt(correction2) / correction1;
+
+    for (size_t i = begin; i < end; i++) {
+        const float gradient = parameter.gradient[i];
+        parameter.firstMoment[i] = BETA1 * parameter.firstMoment[i] + (1.0f - BETA1) * gradient;
+        parameter.secondMoment[i] = BETA2 * parameter.secondMoment[i] + (1.0f - BETA2) * gradient * gradient;
+        parameter.value[i] -= step_size * parameter.firstMoment[i] / (std::sqrt(parameter.secondMoment[i]) + EPSILON);
+        parameter.value[i] = std::clamp(parameter.value[i], min_value, max_value);
+        parameter.gradient[i] = 0.0f;
+    }
+}
+
+/**
+ * @brief quantize(const FloatNetwork&)
+ *
+ * @param[in] network float network.
+ *
+ * @return (std::unique_ptr<NnueNetwork>) quantized network, see NnueNetwork.
+ *
+ */
+static std::unique_ptr<NnueNetwork> quantize(const FloatNetwork& network)
+{
+    std::unique_ptr<NnueNetwork> quantized = std::make_unique<NnueNetwork>();
+
+    constexpr float ACTIVATION = NnueNetwork::ACTIVATION_SCALE;
+    constexpr float WEIGHT = NnueNetwork::WEIGHT_SCALE;
+
+    auto to_int16 = [](float value) {
+        return static_cast<int16_t>(std::clamp(std::round(value * ACTIVATION), -32767.0f, 32767.0f));
+    };
+    auto to_int8 = [](float value) {
+        return static_cast<int8_t>(std::clamp(std::round(value * WEIGHT), -127.0f, 127.0f));
+    };
+    auto to_int32 = [](float value) { return static_cast<int32_t>(std::round(value * ACTIVATION * WEIGHT)); };
+
+    std::transform(network.featureBiases.value.begin(), network.featureBiases.value.end(),
+                   quantized->featureBiases, to_int16);
+    std::transform(network.featureWeights.value.begin(), network.featureWeights.value.end(),
+                   quantized->featureWeights, to_int16);
+    std::transform(network.hidden1Biases.value.begin(), network.hidden1Biases.value.end(),
+                   quantized->hidden1Biases, to_int32);
+    std::transform(network.hidden1Weights.value.begin(), network.hidden1Weights.value.end(),
+                   quantized->hidden1Weights, to_int8);
+    std::transform(network.hidden2Biases.value.begin(), network.hidden2Biases.value.end(),
+                   quantized->hidden2Biases, to_int32);
+    std::transform(network.hidden2Weights.value.begin(), network.hidden2Weights.value.end(),
+                   quantized->hidden2Weights, to_int8);
+    quantized->outputBias = to_int32(network.outputBias.value[0]);
+    std::transform(network.outputWeights.value.begin(), network.outputWeights.value.end(),
+                   quantized->outputWeights, to_int8);
+
+    return quantized;
+}
+
+/**
+ * @brief parallel_for(int, Function)
+ *
+ * Run function(thread) in threads threads and wait for all of them.
+ *
+ * @param[in] threads number of threads.
+ * @param[in] function work of each thread, receives the thread index.
+ *
+ */
+template<typename Function>
+static void parallel_for(int threads, Function function)
+{
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    for (int thread = 1; thread < threads; thread++) {
+        workers.emplace_back(function, thread);
+    }
+    function(0);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
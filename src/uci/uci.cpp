@@ -10,14 +10,34 @@
  */
 
 #include "uci.hpp"
+#include "uci_output.hpp"
 #include "history.hpp"
 #include "evaluation.hpp"
 #include "move_generator.hpp"
 #include "perft.hpp"
+#include "mate_search.hpp"
 #include "transposition_table.hpp"
+#include "pawn_structure.hpp"
+#include "eval_cache.hpp"
+#include "nnue.hpp"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 
+/**
+ * @brief steady_clock_us()
+ * 
+ * @return (int64_t) microseconds of the steady clock.
+ * 
+ */
+static int64_t steady_clock_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 /**
  * @brief Start position in FEN format.
  *
@@ -27,6 +47,41 @@
  */
 constexpr auto StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
+/**
+ * @brief Uci
+ * 
+ * Uci constructor, starts the output writer and the search and reader threads that wait for the go commands.
+ * 
+ */
+Uci::Uci()
+{
+    UciOutput::start();
+    searchThread = std::thread(&Uci::search_worker, this);
+    readerThread = std::thread(&Uci::reader_worker, this);
+}
+
+/**
+ * @brief ~Uci
+ * 
+ * Uci destructor, stops the search, finishes the threads and writes the pending output.
+ * 
+ */
+Uci::~Uci()
+{
+    stop_command_action();
+
+    {
+        std::lock_guard<std::mutex> lock(workersMutex);
+        quitWorkers = true;
+    }
+    workersCv.notify_all();
+
+    searchThread.join();
+    readerThread.join();
+
+    UciOutput::stop();
+}
+
 /**
  * @brief loop
  * 
@@ -35,8 +90,6 @@ constexpr auto StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -
  */
 void Uci::loop()
 {
-    static TokenArray tokens;
-
     std::string line;
 
     bool exit = false;
@@ -46,84 +99,102 @@ void Uci::loop()
     do {
         std::getline(std::cin, line);
 
-        if (line.empty()) {
-            continue;
-        }
+        exit = !execute_command(line);
 
-        size_t num_tokens = 0;
-        size_t pos = 0;
-        while (pos < line.length() && num_tokens < TOKEN_ARRAY_SIZE) {
-            size_t start = pos;
-            while (pos < line.length() && line[pos] != ' ')
-                ++pos;
-            if (pos > start) {
-                tokens[num_tokens++] = std::string_view(line.data() + start, pos - start);
-            }
-            while (pos < line.length() && line[pos] == ' ')
-                ++pos;
-        }
-        if (num_tokens == 0) continue;
+        // the response of the command is written before reading the next one
+        UciOutput::flush();
 
-        if (tokens.empty()) {
-            continue;
-        }
+    } while (!exit);
+}
 
-        std::string_view command = tokens[0];
+/**
+ * @brief execute_command
+ * 
+ * Parse the command line and run the action of the command.
+ * 
+ */
+bool Uci::execute_command(std::string_view line)
+{
+    static TokenArray tokens;
 
-        if (command == "uci") {
-            uci_command_action();
-        }
-        else if (command == "isready") {
-            is_ready_command_action();
+    size_t num_tokens = 0;
+    size_t pos = 0;
+    while (pos < line.length() && num_tokens < TOKEN_ARRAY_SIZE) {
+        size_t start = pos;
+        while (pos < line.length() && line[pos] != ' ')
+            ++pos;
+        if (pos > start) {
+            tokens[num_tokens++] = line.substr(start, pos - start);
         }
-        else if (command == "ucinewgame") {
-            new_game_command_action();
-        }
-        else if (command == "g" || command == "go") {
-            go_command_action(tokens, num_tokens);
-        }
-        else if (command == "s" || command == "stop") {
-            stop_command_action();
-        }
-        else if (command == "ponderhit") {
-            ponderhit_command_action();
-        }
-        else if (command == "e" || command == "eval") {
-            eval_command_action();
-        }
-        else if (command == "perft") {
-            try {
-                uint64_t depth = stoull(std::string(tokens[1]));
-                perft_command_action(depth);
-            } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : perft depth\n";
-            }
-        }
-        else if (command == "p" || command == "position") {
-            if (!position_command_action(tokens, num_tokens)) {
-                std::cout << "error in setting the position\n";
-            }
-        }
-        else if (command == "setoption") {
-            if (!setoption_command_action(tokens, num_tokens)) {
-                std::cout << "error in setoption command\n";
-            }
-        }
-        else if (command == "d" || command == "diagram") {
-            diagram_command_action();
-        }
-        else if (command == "h" || command == "help") {
-            help_command_action();
+        while (pos < line.length() && line[pos] == ' ')
+            ++pos;
+    }
+    if (num_tokens == 0) {
+        return true;
+    }
+
+    std::string_view command = tokens[0];
+
+    if (command == "uci") {
+        uci_command_action();
+    }
+    else if (command == "isready") {
+        is_ready_command_action();
+    }
+    else if (command == "ucinewgame") {
+        new_game_command_action();
+    }
+    else if (command == "g" || command == "go") {
+        go_command_action(tokens, num_tokens);
+    }
+    else if (command == "s" || command == "stop") {
+        stop_command_action();
+    }
+    else if (command == "ponderhit") {
+        ponderhit_command_action();
+    }
+    else if (command == "e" || command == "eval") {
+        eval_command_action();
+    }
+    else if (command == "perft") {
+        try {
+            uint64_t depth = stoull(std::string(tokens[1]));
+            perft_command_action(depth);
+        } catch (const std::exception& e) {
+            uci_out() << "Invalid argument for command : perft depth\n";
         }
-        else if (command == "q" || command == "quit" || command == "exit") {
-            quit_command_action();
-            exit = true;
+    }
+    else if (command == "p" || command == "position") {
+        if (!position_command_action(tokens, num_tokens)) {
+            uci_out() << "error in setting the position\n";
         }
-        else {
-            unknown_command_action();
+    }
+    else if (command == "setoption") {
+        if (!setoption_command_action(tokens, num_tokens)) {
+            uci_out() << "error in setoption command\n";
         }
+    }
+    else if (command == "d" || command == "diagram") {
+        diagram_command_action();
+    }
+    else if (command == "stats") {
+        stats_command_action();
+    }
+    else if (command == "latency") {
+        latency_command_action(tokens, num_tokens);
+    }
+    else if (command == "h" || command == "help") {
+        help_command_action();
+    }
+    else if (command == "q" || command == "quit" || command == "exit") {
+        quit_command_action();
+        return false;
+    }
+    else {
+        unknown_command_action();
+    }
 
-    } while (!exit);
+    return true;
 }
 
 /**
@@ -137,9 +208,17 @@ void Uci::loop()
  */
 void Uci::uci_command_action() const
 {
-    std::cout << "id name AlphaDeepChess" << "\n";
-    std::cout << "id author Juan Giron and Laura Wang" << "\n";
-    std::cout << "uciok" << std::endl;
+    uci_out() << "id name AlphaDeepChess" << "\n";
+    uci_out() << "id author Juan Giron and Laura Wang" << "\n";
+    uci_out() << "option name Ponder type check default false\n";
+    uci_out() << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTI_PV << "\n";
+    uci_out() << "option name Move Overhead type spin default " << TimeManager::DEFAULT_MOVE_OVERHEAD << " min 0 max "
+              << TimeManager::MAX_MOVE_OVERHEAD << "\n";
+    uci_out() << "option name EvalFile type string default <empty>\n";
+    print_combo_option<SearchAlgorithm>("SearchAlgorithm", AlgorithmSelection::DEFAULT_SEARCH);
+    print_combo_option<EvaluationAlgorithm>("Evaluation", AlgorithmSelection::DEFAULT_EVALUATION);
+    print_combo_option<MoveGeneratorAlgorithm>("MoveGen", AlgorithmSelection::DEFAULT_MOVE_GENERATOR);
+    uci_out() << "uciok" << std::endl;
 }
 
 /**
@@ -151,7 +230,7 @@ void Uci::uci_command_action() const
  * Responds with "readyok"
  * 
  */
-void Uci::is_ready_command_action() const { std::cout << "readyok" << std::endl; }
+void Uci::is_ready_command_action() const { uci_out() << "readyok" << std::endl; }
 
 /**
  * @brief new_game_command_action
@@ -164,6 +243,8 @@ void Uci::new_game_command_action()
     board.load_fen(StartFEN);
     History::clear();
     History::push_position(board.state().get_zobrist_key());
+    positionFen = StartFEN;
+    positionMoves.clear();
 }
 
 /**
@@ -178,7 +259,11 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
     stop_command_action();
 
     uint32_t depth = INF_DEPTH;
-    uint32_t movetime = 0, wtime = 0, btime = 0, winc = 0, binc = 0;
+    uint64_t nodes = 0ULL;
+    int mate = 0;
+    bool ponder = false;
+    MoveList search_moves;
+    uint32_t movetime = 0, wtime = 0, btime = 0, winc = 0, binc = 0, movestogo = 0;
 
     // Parse the command line arguments
     for (uint32_t i = 1; i < num_tokens; ++i) {
@@ -189,7 +274,7 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 movetime = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -197,7 +282,7 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 wtime = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -205,7 +290,7 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 btime = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -213,7 +298,7 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 winc = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -221,7 +306,7 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 binc = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -229,7 +314,23 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             try {
                 depth = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
+                return;
+            }
+        }
+        else if (tokens[i] == "nodes") {
+            try {
+                nodes = std::stoull(std::string(tokens[++i]));
+            } catch (const std::exception& e) {
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
+                return;
+            }
+        }
+        else if (tokens[i] == "mate") {
+            try {
+                mate = std::stoi(std::string(tokens[++i]));
+            } catch (const std::exception& e) {
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
                 return;
             }
         }
@@ -237,117 +338,299 @@ void Uci::go_command_action(const TokenArray& tokens, uint32_t num_tokens)
             depth = INF_DEPTH;
         }
         else if (tokens[i] == "ponder") {
-            //pondering.store(true);
+            ponder = true;
         }
         else if (tokens[i] == "perft") {
             try {
                 depth = std::stoul(std::string(tokens[++i]));
             } catch (const std::exception& e) {
-                std::cout << "Invalid argument for command : go " << tokens[2] << "\n";
+                uci_out() << "Invalid argument for command : go " << tokens[2] << "\n";
             }
             perft_command_action(depth);
             return;
         }
-        else if (tokens[i] == "movestogo" || tokens[i] == "nodes" || tokens[i] == "mate") {
-            std::cout << "Ignored argument for go: " << tokens[i] << " " << tokens[i] << "\n";
-            i += 1;
+        else if (tokens[i] == "searchmoves") {
+            // read moves until the next argument of the go command
+            while (i + 1 < num_tokens) {
+                const Move move = create_move_from_string(tokens[i + 1], board);
+                if (!move.is_valid()) {
+                    break;
+                }
+                search_moves.add(move);
+                i++;
+            }
+        }
+        else if (tokens[i] == "movestogo") {
+            try {
+                movestogo = std::stoul(std::string(tokens[++i]));
+            } catch (const std::exception& e) {
+                uci_out() << "Invalid argument for command : go " << tokens[i] << "\n";
+                return;
+            }
         }
         else {
-            std::cout << "Invalid argument for command : go " << tokens[i] << "\n";
+            uci_out() << "Invalid argument for command : go " << tokens[i] << "\n";
             return;
         }
     }
 
     const ChessColor side_to_move = board.state().side_to_move();
 
-    // Launch a new thread to search for the best move
-    searchThread = std::thread([this, depth]() { search(stop_signal, searchResults, board, depth); });
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.multiPV = multiPV;
+    limits.searchMoves = search_moves;
+    limits.nodes = nodes;
+    limits.mate = mate;
 
-    readerThread = std::thread([this]() {
-        uint32_t depthReaded = 0;
+    if (movetime != 0 || wtime != 0 || btime != 0) {
+        // the clock of the side to move, while pondering the clock starts on ponderhit
+        const bool white = is_white(side_to_move);
+        timeManager.init(white ? wtime : btime, white ? winc : binc, movestogo, movetime, moveOverhead, ponder);
+        limits.timeManager = &timeManager;
+    }
 
-        while (!stop_signal || (depthReaded < searchResults.depthReached)) {
+    // go ponder, search the expected position on the opponent time until ponderhit or stop
+    pondering.store(ponder);
+    stopRequestTime.store(0);
 
-            while (depthReaded < searchResults.depthReached) {
-                const SearchResult& result = searchResults.results[depthReaded++];
+    PawnHashTable::clear_stats();
+    EvalCache::clear_stats();
+    LazyEvaluation::clear_stats();
 
-                std::cout << "info depth " << result.depth << " score cp " << result.evaluation << " bestMove "
-                          << Move(result.bestMove_data).to_string() << std::endl;
-            }
+    // wake up the search and reader threads with the new search job
+    {
+        std::lock_guard<std::mutex> lock(workersMutex);
+        jobLimits = limits;
+        searchResults.searchFinished = false;
+        activeWorkers = 2;
+        jobId++;
+    }
+    workersCv.notify_all();
+}
+
+/**
+ * @brief stop_command_action
+ * 
+ * Stops the search in the searchThread.
+ * 
+ */
+void Uci::stop_command_action()
+{
+    std::unique_lock<std::mutex> lock(workersMutex);
 
-            {
-                std::unique_lock<std::mutex> lock(searchResults.mtx_data_available_cv);
+    if (activeWorkers > 0 && !stop_signal.load()) {
+        stopRequestTime.store(steady_clock_us());   // the search is running, measure the stop latency
+    }
+    stop_signal.store(true);
 
-                if (!stop_signal && depthReaded >= searchResults.depthReached) {
-                    // thread goes to sleep until more data is available or search stop
-                    searchResults.data_available_cv.wait(lock);
-                }
-            }
+    {
+        std::lock_guard<std::mutex> ponderhit_lock(ponderhitMutex);
+        pondering.store(false);
+    }
+    ponderhitCv.notify_all();
+
+    // wait until the search and reader threads finish the search job
+    workersIdleCv.wait(lock, [this] { return activeWorkers == 0; });
+
+    stop_signal.store(false);
+}
+
+/**
+ * @brief search_worker
+ * 
+ * Loop of the search thread, waits for a search job and searches the best move.
+ * 
+ */
+void Uci::search_worker()
+{
+    uint64_t last_job = 0ULL;
+    SearchLimits limits;
+
+    while (wait_job(last_job, limits)) {
+        // the best move, or the dedicated mate search
+        if (limits.mate > 0) {
+            MateSearch::search(stop_signal, searchResults, board, limits);
+        }
+        else {
+            search(stop_signal, searchResults, board, limits);
         }
+        job_finished();
+    }
+}
+
+/**
+ * @brief reader_worker
+ * 
+ * Loop of the reader thread, waits for a search job and prints the search output.
+ * 
+ */
+void Uci::reader_worker()
+{
+    uint64_t last_job = 0ULL;
+    SearchLimits limits;
+
+    while (wait_job(last_job, limits)) {
+        print_search_results(limits);
+        job_finished();
+    }
+}
+
+/**
+ * @brief wait_job(uint64_t&, SearchLimits&)
+ * 
+ * Sleep until there is a new search job or the threads must finish.
+ * 
+ * @param[in, out] last_job number of the last job run by the thread.
+ * @param[out] limits limits of the new job.
+ * 
+ * @return false if the thread must finish.
+ * 
+ */
+bool Uci::wait_job(uint64_t& last_job, SearchLimits& limits)
+{
+    std::unique_lock<std::mutex> lock(workersMutex);
+
+    workersCv.wait(lock, [this, last_job] { return quitWorkers || jobId != last_job; });
+
+    if (quitWorkers) {
+        return false;
+    }
+    last_job = jobId;
+    limits = jobLimits;
+    return true;
+}
+
+/**
+ * @brief job_finished
+ * 
+ * Called by the search and reader threads when they finish the search job.
+ * 
+ */
+void Uci::job_finished()
+{
+    {
+        std::lock_guard<std::mutex> lock(workersMutex);
+        activeWorkers--;
+    }
+    workersIdleCv.notify_all();
+}
+
+/**
+ * @brief print_search_results(const SearchLimits&)
+ * 
+ * Prints the info lines of the search while it runs and the bestmove when it finishes.
+ * 
+ * @param[in] limits limits of the search job, the options changed during the search do not apply to it.
+ * 
+ */
+void Uci::print_search_results(const SearchLimits& limits)
+{
+    SearchInfo info;
+    bool finished = false;
 
-        if (pondering.load()) {
-            std::unique_lock<std::mutex> lock(ponderhitMutex);
+    while (!finished) {
+        // read the flag before draining, the information sent before the end of the search is in the ring
+        finished = searchResults.searchFinished.load(std::memory_order_acquire);
 
-            ponderhitCv.wait(lock);
+        while (searchResults.infos.pop(info)) {
+            print_search_info(info, limits.multiPV);
         }
 
-        std::cout << "bestmove " << Move(searchResults.results[depthReaded - 1].bestMove_data).to_string() << std::endl;
-        //std::cout << " ponder " << Move(searchResults.ponderMove_data).to_string() << std::endl;
+        if (!finished) {
+            // thread goes to sleep until more data is available or the search finishes
+            wait_data_available(searchResults);
+        }
+    }
 
-        searchResults.depthReached = 0;   // reset depthReached when we consume all data
-    });
+    {
+        // the best move can not be sent while pondering, even if the search has finished
+        std::unique_lock<std::mutex> lock(ponderhitMutex);
 
-    if (movetime != 0 || wtime != 0 || btime != 0) {
-        timerThread = std::thread([this, side_to_move, movetime, wtime, btime, winc, binc]() {
-            if (pondering.load()) {
-                std::unique_lock<std::mutex> lock(ponderhitMutex);
+        ponderhitCv.wait(lock, [this] { return !pondering.load(); });
+    }
 
-                ponderhitCv.wait(lock);
-            }
-            {
-                std::unique_lock<std::mutex> lock(timerMutex);
+    // the best move is taken from the last completed first line
+    const SearchInfo& best_line = searchResults.bestLine;
+
+    if (best_line.pvLength == 0) {
+        // the mate search did not find a mate, there is no result
+        uci_out() << "info string no mate in " << limits.mate << " found" << std::endl;
+        uci_out() << "bestmove 0000" << std::endl;
+        return;
+    }
 
-                const uint32_t time = think_time(side_to_move, movetime, wtime, btime, winc, binc);
+    uci_out() << "bestmove " << best_line.move.to_string();
 
-                // Wait for n milliseconds or until search_stopped becomes true
-                if (!timerCv.wait_for(lock, std::chrono::milliseconds(time),
-                                      [this] { return this->stop_signal.load(); })) {
-                    // Timeout occurred and search_stopped is still false
-                    lock.unlock();   // Unlock before calling stop_search()
-                    stop_signal.store(true);
-                }
-            }
-        });
+    // the ponder move is the second move of the principal variation
+    if (best_line.pvLength >= 2) {
+        uci_out() << " ponder " << best_line.pv[1].to_string();
+    }
+    uci_out() << std::endl;
+
+    // stop to bestmove latency, from the stop command or from the end of the maximum time
+    const int64_t now_us = steady_clock_us();
+    int64_t stop_us = stopRequestTime.load();
+
+    if (stop_us == 0 && limits.timeManager != nullptr && timeManager.hard_limit_reached()) {
+        stop_us = std::chrono::duration_cast<std::chrono::microseconds>(timeManager.deadline().time_since_epoch())
+                      .count();
+    }
+    if (stop_us != 0) {
+        stopLatency.record(static_cast<uint64_t>(std::max<int64_t>(now_us - stop_us, 0)));
     }
 }
 
 /**
- * @brief stop_command_action
+ * @brief print_search_info(const SearchInfo&, int)
  * 
- * Stops the search in the searchThread.
+ * Prints one info line of the search.
+ * 
+ * @param[in] info information sent by the search.
+ * @param[in] multi_pv number of principal variations of the search job.
  * 
  */
-void Uci::stop_command_action()
+void Uci::print_search_info(const SearchInfo& info, int multi_pv) const
 {
-    stop_signal.store(true);
+    uci_out() << "info depth " << info.depth;
 
-    timerCv.notify_one();
+    if (info.type == SearchInfo::Type::CURRMOVE) {
+        uci_out() << " currmove " << info.move.to_string() << " currmovenumber " << info.currMoveNumber << std::endl;
+        return;
+    }
 
-    pondering.store(false);
-    ponderhitCv.notify_all();
+    uci_out() << " seldepth " << info.selDepth;
 
-    if (searchThread.joinable()) {
-        searchThread.join();
+    if (multi_pv > 1) {
+        uci_out() << " multipv " << int(info.multiPV);
     }
+    const uint64_t nps = info.nodes * 1000ULL / std::max<uint64_t>(info.time, 1ULL);
 
-    if (readerThread.joinable()) {
-        readerThread.join();
+    const int evaluation = info.evaluation;
+
+    if (std::abs(evaluation) >= MATE_THRESHOLD) {
+        // moves to mate, the mated king is at ply MATE_IN_ONE_SCORE - |evaluation|
+        const int mate_moves = (MATE_IN_ONE_SCORE - std::abs(evaluation) + 1) / 2;
+        uci_out() << " score mate " << (evaluation > 0 ? mate_moves : -mate_moves);
+    }
+    else {
+        uci_out() << " score cp " << evaluation;
     }
 
-    if (timerThread.joinable()) {
-        timerThread.join();
+    if (info.bound == ScoreBound::LOWER) {
+        uci_out() << " lowerbound";
     }
-    stop_signal.store(false);
+    else if (info.bound == ScoreBound::UPPER) {
+        uci_out() << " upperbound";
+    }
+
+    uci_out() << " nodes " << info.nodes << " nps " << nps << " hashfull " << info.hashfull << " time " << info.time
+              << " pv";
+
+    for (int i = 0; i < info.pvLength; i++) {
+        uci_out() << " " << info.pv[i].to_string();
+    }
+    uci_out() << std::endl;
 }
 
 /**
@@ -356,7 +639,7 @@ void Uci::stop_command_action()
  * Evaluate chess position.
  * 
  */
-void Uci::eval_command_action() { std::cout << "Evaluation: " << evaluate_position(board) << std::endl; }
+void Uci::eval_command_action() { uci_out() << "Evaluation: " << evaluate_position(board) << std::endl; }
 
 /**
  * @brief position_command_action
@@ -371,6 +654,9 @@ void Uci::eval_command_action() { std::cout << "Evaluation: " << evaluate_positi
  *	Note: no "new" command is needed. However, if this position is from a different game than
  *	the last position sent to the engine, the GUI should have sent a "ucinewgame" inbetween.
  *
+ * If the new position continues the game of the board (same fen and the moves of the board are a prefix
+ * of the new moves) only the new moves are played, otherwise the board is rebuilt.
+ *
  * @param[in] tokens buffer array with the user input tokens.
  * @param[in] num_tokens number of tokens.
  * 
@@ -386,11 +672,10 @@ bool Uci::position_command_action(const TokenArray& tokens, uint32_t num_tokens)
     stop_command_action();
 
     uint32_t token_i = 1;
+    std::string fen;
 
     if (tokens[token_i] == "startpos") {
-        board.load_fen(StartFEN);
-        History::clear();
-        History::push_position(board.state().get_zobrist_key());
+        fen = StartFEN;
         token_i++;
     }
     else if (tokens[token_i] == "actualpos") {
@@ -402,7 +687,6 @@ bool Uci::position_command_action(const TokenArray& tokens, uint32_t num_tokens)
             return false;
         }
         // parse the fen
-        std::string fen;
         fen.reserve(100);   // 100 characters for a fen is enough
 
         while (token_i < num_tokens && tokens[token_i] != "moves") {
@@ -413,29 +697,45 @@ bool Uci::position_command_action(const TokenArray& tokens, uint32_t num_tokens)
         }
 
         fen.pop_back();   // remove last " "
-
-        board.load_fen(fen);
-        History::clear();
-        History::push_position(board.state().get_zobrist_key());
     }
     else {
         return false;
     }
 
-    // parse moves
-    if (token_i < num_tokens && tokens[token_i++] == "moves") {
+    uint32_t first_move_i = num_tokens;
+    if (token_i < num_tokens && tokens[token_i] == "moves") {
+        first_move_i = token_i + 1;
+    }
 
-        MoveList move_list;
-        while (token_i < num_tokens) {
-            Move move = create_move_from_string(tokens[token_i++], board);
-            if (!move.is_valid()) {
-                return false;
-            }
-            board.make_move(move);
+    // actualpos keeps the board and plays all the moves
+    if (tokens[1] != "actualpos") {
+        // the gui sends the whole game before every go, if the game of the board is a prefix of the
+        // new game only the last moves are played, otherwise the board is rebuilt from the fen
+        const uint32_t num_moves = num_tokens - first_move_i;
+        const bool extends_game = !positionFen.empty() && fen == positionFen &&
+                                  positionMoves.size() <= num_moves &&
+                                  std::equal(positionMoves.begin(), positionMoves.end(), tokens.begin() + first_move_i);
+
+        if (!extends_game) {
+            board.load_fen(fen);
+            History::clear();
             History::push_position(board.state().get_zobrist_key());
+            positionFen = fen;
+            positionMoves.clear();
         }
+        first_move_i += positionMoves.size();
     }
 
+    // parse moves
+    for (token_i = first_move_i; token_i < num_tokens; token_i++) {
+        Move move = create_move_from_string(tokens[token_i], board);
+        if (!move.is_valid()) {
+            return false;
+        }
+        board.make_move(move);
+        History::push_position(board.state().get_zobrist_key());
+        positionMoves.emplace_back(tokens[token_i]);
+    }
 
     return true;
 }
@@ -446,7 +746,60 @@ bool Uci::position_command_action(const TokenArray& tokens, uint32_t num_tokens)
  * Prints the board and fen of the position.
  * 
  */
-void Uci::diagram_command_action() const { std::cout << board << std::endl; }
+void Uci::diagram_command_action() const { uci_out() << board << std::endl; }
+
+/**
+ * @brief stats_command_action
+ * 
+ * Prints the statistics of the last search.
+ * 
+ */
+void Uci::stats_command_action() const
+{
+    const uint64_t nodes = searchResults.nodes;
+    const uint64_t best_move_nodes = searchResults.bestMoveNodes;
+    const uint64_t probcut_cutoffs = searchResults.probcutCutoffs;
+    const double best_move_percentage = nodes ? 100.0 * double(best_move_nodes) / double(nodes) : 0.0;
+    const double probcut_percentage = nodes ? 100.0 * double(probcut_cutoffs) / double(nodes) : 0.0;
+    const uint64_t pawn_probes = PawnHashTable::probes();
+    const uint64_t pawn_hits = PawnHashTable::hits();
+    const double pawn_hit_percentage = pawn_probes ? 100.0 * double(pawn_hits) / double(pawn_probes) : 0.0;
+    const uint64_t eval_probes = EvalCache::probes();
+    const uint64_t eval_hits = EvalCache::hits();
+    const double eval_hit_percentage = eval_probes ? 100.0 * double(eval_hits) / double(eval_probes) : 0.0;
+    const uint64_t evaluations = eval_probes - eval_hits;
+    const uint64_t lazy_exits = LazyEvaluation::exits();
+    const double lazy_percentage = evaluations ? 100.0 * double(lazy_exits) / double(evaluations) : 0.0;
+
+    uci_out() << "Nodes searched: " << nodes << "\n"
+              << "Best move nodes: " << best_move_nodes << " (" << best_move_percentage << "% of nodes)\n"
+              << "ProbCut cutoffs: " << probcut_cutoffs << " (" << probcut_percentage << "% of nodes)\n"
+              << "Pawn hash probes: " << pawn_probes << "\n"
+              << "Pawn hash hits: " << pawn_hits << " (" << pawn_hit_percentage << "% of probes)\n"
+              << "Eval cache probes: " << eval_probes << "\n"
+              << "Eval cache hits: " << eval_hits << " (" << eval_hit_percentage << "% of probes, "
+              << eval_hits << " evaluations saved)\n"
+              << "Lazy evaluation exits: " << lazy_exits << " (" << lazy_percentage << "% of evaluations)" << std::endl;
+}
+
+/**
+ * @brief latency_command_action
+ * 
+ * Prints the histogram of the stop to bestmove latency, with clear the histogram is reset.
+ * 
+ * @param[in] tokens buffer array with the user input tokens.
+ * @param[in] num_tokens number of tokens.
+ * 
+ */
+void Uci::latency_command_action(const TokenArray& tokens, uint32_t num_tokens)
+{
+    if (num_tokens > 1 && tokens[1] == "clear") {
+        stopLatency.clear();
+        return;
+    }
+
+    uci_out() << "Stop to bestmove latency: " << stopLatency << std::flush;
+}
 
 /**
  * @brief help_command_action
@@ -456,7 +809,7 @@ void Uci::diagram_command_action() const { std::cout << board << std::endl; }
  */
 void Uci::help_command_action() const
 {
-    std::cout << "Commands:\n"
+    uci_out() << "Commands:\n"
                  "----------------------------------------\n"
                  "uci\n"
                  "\tTell engine to use the UCI (Universal Chess Interface).\n"
@@ -477,13 +830,28 @@ void Uci::help_command_action() const
 
                  "go [depth <depth> | infinite | perft <perft_depth>]\n"
                  "[wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>] [movetime <ms>]\n"
-                 "[nodes <x>] [mate <x>] [movestogo <x>]\n"
+                 "[nodes <x>] [mate <x>] [movestogo <x>] [searchmoves <move1> ... <movei>] [ponder]\n"
                  "\tStart calculating the best move until the specified depth.\n"
+                 "\tWith nodes the search stops after visiting the given number of nodes.\n"
+                 "\tWith mate the mate search finds the shortest forced mate in <x> moves.\n"
+                 "\tWith wtime/btime the clock is split between the movestogo moves (default 40).\n"
+                 "\tWith ponder the search runs on the opponent time until ponderhit or stop.\n"
                  "\tIn order to finish search use stop command, \n\n"
 
                  "setoption name <id> value <value>\n"
                  "\tChange internal parameters of the chess engine \n"
-                 "\t\tsetoption name Hash value <hash_table_size_mb_power_of_two>\n\n"
+                 "\t\tsetoption name Hash value <hash_table_size_mb_power_of_two>\n"
+                 "\t\tsetoption name MultiPV value <number_of_lines>\n"
+                 "\t\tsetoption name Move Overhead value <ms>\n"
+                 "\t\tsetoption name Ponder value <true|false>\n"
+                 "\t\tsetoption name MateHash value <mate_table_size_mb_power_of_two>\n"
+                 "\t\tsetoption name EvalFile value <network_file>\n"
+                 "\t\tsetoption name SearchAlgorithm value <basic|multithread|transposition_table|tt_reductions>\n"
+                 "\t\tsetoption name Evaluation value <dynamic|safety_mobility|nnue>\n"
+                 "\t\tsetoption name MoveGen value <basic|magic_bitboards>\n\n"
+
+                 "ponderhit\n"
+                 "\tThe opponent played the expected move, the ponder search continues with its time limits.\n\n"
 
                  "stop\n"
                  "\tStop calculating.\n\n"
@@ -497,6 +865,12 @@ void Uci::help_command_action() const
                  "d\n"
                  "\tDisplay the current position on the board.\n\n"
 
+                 "stats\n"
+                 "\tDisplay the statistics of the last search.\n\n"
+
+                 "latency [clear]\n"
+                 "\tDisplay the histogram of the time from stop or the end of the think time to bestmove.\n\n"
+
               << std::endl;
 }
 
@@ -509,7 +883,7 @@ void Uci::help_command_action() const
 void Uci::quit_command_action()
 {
     stop_command_action();
-    std::cout << "goodbye" << std::endl;
+    uci_out() << "goodbye" << std::endl;
 }
 
 /**
@@ -528,13 +902,13 @@ void Uci::perft_command_action(uint64_t depth) const
 
     perft(board.fen(), depth, moveNodesList, time);
 
-    std::cout << '\n';
+    uci_out() << '\n';
 
     for (const auto& moveNode : moveNodesList) {
-        std::cout << moveNode.first.to_string() << ": " << moveNode.second << std::endl;
+        uci_out() << moveNode.first.to_string() << ": " << moveNode.second << std::endl;
         nodes += moveNode.second;
     }
-    std::cout << "\nNodes searched: " << nodes << "\nExecution time: " << time << " ms" << std::endl;
+    uci_out() << "\nNodes searched: " << nodes << "\nExecution time: " << time << " ms" << std::endl;
 }
 
 /**
@@ -552,14 +926,14 @@ void Uci::perft_command_action(uint64_t depth) const
 bool Uci::setoption_command_action(const TokenArray& tokens, uint32_t num_tokens)
 {
     if (num_tokens < 3) {
-        std::cout << "Invalid setoption argument: setoption name <id> value\n";
+        uci_out() << "Invalid setoption argument: setoption name <id> value\n";
         return false;
     }
     uint32_t token_i = 1;
 
     if (tokens[token_i++] != "name")
     {
-        std::cout << "Invalid setoption argument: setoption name <id> value\n";
+        uci_out() << "Invalid setoption argument: setoption name <id> value\n";
         return false;
     }
     
@@ -567,7 +941,7 @@ bool Uci::setoption_command_action(const TokenArray& tokens, uint32_t num_tokens
 
         if (tokens[token_i++] != "value")
         {
-            std::cout << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
+            uci_out() << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
             return false;
         }
 
@@ -579,22 +953,170 @@ bool Uci::setoption_command_action(const TokenArray& tokens, uint32_t num_tokens
                 TranspositionTable::resize(size_tt);
             }
             else {
-                std::cout << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
+                uci_out() << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
+            }
+
+        } catch (const std::exception& e) {
+            uci_out() << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
+            return false;
+        }
+    }
+    else if (tokens[token_i - 1] == "MateHash") {
+
+        if (tokens[token_i++] != "value") {
+            uci_out() << "Invalid setoption MateHash argument: setoption name MateHash value <mb_power_of_two>\n";
+            return false;
+        }
+
+        try {
+            const int size_mb = std::stoi(std::string(tokens[token_i++]));
+
+            if (size_mb <= 0 || !is_power_of_two(static_cast<uint64_t>(size_mb))) {
+                uci_out() << "Invalid setoption MateHash argument: setoption name MateHash value <mb_power_of_two>\n";
+                return false;
             }
+            MateSearch::resize(size_mb);
 
         } catch (const std::exception& e) {
-            std::cout << "Invalid setoption Hash argument: setoption name Hash value <hash_table_size_mb_power_of_two>\n";
+            uci_out() << "Invalid setoption MateHash argument: setoption name MateHash value <mb_power_of_two>\n";
             return false;
         }
     }
+    else if (tokens[token_i - 1] == "Ponder") {
+        // pondering is controlled by the gui with go ponder and ponderhit, the option only enables it in the gui
+        if (tokens[token_i++] != "value" || (tokens[token_i] != "true" && tokens[token_i] != "false")) {
+            uci_out() << "Invalid setoption Ponder argument: setoption name Ponder value <true|false>\n";
+            return false;
+        }
+    }
+    else if (tokens[token_i - 1] == "MultiPV") {
+
+        if (tokens[token_i++] != "value") {
+            uci_out() << "Invalid setoption MultiPV argument: setoption name MultiPV value <number_of_lines>\n";
+            return false;
+        }
+
+        try {
+            const int lines = std::stoi(std::string(tokens[token_i++]));
+
+            multiPV = std::clamp(lines, 1, MAX_MULTI_PV);
+
+        } catch (const std::exception& e) {
+            uci_out() << "Invalid setoption MultiPV argument: setoption name MultiPV value <number_of_lines>\n";
+            return false;
+        }
+    }
+    else if (tokens[token_i - 1] == "Move" && tokens[token_i++] == "Overhead") {
+
+        if (tokens[token_i++] != "value") {
+            uci_out() << "Invalid setoption Move Overhead argument: setoption name Move Overhead value <ms>\n";
+            return false;
+        }
+
+        try {
+            const int overhead = std::stoi(std::string(tokens[token_i++]));
+
+            moveOverhead = static_cast<uint32_t>(std::clamp(overhead, 0, int(TimeManager::MAX_MOVE_OVERHEAD)));
+
+        } catch (const std::exception& e) {
+            uci_out() << "Invalid setoption Move Overhead argument: setoption name Move Overhead value <ms>\n";
+            return false;
+        }
+    }
+    else if (tokens[token_i - 1] == "EvalFile") {
+
+        if (tokens[token_i++] != "value" || token_i >= num_tokens) {
+            uci_out() << "Invalid setoption EvalFile argument: setoption name EvalFile value <network_file>\n";
+            return false;
+        }
+
+        // the path may contain spaces
+        std::string path(tokens[token_i++]);
+        while (token_i < num_tokens) {
+            path += " " + std::string(tokens[token_i++]);
+        }
+
+        if (path == "<empty>") {
+            return true;
+        }
+        if (!Nnue::load(path)) {
+            uci_out() << "info string invalid network file " << path << "\n";
+            return false;
+        }
+        uci_out() << "info string network loaded from " << path << "\n";
+    }
+    else if (tokens[token_i - 1] == "SearchAlgorithm") {
+        return setoption_algorithm<SearchAlgorithm>("SearchAlgorithm", tokens, num_tokens, token_i);
+    }
+    else if (tokens[token_i - 1] == "Evaluation") {
+        return setoption_algorithm<EvaluationAlgorithm>("Evaluation", tokens, num_tokens, token_i);
+    }
+    else if (tokens[token_i - 1] == "MoveGen") {
+        return setoption_algorithm<MoveGeneratorAlgorithm>("MoveGen", tokens, num_tokens, token_i);
+    }
     else {
-        std::cout << "Invalid setoption argument: setoption name <id> value\n";
+        uci_out() << "Invalid setoption argument: setoption name <id> value\n";
         return false;
     }
 
     return true;
 }
 
+/**
+ * @brief setoption_algorithm
+ *
+ * Select the algorithm of a SearchAlgorithm, Evaluation or MoveGen setoption command.
+ *
+ * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+ *
+ * @param[in] option_name name of the UCI option.
+ * @param[in] tokens buffer array with the user input tokens.
+ * @param[in] num_tokens number of tokens.
+ * @param[in] token_i index of the token after the option name.
+ *
+ *  @return
+ *      - TRUE if success.
+ *      - FALSE if error detected, probably error in user input.
+ */
+template<typename Algorithm>
+bool Uci::setoption_algorithm(std::string_view option_name, const TokenArray& tokens, uint32_t num_tokens,
+                              uint32_t token_i)
+{
+    if (token_i + 1 >= num_tokens || tokens[token_i] != "value" ||
+        !AlgorithmSelection::select_by_name<Algorithm>(tokens[token_i + 1])) {
+
+        uci_out() << "Invalid setoption " << option_name << " argument: setoption name " << option_name << " value <";
+        for (size_t i = 0; i < AlgorithmSelection::names_of<Algorithm>().size(); i++) {
+            uci_out() << (i > 0 ? "|" : "") << AlgorithmSelection::names_of<Algorithm>()[i];
+        }
+        uci_out() << ">\n";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief print_combo_option
+ *
+ * Print the UCI combo option of an algorithm selection.
+ *
+ * @tparam Algorithm [SearchAlgorithm, EvaluationAlgorithm, MoveGeneratorAlgorithm]
+ *
+ * @param[in] option_name name of the UCI option.
+ * @param[in] default_algorithm default value of the option.
+ *
+ */
+template<typename Algorithm>
+void Uci::print_combo_option(std::string_view option_name, Algorithm default_algorithm) const
+{
+    uci_out() << "option name " << option_name << " type combo default " << AlgorithmSelection::name(default_algorithm);
+    for (const std::string_view name : AlgorithmSelection::names_of<Algorithm>()) {
+        uci_out() << " var " << name;
+    }
+    uci_out() << "\n";
+}
+
 /**
  * @brief ponderhit_command_action
  * 
@@ -603,7 +1125,12 @@ bool Uci::setoption_command_action(const TokenArray& tokens, uint32_t num_tokens
  */
 void Uci::ponderhit_command_action()
 {
-    pondering.store(false);
+    timeManager.ponderhit();
+
+    {
+        std::lock_guard<std::mutex> lock(ponderhitMutex);
+        pondering.store(false);
+    }
     ponderhitCv.notify_all();
 }
 
@@ -615,7 +1142,7 @@ void Uci::ponderhit_command_action()
  */
 void Uci::unknown_command_action() const
 {
-    std::cout << "Unknown command, type help for more information" << std::endl;
+    uci_out() << "Unknown command, type help for more information" << std::endl;
 }
 
 /**
@@ -689,51 +1216,3 @@ Move Uci::create_move_from_string(std::string_view move_string, const Board& boa
     // Create and return the Move object
     return Move(sq_origin, sq_end, move_type, promo_piece);
 }
-
-/**
- * @brief calculate the time the bot has until stopping the search
- * 
- * @note pass 0 to not provide an argument
- * 
- * @param[in] us side to move
- * @param[in] movetime explicit think time (if provided it will be the think time)
- * @param[in] wtime white total time
- * @param[in] btime black total time
- * @param[in] winc white time increment per move
- * @param[in] binc black time increment per move
- * 
- *  @return (uint32_t) time to think
- * 
- */
-uint32_t Uci::think_time(ChessColor us, uint32_t movetime, uint32_t wtime, uint32_t btime, uint32_t winc, uint32_t binc)
-{
-
-    if (movetime != 0) {
-        return movetime;   // think time is explicitly provided
-    }
-
-    const uint32_t remaining_time = (us == ChessColor::WHITE) ? wtime : btime;
-    const uint32_t increment = (us == ChessColor::WHITE) ? winc : binc;
-
-    if (remaining_time >= 60000)   // time >= 1min
-    {
-        return 10000;   // think 5 seconds
-    }
-    else if (remaining_time >= 10000)   // 1min > time >= 10 seconds
-    {
-        return increment && increment < remaining_time ? increment : 3000;   // think the increment time or 3 seconds
-    }
-    else if (remaining_time >= 1000)   // 10 seconds > time >= 1 second
-    {
-        return increment && increment < remaining_time ? increment : 1000;   // think the increment time or 1 seconds
-    }
-    else if (remaining_time >= 200)   // 1 seconds > time >= 0.2 second
-    {
-        return 100;   // think 0.1 seconds
-    }
-    else {
-        return 10;   // think 0.01 seconds
-    }
-
-    return 0;
-}
\ No newline at end of file
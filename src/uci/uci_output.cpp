@@ -0,0 +1,202 @@
+/**
+ * @file uci_output.cpp
+ * @brief uci output implementation.
+ *
+ * Buffered output of the uci, the text is written to stdout by a writer thread.
+ *
+ */
+
+#include "uci_output.hpp"
+#include <cstdio>
+#include <streambuf>
+
+std::thread UciOutput::writerThread;
+std::mutex UciOutput::mutex;
+std::condition_variable UciOutput::pendingCv;
+std::condition_variable UciOutput::writtenCv;
+std::string UciOutput::pending;
+uint64_t UciOutput::enqueuedBytes = 0ULL;
+uint64_t UciOutput::writtenBytes = 0ULL;
+bool UciOutput::running = false;
+
+/**
+ * @brief LineBuffer
+ *
+ * Stream buffer of one thread, the characters are appended to a string until the stream is flushed.
+ *
+ */
+class LineBuffer : public std::streambuf
+{
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            text.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        text.append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+    int sync() override
+    {
+        if (!text.empty()) {
+            UciOutput::write(text);
+            text.clear();
+        }
+        return 0;
+    }
+
+private:
+    std::string text;
+};
+
+/**
+ * @brief uci_out()
+ *
+ * Output stream of the calling thread, the text is kept in a thread local buffer.
+ * std::endl and std::flush hand the text of the buffer to the writer thread without waiting.
+ *
+ * @note use UciOutput::flush() to wait until the text is written.
+ *
+ * @return (std::ostream&) thread local output stream.
+ *
+ */
+std::ostream& uci_out()
+{
+    thread_local LineBuffer buffer;
+    thread_local std::ostream stream(&buffer);
+    return stream;
+}
+
+/**
+ * @brief start()
+ *
+ * Start the writer thread, before it is started the text is written directly.
+ *
+ */
+void UciOutput::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (running) {
+        return;
+    }
+    running = true;
+    writerThread = std::thread(writer_loop);
+}
+
+/**
+ * @brief stop()
+ *
+ * Write all the pending text and finish the writer thread.
+ *
+ */
+void UciOutput::stop()
+{
+    uci_out().flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    pendingCv.notify_one();
+    writerThread.join();
+}
+
+/**
+ * @brief write(const std::string&)
+ *
+ * Hand the text to the writer thread, or write it directly if the writer is not running.
+ *
+ * @param[in] text complete lines of text.
+ *
+ */
+void UciOutput::write(const std::string& text)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (running) {
+            pending += text;
+            enqueuedBytes += text.size();
+        }
+        else {
+            write_to_stdout(text);
+            return;
+        }
+    }
+    pendingCv.notify_one();
+}
+
+/**
+ * @brief flush()
+ *
+ * Hand the buffer of the calling thread to the writer and wait until all the text handed
+ * before the call is written.
+ *
+ */
+void UciOutput::flush()
+{
+    uci_out().flush();
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    const uint64_t target = enqueuedBytes;
+    writtenCv.wait(lock, [target] { return !running || writtenBytes >= target; });
+}
+
+/**
+ * @brief writer_loop()
+ *
+ * Loop of the writer thread, writes all the pending text at once.
+ *
+ */
+void UciOutput::writer_loop()
+{
+    std::string batch;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        pendingCv.wait(lock, [] { return !pending.empty() || !running; });
+
+        if (pending.empty()) {
+            break;   // stopped and everything is written
+        }
+
+        // the producers keep appending to the other buffer while the batch is written
+        batch.swap(pending);
+        lock.unlock();
+
+        write_to_stdout(batch);
+
+        lock.lock();
+        writtenBytes += batch.size();
+        batch.clear();
+        writtenCv.notify_all();
+    }
+    writtenCv.notify_all();
+}
+
+/**
+ * @brief write_to_stdout(const std::string&)
+ *
+ * Write the text to stdout with one write and flush.
+ *
+ * @param[in] text text to write.
+ *
+ */
+void UciOutput::write_to_stdout(const std::string& text)
+{
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    std::fflush(stdout);
+}
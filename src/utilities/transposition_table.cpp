@@ -7,6 +7,7 @@
  */
 
 #include "transposition_table.hpp"
+#include <algorithm>
 
 std::vector<TranspositionTable::Entry> TranspositionTable::entries = initialization();
 
@@ -46,6 +47,34 @@ void TranspositionTable::resize(SIZE new_size_mb)
     entries.resize(static_cast<int>(num_entries));
 }
 
+/**
+ * @brief clear()
+ * 
+ * remove all the entries of the transposition table
+ * 
+ */
+void TranspositionTable::clear() { std::fill(entries.begin(), entries.end(), Entry()); }
+
+/**
+ * @brief hashfull()
+ *
+ * Occupation of the table sampled in the first entries (uci hashfull).
+ * 
+ * @return (int) per mille of the sampled entries in use.
+ */
+int TranspositionTable::hashfull()
+{
+    const uint32_t sample = std::min<uint32_t>(1000U, get_num_entries());
+
+    uint32_t used = 0U;
+    for (uint32_t i = 0; i < sample; i++) {
+        if (entries[i].node_type != NodeType::FAILED) {
+            used++;
+        }
+    }
+    return sample ? static_cast<int>(used * 1000U / sample) : 0;
+}
+
 /**
  * @brief initialization(std::vector<Entry>)
  * 
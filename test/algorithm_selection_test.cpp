@@ -0,0 +1,111 @@
+#include "algorithm_selection.hpp"
+#include "search.hpp"
+#include "perft.hpp"
+#include "transposition_table.hpp"
+#include "test_utils.hpp"
+
+static void algorithm_selection_names_test();
+static void algorithm_selection_move_generator_test();
+static void algorithm_selection_search_test();
+
+void algorithm_selection_test()
+{
+    std::cout << "---------algorithm selection test---------\n\n";
+
+    algorithm_selection_names_test();
+    algorithm_selection_move_generator_test();
+    algorithm_selection_search_test();
+
+    AlgorithmSelection::select(AlgorithmSelection::DEFAULT_SEARCH);
+    AlgorithmSelection::select(AlgorithmSelection::DEFAULT_EVALUATION);
+    AlgorithmSelection::select(AlgorithmSelection::DEFAULT_MOVE_GENERATOR);
+}
+
+static void algorithm_selection_names_test()
+{
+    const std::string test_name = "algorithm_selection_names_test";
+
+    for (const std::string_view name : AlgorithmSelection::SEARCH_NAMES) {
+        if (!AlgorithmSelection::select_by_name<SearchAlgorithm>(name)) {
+            PRINT_TEST_FAILED(test_name, "!select_by_name(" + std::string(name) + ")");
+        }
+        if (AlgorithmSelection::name(AlgorithmSelection::search()) != name) {
+            PRINT_TEST_FAILED(test_name, "name(search()) != " + std::string(name));
+        }
+    }
+
+    AlgorithmSelection::select(EvaluationAlgorithm::NNUE);
+    if (AlgorithmSelection::select_by_name<EvaluationAlgorithm>("material")) {
+        PRINT_TEST_FAILED(test_name, "select_by_name(material)");
+    }
+    if (AlgorithmSelection::evaluation() != EvaluationAlgorithm::NNUE) {
+        PRINT_TEST_FAILED(test_name, "invalid name changed the selection");
+    }
+
+    if (!AlgorithmSelection::select_by_name<MoveGeneratorAlgorithm>("basic") ||
+        AlgorithmSelection::move_generator() != MoveGeneratorAlgorithm::BASIC) {
+        PRINT_TEST_FAILED(test_name, "move_generator() != BASIC");
+    }
+}
+
+static void algorithm_selection_move_generator_test()
+{
+    const std::string test_name = "algorithm_selection_move_generator_test";
+
+    for (const MoveGeneratorAlgorithm algorithm :
+         {MoveGeneratorAlgorithm::BASIC, MoveGeneratorAlgorithm::MAGIC_BITBOARDS}) {
+        AlgorithmSelection::select(algorithm);
+
+        MoveNodesList moveNodesList;
+        int64_t time = 0;
+        uint64_t nodes = 0ULL;
+
+        perft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, moveNodesList, time, false);
+
+        for (const auto& moveNode : moveNodesList) {
+            nodes += moveNode.second;
+        }
+
+        if (nodes != 97862ULL) {
+            PRINT_TEST_FAILED(test_name, std::string(AlgorithmSelection::name(algorithm)) + " perft 3 != 97862");
+        }
+    }
+}
+
+static void algorithm_selection_search_test()
+{
+    const std::string test_name = "algorithm_selection_search_test";
+
+    TranspositionTable::resize(TranspositionTable::SIZE::MB_16);
+
+    for (size_t s = 0; s < AlgorithmSelection::SEARCH_NAMES.size(); s++) {
+        for (size_t e = 0; e < AlgorithmSelection::EVALUATION_NAMES.size(); e++) {
+            for (size_t g = 0; g < AlgorithmSelection::MOVE_GENERATOR_NAMES.size(); g++) {
+                AlgorithmSelection::select(static_cast<SearchAlgorithm>(s));
+                AlgorithmSelection::select(static_cast<EvaluationAlgorithm>(e));
+                AlgorithmSelection::select(static_cast<MoveGeneratorAlgorithm>(g));
+
+                const std::string combination = std::string(AlgorithmSelection::SEARCH_NAMES[s]) + " " +
+                    std::string(AlgorithmSelection::EVALUATION_NAMES[e]) + " " +
+                    std::string(AlgorithmSelection::MOVE_GENERATOR_NAMES[g]);
+
+                Board board;
+                board.load_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+
+                std::atomic<bool> stop(false);
+                SearchResults results;
+                SearchLimits limits;
+                limits.depth = 3;
+
+                search(stop, results, board, limits);
+
+                if (results.bestLine.move != Move(Square::A1, Square::A8)) {
+                    PRINT_TEST_FAILED(test_name, combination + " best move != a1a8");
+                }
+                if (board.fen() != "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1") {
+                    PRINT_TEST_FAILED(test_name, combination + " board not restored");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "batch_evaluation.hpp"
+#include "move_generator.hpp"
+#include "test_utils.hpp"
+#include <random>
+#include <vector>
+
+static void batch_evaluation_start_position_test();
+static void batch_evaluation_random_positions_test();
+
+void batch_evaluation_test()
+{
+    std::cout << "---------batch evaluation test---------\n\n";
+
+    batch_evaluation_start_position_test();
+    batch_evaluation_random_positions_test();
+}
+
+static void batch_evaluation_start_position_test()
+{
+    const std::string test_name = "batch_evaluation_start_position_test";
+
+    Board board;
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+    const CompactPosition position = CompactPosition::from_board(board);
+    int evaluation = -1;
+
+    BatchEvaluation::evaluate(&position, 1U, &evaluation);
+
+    if (evaluation != 0 || BatchEvaluation::evaluate(position) != 0) {
+        PRINT_TEST_FAILED(test_name, "start position evaluation != 0");
+    }
+}
+
+static void batch_evaluation_random_positions_test()
+{
+    const std::string test_name = "batch_evaluation_random_positions_test";
+
+    // not a multiple of BATCH_LANES, the last positions use the scalar kernel
+    constexpr size_t NUM_POSITIONS = 8U * BatchEvaluation::BATCH_LANES + 5U;
+
+    std::mt19937 generator(4242U);
+    std::vector<CompactPosition> positions;
+    std::vector<int> expected;
+    Board board;
+    MoveList moves;
+
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    while (positions.size() < NUM_POSITIONS) {
+        generate_legal_moves<ALL_MOVES>(moves, board);
+        if (moves.size() == 0) {
+            board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+            continue;
+        }
+        board.make_move(moves[generator() % moves.size()]);
+
+        // tapered material + PST score updated incrementally by the board
+        const int32_t score = board.get_pst_score();
+        const int middlegame_percentage = std::min(board.get_game_phase(), MAX_GAME_PHASE);
+        const int endgame_percentage = MAX_GAME_PHASE - middlegame_percentage;
+
+        positions.push_back(CompactPosition::from_board(board));
+        expected.push_back(
+            (middlegame_score(score) * middlegame_percentage + endgame_score(score) * endgame_percentage) /
+            MAX_GAME_PHASE);
+    }
+
+    std::vector<int> evaluations(NUM_POSITIONS);
+    BatchEvaluation::evaluate(positions.data(), positions.size(), evaluations.data());
+
+    for (size_t i = 0; i < NUM_POSITIONS; i++) {
+        if (BatchEvaluation::evaluate(positions[i]) != expected[i]) {
+            PRINT_TEST_FAILED(test_name, "evaluate(position) != board score in position " + std::to_string(i));
+            return;
+        }
+        if (evaluations[i] != expected[i]) {
+            PRINT_TEST_FAILED(test_name, "batch evaluation != board score in position " + std::to_string(i));
+            return;
+        }
+    }
+}
@@ -1,4 +1,6 @@
 #include "board.hpp"
+#include "move_generator.hpp"
+#include "zobrist.hpp"
 #include "test_utils.hpp"
 #include <stack>
 
@@ -19,6 +21,9 @@ static void board_make_unmake_promotion_move_test();
 static void board_make_unmake_move_test();
 static void board_fen_test();
 static void board_initialization_test();
+static void board_in_check_test();
+static void board_move_gives_check_test();
+static void board_incremental_state_test();
 
 void board_test()
 {
@@ -42,6 +47,9 @@ void board_test()
     board_make_unmake_move_test();
     board_fen_test();
     board_initialization_test();
+    board_in_check_test();
+    board_move_gives_check_test();
+    board_incremental_state_test();
 }
 
 static void board_get_piece_test()
@@ -823,4 +831,138 @@ static void board_make_unmake_promotion_move_test()
     if (board.fen() != start_promo_black_fen) {
         PRINT_TEST_FAILED(test_name, "board.fen() != start_promo_black_fen");
     }
-}
\ No newline at end of file
+}
+
+static void board_in_check_test()
+{
+    const std::string test_name = "board_in_check_test";
+
+    Board board;
+
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    if (board.in_check()) {
+        PRINT_TEST_FAILED(test_name, "in_check() in start position");
+    }
+
+    board.load_fen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+    if (!board.in_check()) {
+        PRINT_TEST_FAILED(test_name, "!in_check() with queen check");
+    }
+
+    board.load_fen("4k3/8/5N2/8/8/8/8/4K3 b - - 0 1");
+    if (!board.in_check()) {
+        PRINT_TEST_FAILED(test_name, "!in_check() with knight check");
+    }
+
+    board.load_fen("4k3/3P4/8/8/8/8/8/4K3 b - - 0 1");
+    if (!board.in_check()) {
+        PRINT_TEST_FAILED(test_name, "!in_check() with pawn check");
+    }
+}
+
+static void board_move_gives_check_test()
+{
+    const std::string test_name = "board_move_gives_check_test";
+
+    // direct checks, discovered checks, promotions, en passant and castling
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "4k3/8/8/8/8/8/4N3/4R1K1 w - - 0 1",
+        "4k3/3N4/8/1B6/8/8/8/4K3 w - - 0 1",
+        "3k4/1P6/8/8/8/8/8/4K3 w - - 0 1",
+        "8/8/8/k1pP3R/8/8/8/4K3 w - c6 0 1",
+        "8/8/8/8/8/8/8/R3K2k w Q - 0 1",
+        "5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+        "r3k3/8/8/8/8/8/8/3K4 b q - 0 1",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+    };
+
+    for (const std::string& fen : fens) {
+        Board board;
+        board.load_fen(fen);
+
+        MoveList moves;
+        generate_legal_moves<ALL_MOVES>(moves, board);
+
+        const GameState game_state = board.state();
+
+        for (int i = 0; i < moves.size(); i++) {
+            const bool gives_check = board.move_gives_check(moves[i]);
+
+            board.make_move(moves[i]);
+            const bool check = board.in_check();
+            board.unmake_move(moves[i], game_state);
+
+            if (gives_check != check) {
+                PRINT_TEST_FAILED(test_name, fen + " move_gives_check(" + moves[i].to_string() + ")");
+            }
+        }
+    }
+}
+
+static bool incremental_state_is_correct(const Board& board)
+{
+    int32_t pst_score = 0;
+    int game_phase = 0;
+
+    for (Square square = Square::A1; square.is_valid(); square++) {
+        pst_score += PrecomputedEvalData::get_piece_score(board.get_piece(square), square);
+        game_phase += PrecomputedEvalData::get_phase_weight(board.get_piece(square));
+    }
+
+    return pst_score == board.get_pst_score() && game_phase == board.get_game_phase() &&
+        board.state().get_pawn_key() == Zobrist::pawn_hash(board) &&
+        board.state().get_material_key() == Zobrist::material_hash(board);
+}
+
+static bool incremental_state_walk(Board& board, int depth)
+{
+    if (!incremental_state_is_correct(board)) {
+        return false;
+    }
+    if (depth == 0) {
+        return true;
+    }
+
+    MoveList moves;
+    generate_legal_moves<ALL_MOVES>(moves, board);
+
+    const GameState game_state = board.state();
+
+    for (int i = 0; i < moves.size(); i++) {
+        board.make_move(moves[i]);
+        const bool correct = incremental_state_walk(board, depth - 1);
+        board.unmake_move(moves[i], game_state);
+
+        if (!correct || board.state() != game_state) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void board_incremental_state_test()
+{
+    const std::string test_name = "board_incremental_state_test";
+
+    // start position, castling and en passant, promotions
+    const std::string fens[] = {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"};
+
+    Board board;
+
+    for (const std::string& fen : fens) {
+        board.load_fen(fen);
+
+        if (!incremental_state_walk(board, 3)) {
+            PRINT_TEST_FAILED(test_name,
+                              "incremental pst score, game phase, pawn or material key != recalculated in " + fen);
+        }
+    }
+
+    board.load_fen(fens[0]);
+    if (board.get_pst_score() != 0 || board.get_game_phase() != MAX_GAME_PHASE) {
+        PRINT_TEST_FAILED(test_name, "start position pst score != 0 or game phase != MAX_GAME_PHASE");
+    }
+}
@@ -0,0 +1,120 @@
+#include "eval_cache.hpp"
+#include "test_utils.hpp"
+#include <thread>
+
+static void eval_cache_probe_store_test();
+static void eval_cache_collision_test();
+static void eval_cache_stats_test();
+static void eval_cache_thread_pool_test();
+
+void eval_cache_test()
+{
+    std::cout << "---------eval cache test---------\n\n";
+
+    eval_cache_probe_store_test();
+    eval_cache_collision_test();
+    eval_cache_stats_test();
+    eval_cache_thread_pool_test();
+}
+
+static void eval_cache_probe_store_test()
+{
+    const std::string test_name = "eval_cache_probe_store_test";
+
+    EvalCache cache;
+    int eval = 12345;
+
+    if (cache.probe(0ULL, eval)) {
+        PRINT_TEST_FAILED(test_name, "cache.probe(0ULL, eval) in empty cache");
+    }
+    if (eval != 12345) {
+        PRINT_TEST_FAILED(test_name, "eval written on miss");
+    }
+
+    cache.store(0x1234ULL, -57);
+
+    if (!cache.probe(0x1234ULL, eval) || eval != -57) {
+        PRINT_TEST_FAILED(test_name, "!cache.probe(0x1234ULL, eval) || eval != -57");
+    }
+}
+
+static void eval_cache_collision_test()
+{
+    const std::string test_name = "eval_cache_collision_test";
+
+    EvalCache cache;
+    int eval = 0;
+
+    // same index in the cache, different position
+    const uint64_t key = 0xabcdULL;
+    const uint64_t other_key = key + EvalCache::NUM_ENTRIES;
+
+    cache.store(key, 10);
+
+    if (cache.probe(other_key, eval)) {
+        PRINT_TEST_FAILED(test_name, "cache.probe(other_key, eval) hit with a different key");
+    }
+
+    cache.store(other_key, 20);
+
+    if (cache.probe(key, eval)) {
+        PRINT_TEST_FAILED(test_name, "cache.probe(key, eval) hit after being replaced");
+    }
+    if (!cache.probe(other_key, eval) || eval != 20) {
+        PRINT_TEST_FAILED(test_name, "!cache.probe(other_key, eval) || eval != 20");
+    }
+}
+
+static void eval_cache_stats_test()
+{
+    const std::string test_name = "eval_cache_stats_test";
+
+    EvalCache& cache = EvalCache::thread_cache();
+    int eval = 0;
+
+    EvalCache::clear_stats();
+
+    cache.store(0x5555ULL, 1);
+    cache.probe(0x5555ULL, eval);
+    cache.probe(0x6666ULL, eval);
+
+    if (EvalCache::probes() != 2ULL) {
+        PRINT_TEST_FAILED(test_name, "EvalCache::probes() != 2ULL");
+    }
+    if (EvalCache::hits() != 1ULL) {
+        PRINT_TEST_FAILED(test_name, "EvalCache::hits() != 1ULL");
+    }
+
+    EvalCache::clear_stats();
+
+    if (EvalCache::probes() != 0ULL || EvalCache::hits() != 0ULL) {
+        PRINT_TEST_FAILED(test_name, "stats not cleared");
+    }
+}
+
+static void eval_cache_thread_pool_test()
+{
+    const std::string test_name = "eval_cache_thread_pool_test";
+
+    const EvalCache* main_cache = &EvalCache::thread_cache();
+    const EvalCache* first_cache = nullptr;
+    const EvalCache* second_cache = nullptr;
+
+    if (main_cache != &EvalCache::thread_cache()) {
+        PRINT_TEST_FAILED(test_name, "different cache in the same thread");
+    }
+
+    std::thread first([&first_cache] { first_cache = &EvalCache::thread_cache(); });
+    first.join();
+
+    // the cache of a finished thread is reused by the next thread
+    std::thread second([&second_cache] { second_cache = &EvalCache::thread_cache(); });
+    second.join();
+
+    if (first_cache == main_cache) {
+        PRINT_TEST_FAILED(test_name, "cache shared with a running thread");
+    }
+    if (first_cache != second_cache) {
+        PRINT_TEST_FAILED(test_name, "cache of a finished thread not reused");
+    }
+}
@@ -0,0 +1,169 @@
+#include "evaluation.hpp"
+#include "move_generator.hpp"
+#include "transposition_table.hpp"
+#include "test_utils.hpp"
+
+static void lazy_evaluation_bound_test();
+static void lazy_evaluation_tt_reprobe_test();
+
+static bool check_lazy_stand_pat_reprobe(const std::string& test_name, Board& board);
+
+// big material differences, the side behind has active pieces and the king of the side ahead is exposed
+static const std::string LAZY_EVALUATION_FENS[] = {
+    "1k6/ppp5/8/8/2q5/8/3r4/4K2Q w - - 0 1",
+    "2kr3r/ppp2ppp/2n5/2b1q3/8/8/5PPP/QQ2K2R w K - 0 1",
+    "r3k3/8/8/8/8/8/5PPP/qq1n1RK1 b q - 0 1",
+    "q3k3/1q6/8/2N1B3/8/8/PPP5/1K6 b - - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+};
+
+// narrow windows of the quiescence search stand pat
+static constexpr int LAZY_EVALUATION_WINDOWS[][2] = {{-201, -200}, {-1, 0}, {0, 1}, {200, 201}};
+
+void lazy_evaluation_test()
+{
+    std::cout << "---------lazy evaluation test---------\n\n";
+
+    lazy_evaluation_bound_test();
+    lazy_evaluation_tt_reprobe_test();
+}
+
+static void lazy_evaluation_bound_test()
+{
+    const std::string test_name = "lazy_evaluation_bound_test";
+
+    const uint64_t exits = LazyEvaluation::exits();
+
+    for (const std::string& fen : LAZY_EVALUATION_FENS) {
+        Board board;
+        board.load_fen(fen);
+
+        MoveList moves;
+        generate_legal_moves<ALL_MOVES>(moves, board);
+        const GameState game_state = board.state();
+
+        for (int i = -1; i < moves.size(); i++) {
+            if (i >= 0) {
+                board.make_move(moves[i]);
+            }
+
+            // the lazy evaluations first, the full evaluation is cached and the next evaluations are not lazy
+            int lazy_eval[std::size(LAZY_EVALUATION_WINDOWS)];
+            bool lazy_exit[std::size(LAZY_EVALUATION_WINDOWS)];
+            for (size_t w = 0; w < std::size(LAZY_EVALUATION_WINDOWS); w++) {
+                lazy_eval[w] = evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(
+                    board, LAZY_EVALUATION_WINDOWS[w][0], LAZY_EVALUATION_WINDOWS[w][1], &lazy_exit[w]);
+            }
+
+            const int full_eval = evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(board);
+
+            for (size_t w = 0; w < std::size(LAZY_EVALUATION_WINDOWS); w++) {
+                const int alpha = LAZY_EVALUATION_WINDOWS[w][0];
+                const int beta = LAZY_EVALUATION_WINDOWS[w][1];
+
+                if (!lazy_exit[w]) {
+                    continue;
+                }
+                // a lower bound >= beta or an upper bound <= alpha of the full evaluation
+                if (!(lazy_eval[w] >= beta && full_eval >= lazy_eval[w]) &&
+                    !(lazy_eval[w] <= alpha && full_eval <= lazy_eval[w])) {
+                    PRINT_TEST_FAILED(test_name, board.fen() + " window (" + std::to_string(alpha) + ", " +
+                                                     std::to_string(beta) + ") lazy " +
+                                                     std::to_string(lazy_eval[w]) + " full " +
+                                                     std::to_string(full_eval));
+                }
+            }
+
+            if (i >= 0) {
+                board.unmake_move(moves[i], game_state);
+            }
+        }
+    }
+
+    if (LazyEvaluation::exits() == exits) {
+        PRINT_TEST_FAILED(test_name, "no lazy exits");
+    }
+}
+
+static void lazy_evaluation_tt_reprobe_test()
+{
+    const std::string test_name = "lazy_evaluation_tt_reprobe_test";
+
+    // the entries of the previous tests are deeper and would not be replaced
+    TranspositionTable::clear();
+
+    int num_lazy_stand_pats = 0;
+
+    for (const std::string& fen : LAZY_EVALUATION_FENS) {
+        Board board;
+        board.load_fen(fen);
+
+        MoveList moves;
+        generate_legal_moves<ALL_MOVES>(moves, board);
+        const GameState game_state = board.state();
+
+        // positions of the second ply, not evaluated by the previous test
+        for (int i = 0; i < moves.size(); i++) {
+            board.make_move(moves[i]);
+
+            MoveList next_moves;
+            generate_legal_moves<ALL_MOVES>(next_moves, board);
+            const GameState next_game_state = board.state();
+
+            for (int j = 0; j < next_moves.size(); j++) {
+                board.make_move(next_moves[j]);
+                num_lazy_stand_pats += check_lazy_stand_pat_reprobe(test_name, board) ? 1 : 0;
+                board.unmake_move(next_moves[j], next_game_state);
+            }
+
+            board.unmake_move(moves[i], game_state);
+        }
+    }
+
+    if (num_lazy_stand_pats == 0) {
+        PRINT_TEST_FAILED(test_name, "no lazy stand pat cutoffs");
+    }
+}
+
+/**
+ * @brief stand pat cutoff with a narrow window stored like in the quiescence search, then re-probe the entry
+ *        with the widest window that is still cut by it, the cutoff must agree with the full evaluation.
+ *
+ * @return true if the lazy stand pat was stored and checked.
+ */
+static bool check_lazy_stand_pat_reprobe(const std::string& test_name, Board& board)
+{
+    const uint64_t zobrist_key = board.state().get_zobrist_key();
+
+    bool lazy_exit;
+    const int stand_pat = evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(board, 0, 1, &lazy_exit);
+
+    if (!lazy_exit) {
+        return false;
+    }
+
+    const TranspositionTable::NodeType node_type = stand_pat >= 1 ? TranspositionTable::NodeType::LOWER_BOUND
+                                                                  : TranspositionTable::NodeType::UPPER_BOUND;
+    TranspositionTable::store_quiescence_entry(zobrist_key, stand_pat, Move::null(), node_type, 0);
+
+    // a deeper entry of a previous position of the walk is not replaced
+    const TranspositionTable::Entry entry = TranspositionTable::get_entry(zobrist_key);
+    if (!entry.is_valid()) {
+        return false;
+    }
+
+    const int full_eval = evaluate_position<EvaluationAlgorithm::SAFETY_MOBILITY>(board);
+
+    if (entry.node_type == TranspositionTable::NodeType::LOWER_BOUND && full_eval < entry.evaluation) {
+        PRINT_TEST_FAILED(test_name, board.fen() + " wrong beta cutoff with beta " +
+                                         std::to_string(entry.evaluation) + ", full evaluation " +
+                                         std::to_string(full_eval));
+    }
+    else if (entry.node_type == TranspositionTable::NodeType::UPPER_BOUND && full_eval > entry.evaluation) {
+        PRINT_TEST_FAILED(test_name, board.fen() + " wrong alpha cutoff with alpha " +
+                                         std::to_string(entry.evaluation) + ", full evaluation " +
+                                         std::to_string(full_eval));
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+#include "mate_search.hpp"
+#include "test_utils.hpp"
+
+static void mate_search_mate_in_one_test();
+static void mate_search_mate_in_two_test();
+static void mate_search_no_mate_test();
+
+void mate_search_test()
+{
+
+    std::cout << "---------mate search test---------\n\n";
+
+    mate_search_mate_in_one_test();
+    mate_search_mate_in_two_test();
+    mate_search_no_mate_test();
+}
+
+static void mate_search_mate_in_one_test()
+{
+    const std::string test_name = "mate_search_mate_in_one_test";
+
+    Board board;
+    board.load_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+
+    std::atomic<bool> stop(false);
+    Move pv[MAX_PLY];
+    int pv_length = 0;
+
+    if (MateSearch::find_mate(stop, board, 3, pv, pv_length) != 1) {
+        PRINT_TEST_FAILED(test_name, "find_mate != 1");
+    }
+    if (pv_length != 1 || pv[0] != Move(Square::A1, Square::A8)) {
+        PRINT_TEST_FAILED(test_name, "pv != a1a8");
+    }
+    if (board.fen() != "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1") {
+        PRINT_TEST_FAILED(test_name, "board not restored");
+    }
+}
+
+static void mate_search_mate_in_two_test()
+{
+    const std::string test_name = "mate_search_mate_in_two_test";
+
+    Board board;
+    board.load_fen("r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1");
+
+    std::atomic<bool> stop(false);
+    Move pv[MAX_PLY];
+    int pv_length = 0;
+
+    // Nf6+ gxf6 Bxf7#
+    if (MateSearch::find_mate(stop, board, 5, pv, pv_length) != 2) {
+        PRINT_TEST_FAILED(test_name, "find_mate != 2");
+    }
+    if (pv_length != 3 || pv[0] != Move(Square::D5, Square::F6)) {
+        PRINT_TEST_FAILED(test_name, "pv != d5f6 g7f6 c4f7");
+    }
+}
+
+static void mate_search_no_mate_test()
+{
+    const std::string test_name = "mate_search_no_mate_test";
+
+    Board board;
+    board.load_fen("4r1k1/pp3ppp/8/8/8/8/PPq2PPP/2R2RK1 b - - 0 1");
+
+    std::atomic<bool> stop(false);
+    Move pv[MAX_PLY];
+    int pv_length = 0;
+
+    if (MateSearch::find_mate(stop, board, 4, pv, pv_length) != 0) {
+        PRINT_TEST_FAILED(test_name, "find_mate != 0");
+    }
+    if (pv_length != 0) {
+        PRINT_TEST_FAILED(test_name, "pv_length != 0");
+    }
+}
@@ -0,0 +1,169 @@
+#include "material.hpp"
+#include "test_utils.hpp"
+
+static void material_insufficient_material_test();
+static void material_same_color_bishops_test();
+static void material_kpk_test();
+static void material_kxk_test();
+static void material_scale_factor_test();
+
+void material_test()
+{
+    std::cout << "---------material test---------\n\n";
+
+    material_insufficient_material_test();
+    material_same_color_bishops_test();
+    material_kpk_test();
+    material_kxk_test();
+    material_scale_factor_test();
+}
+
+static void material_insufficient_material_test()
+{
+    const std::string test_name = "material_insufficient_material_test";
+
+    Board board;
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/8 w - - 0 1");
+    if (!is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KK not draw");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/6N1 w - - 0 1");
+    if (!is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KNK not draw");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/6b1 b - - 0 1");
+    if (!is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KKB not draw");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/4P3/8 w - - 0 1");
+    if (is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KPK is draw by material");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/5NN1 w - - 0 1");
+    if (is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KNNK is draw by material, the mate is possible");
+    }
+}
+
+static void material_same_color_bishops_test()
+{
+    const std::string test_name = "material_same_color_bishops_test";
+
+    Board board;
+
+    // c1 and f4 are dark squares
+    board.load_fen("8/8/4k3/8/5b2/3K4/8/2B5 w - - 0 1");
+    if (!is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KBKB same color bishops not draw");
+    }
+
+    // c1 is dark, e4 is light
+    board.load_fen("8/8/4k3/8/4b3/3K4/8/2B5 w - - 0 1");
+    if (is_draw_by_material(board)) {
+        PRINT_TEST_FAILED(test_name, "KBKB opposite color bishops is draw by material");
+    }
+}
+
+static void material_kpk_test()
+{
+    const std::string test_name = "material_kpk_test";
+
+    Board board;
+
+    // king in front of the pawn in the sixth row
+    board.load_fen("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).evaluation(board) < KNOWN_WIN) {
+        PRINT_TEST_FAILED(test_name, "4k3/8/4K3/4P3/8/8/8/8 w not won");
+    }
+
+    // defending king in front of the pawn
+    board.load_fen("8/4k3/4P3/4K3/8/8/8/8 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).evaluation(board) != 0) {
+        PRINT_TEST_FAILED(test_name, "8/4k3/4P3/4K3/8/8/8/8 w not draw");
+    }
+
+    // rook pawn with the defending king in the corner
+    board.load_fen("k7/8/K7/P7/8/8/8/8 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).evaluation(board) != 0) {
+        PRINT_TEST_FAILED(test_name, "k7/8/K7/P7/8/8/8/8 w not draw");
+    }
+
+    // black pawn
+    board.load_fen("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1");
+    if (MaterialTable::thread_table().probe(board).evaluation(board) > -KNOWN_WIN) {
+        PRINT_TEST_FAILED(test_name, "8/8/8/8/4p3/4k3/8/4K3 b not won by black");
+    }
+
+    // the pawn can not be stopped
+    if (!kpk_probe(Square::A1, Square::H5, Square::A8, ChessColor::WHITE)) {
+        PRINT_TEST_FAILED(test_name, "kpk_probe(a1, h5, a8, white) not won");
+    }
+}
+
+static void material_kxk_test()
+{
+    const std::string test_name = "material_kxk_test";
+
+    Board board;
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/7R w - - 0 1");
+    const MaterialEntry& rook_entry = MaterialTable::thread_table().probe(board);
+    if (rook_entry.evaluation == nullptr || rook_entry.evaluation(board) < KNOWN_WIN) {
+        PRINT_TEST_FAILED(test_name, "KRK not won");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/7q b - - 0 1");
+    const MaterialEntry& queen_entry = MaterialTable::thread_table().probe(board);
+    if (queen_entry.evaluation == nullptr || queen_entry.evaluation(board) > -KNOWN_WIN) {
+        PRINT_TEST_FAILED(test_name, "KKQ not won by black");
+    }
+
+    // the lone king is closer to the edge
+    board.load_fen("8/8/4k3/8/8/3K4/8/7R w - - 0 1");
+    const int center_eval = MaterialTable::thread_table().probe(board).evaluation(board);
+    board.load_fen("4k3/8/8/8/8/3K4/8/7R w - - 0 1");
+    const int edge_eval = MaterialTable::thread_table().probe(board).evaluation(board);
+    if (edge_eval <= center_eval) {
+        PRINT_TEST_FAILED(test_name, "KRK edge_eval <= center_eval");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/2B2N2 w - - 0 1");
+    const MaterialEntry& bishop_knight_entry = MaterialTable::thread_table().probe(board);
+    if (bishop_knight_entry.evaluation == nullptr || bishop_knight_entry.evaluation(board) < KNOWN_WIN) {
+        PRINT_TEST_FAILED(test_name, "KBNK not won");
+    }
+}
+
+static void material_scale_factor_test()
+{
+    const std::string test_name = "material_scale_factor_test";
+
+    Board board;
+
+    // a minor piece of advantage without pawns can not win
+    board.load_fen("8/8/4k3/4r3/8/3K4/8/1R3N2 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).scale_factor(board, ChessColor::WHITE) >= SCALE_FACTOR_NORMAL) {
+        PRINT_TEST_FAILED(test_name, "KRNKR not scaled");
+    }
+
+    board.load_fen("8/8/4k3/8/8/3K4/8/5NN1 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).scale_factor(board, ChessColor::WHITE) != SCALE_FACTOR_DRAW) {
+        PRINT_TEST_FAILED(test_name, "KNNK not scaled to draw");
+    }
+
+    // opposite color bishops with pawns
+    board.load_fen("8/5p2/4k3/8/4b3/3K4/4P3/2B5 w - - 0 1");
+    if (MaterialTable::thread_table().probe(board).scale_factor(board, ChessColor::WHITE) >= SCALE_FACTOR_NORMAL) {
+        PRINT_TEST_FAILED(test_name, "opposite color bishops not scaled");
+    }
+
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    if (MaterialTable::thread_table().probe(board).scale_factor(board, ChessColor::WHITE) != SCALE_FACTOR_NORMAL) {
+        PRINT_TEST_FAILED(test_name, "start position scaled");
+    }
+}
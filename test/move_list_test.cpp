@@ -7,6 +7,7 @@ static void move_list_clear_test();
 static void move_list_size_test();
 static void move_list_get_test();
 static void move_list_to_string_test();
+static void move_list_filter_test();
 
 void move_list_test()
 {
@@ -18,6 +19,7 @@ void move_list_test()
     move_list_size_test();
     move_list_get_test();
     move_list_to_string_test();
+    move_list_filter_test();
 }
 
 
@@ -103,3 +105,23 @@ static void move_list_to_string_test()
         PRINT_TEST_FAILED(test_name, "to_string() != b2b4:\nd2d1q:\ne1c1:");
     }
 }
+
+static void move_list_filter_test()
+{
+    const std::string test_name = "move_list_filter_test";
+
+    MoveList moves;
+
+    moves.add(Move(Square::B2, Square::B4));
+    moves.add(Move(Square::G1, Square::F3));
+    moves.add(Move(Square::E2, Square::E4));
+
+    moves.filter([](const Move& move) { return move.square_from() != Square::G1; });
+
+    if (moves.size() != 2) {
+        PRINT_TEST_FAILED(test_name, "moves.size() != 2");
+    }
+    if (moves.get(0) != Move(Square::B2, Square::B4) || moves.get(1) != Move(Square::E2, Square::E4)) {
+        PRINT_TEST_FAILED(test_name, "filter did not preserve the order of the kept moves");
+    }
+}
@@ -0,0 +1,163 @@
+#include "nnue.hpp"
+#include "move_generator.hpp"
+#include "test_utils.hpp"
+#include <random>
+#include <sstream>
+
+static std::unique_ptr<NnueNetwork> random_network();
+static void nnue_feature_index_test();
+static void nnue_read_write_test();
+static void nnue_incremental_test();
+static void nnue_symmetry_test();
+
+void nnue_test()
+{
+    std::cout << "---------nnue test---------\n\n";
+
+    nnue_feature_index_test();
+    Nnue::set_network(random_network());
+    nnue_read_write_test();
+    nnue_incremental_test();
+    nnue_symmetry_test();
+}
+
+static std::unique_ptr<NnueNetwork> random_network()
+{
+    std::unique_ptr<NnueNetwork> network = std::make_unique<NnueNetwork>();
+    std::mt19937 generator(12345U);
+    std::uniform_int_distribution<int> feature_weight(-24, 24);
+    std::uniform_int_distribution<int> hidden_weight(-40, 40);
+    std::uniform_int_distribution<int> bias(0, 2000);
+
+    for (int16_t& weight : network->featureBiases) {
+        weight = static_cast<int16_t>(feature_weight(generator) + 40);
+    }
+    for (int16_t& weight : network->featureWeights) {
+        weight = static_cast<int16_t>(feature_weight(generator));
+    }
+    for (int32_t& weight : network->hidden1Biases) {
+        weight = bias(generator);
+    }
+    for (int8_t& weight : network->hidden1Weights) {
+        weight = static_cast<int8_t>(hidden_weight(generator));
+    }
+    for (int32_t& weight : network->hidden2Biases) {
+        weight = bias(generator);
+    }
+    for (int8_t& weight : network->hidden2Weights) {
+        weight = static_cast<int8_t>(hidden_weight(generator));
+    }
+    network->outputBias = bias(generator);
+    for (int8_t& weight : network->outputWeights) {
+        weight = static_cast<int8_t>(hidden_weight(generator));
+    }
+
+    return network;
+}
+
+static void nnue_feature_index_test()
+{
+    const std::string test_name = "nnue_feature_index_test";
+
+    // black sees the board flipped, with its pieces as own pieces
+    if (Nnue::feature_index(ChessColor::WHITE, Square::E1, Piece::W_PAWN, Square::E2) !=
+        Nnue::feature_index(ChessColor::BLACK, Square::E8, Piece::B_PAWN, Square::E7)) {
+        PRINT_TEST_FAILED(test_name, "white e1 pawn e2 != black e8 pawn e7");
+    }
+    if (Nnue::feature_index(ChessColor::WHITE, Square::G1, Piece::B_QUEEN, Square::D8) !=
+        Nnue::feature_index(ChessColor::BLACK, Square::G8, Piece::W_QUEEN, Square::D1)) {
+        PRINT_TEST_FAILED(test_name, "white g1 queen d8 != black g8 queen d1");
+    }
+    if (Nnue::feature_index(ChessColor::WHITE, Square::H8, Piece::B_QUEEN, Square::H8) !=
+        NnueNetwork::INPUT_DIMENSIONS - 1U) {
+        PRINT_TEST_FAILED(test_name, "last feature != INPUT_DIMENSIONS - 1");
+    }
+    if (Nnue::feature_index(ChessColor::WHITE, Square::A1, Piece::W_PAWN, Square::A1) != 0U) {
+        PRINT_TEST_FAILED(test_name, "first feature != 0");
+    }
+}
+
+static void nnue_read_write_test()
+{
+    const std::string test_name = "nnue_read_write_test";
+
+    std::unique_ptr<NnueNetwork> network = random_network();
+    std::unique_ptr<NnueNetwork> copy = std::make_unique<NnueNetwork>();
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+    if (!network->write(stream)) {
+        PRINT_TEST_FAILED(test_name, "network->write(stream) failed");
+    }
+    if (!copy->read(stream)) {
+        PRINT_TEST_FAILED(test_name, "copy->read(stream) failed");
+    }
+    if (copy->featureWeights[12345] != network->featureWeights[12345] ||
+        copy->outputBias != network->outputBias || copy->outputWeights[31] != network->outputWeights[31]) {
+        PRINT_TEST_FAILED(test_name, "copy != network");
+    }
+
+    std::stringstream invalid(std::string("ADCNNUE0 not a network"), std::ios::in | std::ios::binary);
+    if (copy->read(invalid)) {
+        PRINT_TEST_FAILED(test_name, "copy->read(invalid) succeeded");
+    }
+
+    if (Nnue::load("this_file_does_not_exist.nnue") || !Nnue::is_loaded()) {
+        PRINT_TEST_FAILED(test_name, "Nnue::load of a missing file changed the network");
+    }
+}
+
+static void nnue_incremental_test()
+{
+    const std::string test_name = "nnue_incremental_test";
+
+    Board board;
+    board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // random walk with king moves, castles, captures and promotions
+    std::mt19937 generator(777U);
+    MoveList moves;
+
+    for (int ply = 0; ply < 60; ply++) {
+
+        if (Nnue::evaluate(board) != Nnue::evaluate_refresh(board)) {
+            PRINT_TEST_FAILED(test_name, "evaluate != evaluate_refresh in " + board.fen());
+            return;
+        }
+
+        generate_legal_moves<ALL_MOVES>(moves, board);
+        if (moves.size() == 0) {
+            board.load_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+            continue;
+        }
+
+        const Move move = moves[generator() % moves.size()];
+        const GameState state = board.state();
+
+        // evaluate the child and go back, the accumulators must follow the unmake too
+        board.make_move(move);
+        Nnue::evaluate(board);
+        board.unmake_move(move, state);
+
+        if (Nnue::evaluate(board) != Nnue::evaluate_refresh(board)) {
+            PRINT_TEST_FAILED(test_name, "evaluate != evaluate_refresh after unmake in " + board.fen());
+            return;
+        }
+
+        board.make_move(move);
+    }
+}
+
+static void nnue_symmetry_test()
+{
+    const std::string test_name = "nnue_symmetry_test";
+
+    Board board;
+    Board mirrored;
+
+    board.load_fen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    mirrored.load_fen("rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3");
+
+    if (Nnue::evaluate(board) != -Nnue::evaluate(mirrored)) {
+        PRINT_TEST_FAILED(test_name, "evaluate(board) != -evaluate(mirrored)");
+    }
+}
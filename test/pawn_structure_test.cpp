@@ -0,0 +1,162 @@
+#include "pawn_structure.hpp"
+#include "move_generator.hpp"
+#include "zobrist.hpp"
+#include "test_utils.hpp"
+
+static void pawn_structure_cached_entry_test();
+static void pawn_structure_promotion_key_test();
+static void pawn_structure_en_passant_key_test();
+
+static bool cached_entry_walk(Board& board, int depth);
+static void check_special_moves_pawn_key(const std::string& test_name, const std::string& fen, MoveType move_type);
+
+void pawn_structure_test()
+{
+    std::cout << "---------pawn structure test---------\n\n";
+
+    pawn_structure_cached_entry_test();
+    pawn_structure_promotion_key_test();
+    pawn_structure_en_passant_key_test();
+}
+
+static void pawn_structure_cached_entry_test()
+{
+    const std::string test_name = "pawn_structure_cached_entry_test";
+
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    };
+
+    PawnHashTable::clear_stats();
+
+    for (const std::string& fen : fens) {
+        Board board;
+        board.load_fen(fen);
+
+        if (!cached_entry_walk(board, 2)) {
+            PRINT_TEST_FAILED(test_name, fen + " cached pawn entry != calculated pawn entry");
+        }
+    }
+
+    // the positions of the walk share pawn structures, the entries are reused
+    if (PawnHashTable::hits() == 0ULL) {
+        PRINT_TEST_FAILED(test_name, "PawnHashTable::hits() == 0");
+    }
+}
+
+static void pawn_structure_promotion_key_test()
+{
+    const std::string test_name = "pawn_structure_promotion_key_test";
+
+    // promotions with and without capture, both colors
+    check_special_moves_pawn_key(test_name, "1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1", MoveType::PROMOTION);
+    check_special_moves_pawn_key(test_name, "4k3/8/8/8/8/8/1p6/R3K3 b - - 0 1", MoveType::PROMOTION);
+    check_special_moves_pawn_key(test_name, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q2/PPPBBPpP/R3K2R b KQkq - 0 1",
+                                 MoveType::PROMOTION);
+}
+
+static void pawn_structure_en_passant_key_test()
+{
+    const std::string test_name = "pawn_structure_en_passant_key_test";
+
+    check_special_moves_pawn_key(test_name, "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", MoveType::EN_PASSANT);
+    check_special_moves_pawn_key(test_name, "4k3/8/8/8/3Pp3/8/8/4K3 b - d3 0 1", MoveType::EN_PASSANT);
+    check_special_moves_pawn_key(test_name, "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+                                 MoveType::EN_PASSANT);
+}
+
+/**
+ * @brief probe the thread table in all the positions of the walk, the entry and the king shelter must be
+ *        equal to the ones calculated in an empty table.
+ */
+static bool cached_entry_walk(Board& board, int depth)
+{
+    PawnEntry& cached = PawnHashTable::thread_table().probe(board);
+    const int32_t cached_shelter = king_shelter(cached, board);
+
+    PawnHashTable empty_table;
+    PawnEntry& calculated = empty_table.probe(board);
+    const int32_t calculated_shelter = king_shelter(calculated, board);
+
+    for (int c = 0; c < 2; c++) {
+        if (cached.semiOpenFiles[c] != calculated.semiOpenFiles[c] ||
+            cached.passedPawns[c] != calculated.passedPawns[c] ||
+            cached.pawnAttacks[c] != calculated.pawnAttacks[c] ||
+            cached.pawnAttacksSpan[c] != calculated.pawnAttacksSpan[c]) {
+            return false;
+        }
+    }
+    if (cached.key != calculated.key || cached.score != calculated.score || cached_shelter != calculated_shelter ||
+        rooks_on_open_files(cached, board) != rooks_on_open_files(calculated, board)) {
+        return false;
+    }
+
+    if (depth == 0) {
+        return true;
+    }
+
+    MoveList moves;
+    generate_legal_moves<ALL_MOVES>(moves, board);
+
+    const GameState game_state = board.state();
+
+    for (int i = 0; i < moves.size(); i++) {
+        board.make_move(moves[i]);
+        const bool correct = cached_entry_walk(board, depth - 1);
+        board.unmake_move(moves[i], game_state);
+
+        if (!correct) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief make the moves of the type, the pawn key must be equal to the key of the position loaded from its fen
+ *        and be restored by unmake_move.
+ */
+static void check_special_moves_pawn_key(const std::string& test_name, const std::string& fen, MoveType move_type)
+{
+    Board board;
+    board.load_fen(fen);
+
+    MoveList moves;
+    generate_legal_moves<ALL_MOVES>(moves, board);
+
+    const GameState game_state = board.state();
+    int num_moves = 0;
+
+    for (int i = 0; i < moves.size(); i++) {
+        if (moves[i].type() != move_type) {
+            continue;
+        }
+        num_moves++;
+
+        board.make_move(moves[i]);
+
+        Board loaded_board;
+        loaded_board.load_fen(board.fen());
+
+        if (board.state().get_pawn_key() != loaded_board.state().get_pawn_key()) {
+            PRINT_TEST_FAILED(test_name, fen + " " + moves[i].to_string() + " pawn key != pawn key of the fen");
+        }
+        if (board.state().get_pawn_key() != Zobrist::pawn_hash(board)) {
+            PRINT_TEST_FAILED(test_name, fen + " " + moves[i].to_string() + " pawn key != Zobrist::pawn_hash");
+        }
+
+        board.unmake_move(moves[i], game_state);
+
+        if (board.state().get_pawn_key() != game_state.get_pawn_key()) {
+            PRINT_TEST_FAILED(test_name, fen + " " + moves[i].to_string() + " pawn key not restored");
+        }
+    }
+
+    if (num_moves == 0) {
+        PRINT_TEST_FAILED(test_name, fen + " no moves of the tested type");
+    }
+}
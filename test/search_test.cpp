@@ -1,180 +1,334 @@
 #include "search.hpp"
 #include "move_generator.hpp"
-#include "evaluation.hpp"
+#include "algorithm_selection.hpp"
+#include "transposition_table.hpp"
 #include "test_utils.hpp"
-#include "history.hpp"
 
-static void search_compare_with_minimax_test(const std::string& fen, const int depth);
+static void search_pv_test();
+static void search_root_moves_order_test();
+static void search_multipv_test();
+static void search_searchmoves_test();
+static void search_nodes_limit_test();
 
-template<SearchType searchType>
-static int minimax(Board& board, int depth, int ply, Move& best_global_move, int& best_global_eval);
-template<SearchType searchType>
-static int quiescence_minimax(Board& board, int ply, Move& best_global_move, int& best_global_eval);
+static bool pv_is_legal(const std::string& fen, const Move* pv, int pv_length);
+static void search_position(const std::string& fen, const SearchLimits& limits, SearchResults& results);
+
+static const std::string SEARCH_TEST_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+};
 
 void search_test()
 {
     std::cout << "---------search test---------\n\n";
 
-    const std::string fens[5] = {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
-                                 "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
-                                 "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
-                                 "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
-                                 "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1"};
+    TranspositionTable::resize(TranspositionTable::SIZE::MB_16);
 
-    for (const std::string& fen : fens) {
-        for (int depth = 1; depth <= 3; depth++) {
-            search_compare_with_minimax_test(fen, depth);
-        }
-    }
+    search_pv_test();
+    search_root_moves_order_test();
+    search_multipv_test();
+    search_searchmoves_test();
+    search_nodes_limit_test();
+
+    AlgorithmSelection::select(AlgorithmSelection::DEFAULT_SEARCH);
 }
 
-static void search_compare_with_minimax_test(const std::string& fen, const int depth)
+static void search_pv_test()
 {
-    const std::string test_name = "search_compare_with_minimax_test_depth: " + std::to_string(depth);
-    SearchResults searchResults;
-    Board board;
-    board.load_fen(fen);
+    const std::string test_name = "search_pv_test";
 
-    const ChessColor side_to_move = board.state().side_to_move();
+    for (size_t s = 0; s < AlgorithmSelection::SEARCH_NAMES.size(); s++) {
+        AlgorithmSelection::select(static_cast<SearchAlgorithm>(s));
 
-    search_best_move(searchResults, board, depth);
+        for (const std::string& fen : SEARCH_TEST_FENS) {
+            const std::string search_fen = std::string(AlgorithmSelection::SEARCH_NAMES[s]) + " " + fen;
 
-    Move best_minimax_move = Move::null();
-    int best_minimax_eval = is_white(side_to_move) ? -INF_EVAL : +INF_EVAL;
+            SearchResults results;
+            SearchLimits limits;
+            limits.depth = 4;
 
-    History::clear();
+            search_position(fen, limits, results);
 
-    is_white(side_to_move) ? minimax<MAXIMIZE_WHITE>(board, depth, 0, best_minimax_move, best_minimax_eval)
-                           : minimax<MINIMIZE_BLACK>(board, depth, 0, best_minimax_move, best_minimax_eval);
+            const SearchInfo& best_line = results.bestLine;
 
-    Move best_search_move(searchResults.results[depth - 1].bestMove_data);
-    int best_search_eval = searchResults.results[depth - 1].evaluation;
+            if (best_line.pvLength == 0 || best_line.pv[0] != best_line.move) {
+                PRINT_TEST_FAILED(test_name, search_fen + " pv does not start with the best move");
+            }
+            if (!pv_is_legal(fen, best_line.pv, best_line.pvLength)) {
+                PRINT_TEST_FAILED(test_name, search_fen + " best line pv is not legal");
+            }
 
-    if (best_search_move != best_minimax_move) {
-        PRINT_TEST_FAILED(test_name, "best_search_move != best_minimax_move");
-    }
-    if (best_search_eval != best_minimax_eval) {
-        PRINT_TEST_FAILED(test_name, "best_search_eval != best_minimax_eval");
+            // every iteration reports a legal pv that starts with its best move
+            SearchInfo info;
+            while (results.infos.pop(info)) {
+                if (info.type != SearchInfo::Type::ITERATION) {
+                    continue;
+                }
+                if (info.pvLength == 0 || info.pv[0] != info.move) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " depth " + std::to_string(info.depth) +
+                                                     " pv does not start with the best move");
+                }
+                if (!pv_is_legal(fen, info.pv, info.pvLength)) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " depth " + std::to_string(info.depth) +
+                                                     " pv is not legal");
+                }
+            }
+        }
     }
 }
 
-template<SearchType searchType>
-static int minimax(Board& board, int depth, int ply, Move& best_global_move, int& best_global_eval)
+static void search_root_moves_order_test()
 {
-    constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
-    constexpr bool MINIMIZING_BLACK = searchType == MINIMIZE_BLACK;
+    const std::string test_name = "search_root_moves_order_test";
 
-    const uint64_t zobrist_key = board.state().get_zobrist_key();
+    Board board;
+    board.load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
     MoveList moves;
-    bool isCheck;
-    generate_legal_moves<ALL_MOVES>(moves, board, &isCheck);
-    const bool isCheckMate = isCheck && moves.size() == 0;
-    const bool isStaleMate = !isCheck && moves.size() == 0;
-    const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
-    const bool fify_move_rule_draw = fifty_move_rule_counter >= 100U;
-
-    if (isCheckMate) {
-        // we substract ply so checkMate in less moves has a higher score
-        if constexpr (MAXIMIZE_WHITE) {
-            return -(MATE_IN_ONE_SCORE - ply);
+    generate_legal_moves<ALL_MOVES>(moves, board);
+
+    RootMoves root_moves;
+    root_moves.init(moves, MoveList());
+
+    SearchStackFrame child;
+    child.pvLength = 0;
+
+    // first iteration, two moves improve and the rest have the same score
+    root_moves.new_iteration<MAXIMIZE_WHITE>();
+    for (int i = 0; i < root_moves.size(); i++) {
+        root_moves.update(i, i == 5 ? 100 : i == 10 ? 50 : 0, 10ULL, child);
+    }
+    root_moves.sort<MAXIMIZE_WHITE>();
+
+    // the best moves first, the rest in the generation order
+    std::vector<Move> first_order = {moves[5], moves[10]};
+    for (int i = 0; i < moves.size(); i++) {
+        if (i != 5 && i != 10) {
+            first_order.push_back(moves[i]);
         }
-        else if constexpr (MINIMIZE_BLACK) {
-            return MATE_IN_ONE_SCORE - ply;
+    }
+
+    for (int i = 0; i < root_moves.size(); i++) {
+        if (root_moves[i].move != first_order[i]) {
+            PRINT_TEST_FAILED(test_name, "order != best moves first and the rest in the previous order");
+            break;
         }
     }
-    else if (isStaleMate || History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw) {
-        return 0;
+
+    // second iteration, all the moves have the same score, the order of the previous iteration is kept
+    root_moves.new_iteration<MAXIMIZE_WHITE>();
+    for (int i = 0; i < root_moves.size(); i++) {
+        root_moves.update(i, 0, 10ULL, child);
     }
+    root_moves.sort<MAXIMIZE_WHITE>();
 
-    else if (depth == 0) {
-        return quiescence_minimax<searchType>(board, ply, best_global_move, best_global_eval);
+    for (int i = 0; i < root_moves.size(); i++) {
+        if (root_moves[i].move != first_order[i]) {
+            PRINT_TEST_FAILED(test_name, "order changed with equal scores in the next iteration");
+            break;
+        }
     }
 
-    int final_node_evaluation = MAXIMIZING_WHITE ? -INF_EVAL : +INF_EVAL;
+    if (root_moves[0].previousScore != 100 || root_moves[0].nodes != 20ULL) {
+        PRINT_TEST_FAILED(test_name, "previousScore != 100 || nodes != 20");
+    }
 
-    const GameState game_state = board.state();
+    // the next iteration searches the moves in the sorted order
+    MoveList next_moves;
+    root_moves.copy_moves(next_moves);
 
-    for (int i = 0; i < moves.size(); i++) {
+    for (int i = 0; i < next_moves.size(); i++) {
+        if (next_moves[i] != first_order[i]) {
+            PRINT_TEST_FAILED(test_name, "copy_moves does not keep the sorted order");
+            break;
+        }
+    }
 
-        constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
+    // black minimizes, the lowest score is searched first
+    root_moves.new_iteration<MINIMIZE_BLACK>();
+    for (int i = 0; i < root_moves.size(); i++) {
+        root_moves.update(i, i == 3 ? -100 : 0, 10ULL, child);
+    }
+    root_moves.sort<MINIMIZE_BLACK>();
 
-        History::push_position(zobrist_key);
-        board.make_move(moves[i]);
-        int eval = minimax<nextSearchType>(board, depth - 1, ply + 1, best_global_move, best_global_eval);
-        board.unmake_move(moves[i], game_state);
-        History::pop_position();
+    if (root_moves[0].move != first_order[3] || root_moves[1].move != first_order[0]) {
+        PRINT_TEST_FAILED(test_name, "black best move is not searched first");
+    }
+}
 
-        if constexpr (MAXIMIZING_WHITE) {
+static void search_multipv_test()
+{
+    const std::string test_name = "search_multipv_test";
 
-            if (ply == 0 && eval > best_global_eval) {
-                best_global_eval = eval;
-                best_global_move = moves[i];   // if we are in the root node update the best move
-            }
+    constexpr int MULTI_PV = 3;
+    constexpr uint32_t DEPTH = 4;
 
-            final_node_evaluation = std::max(final_node_evaluation, eval);
-        }
-        else if (MINIMIZING_BLACK) {
+    for (size_t s = 0; s < AlgorithmSelection::SEARCH_NAMES.size(); s++) {
+        AlgorithmSelection::select(static_cast<SearchAlgorithm>(s));
+
+        for (const std::string& fen : SEARCH_TEST_FENS) {
+            const std::string search_fen = std::string(AlgorithmSelection::SEARCH_NAMES[s]) + " " + fen;
+
+            SearchResults results;
+            SearchLimits limits;
+            limits.depth = DEPTH;
+            limits.multiPV = MULTI_PV;
+
+            search_position(fen, limits, results);
 
-            if (ply == 0 && eval < best_global_eval) {
-                best_global_eval = eval;
-                best_global_move = moves[i];   // if we are in the root node update the best move
+            // lines of the last iteration, indexed by multipv
+            SearchInfo lines[MULTI_PV + 1];
+            bool found[MULTI_PV + 1] = {};
+
+            SearchInfo info;
+            while (results.infos.pop(info)) {
+                if (info.type == SearchInfo::Type::ITERATION && info.depth == DEPTH &&
+                    info.bound == ScoreBound::EXACT && 1 <= info.multiPV && info.multiPV <= MULTI_PV) {
+                    lines[info.multiPV] = info;
+                    found[info.multiPV] = true;
+                }
+            }
+
+            Board board;
+            board.load_fen(fen);
+            const bool white = is_white(board.state().side_to_move());
+
+            for (int pv = 1; pv <= MULTI_PV; pv++) {
+                if (!found[pv]) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " multipv " + std::to_string(pv) + " not reported");
+                    continue;
+                }
+                if (!pv_is_legal(fen, lines[pv].pv, lines[pv].pvLength)) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " multipv " + std::to_string(pv) + " pv is not legal");
+                }
+                if (pv == 1) {
+                    continue;
+                }
+                for (int previous = 1; previous < pv; previous++) {
+                    if (found[previous] && lines[previous].move == lines[pv].move) {
+                        PRINT_TEST_FAILED(test_name, search_fen + " multipv lines with the same move");
+                    }
+                }
+                if (found[pv - 1] && (white ? lines[pv - 1].evaluation < lines[pv].evaluation
+                                            : lines[pv - 1].evaluation > lines[pv].evaluation)) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " multipv " + std::to_string(pv) + " better than " +
+                                                     std::to_string(pv - 1));
+                }
             }
 
-            final_node_evaluation = std::min(final_node_evaluation, eval);
+            if (found[1] && lines[1].move != results.bestLine.move) {
+                PRINT_TEST_FAILED(test_name, search_fen + " best move != multipv 1");
+            }
         }
     }
-    return final_node_evaluation;
 }
 
-template<SearchType searchType>
-static int quiescence_minimax(Board& board, int ply, Move& best_global_move, int& best_global_eval)
+static void search_searchmoves_test()
 {
-    constexpr bool MAXIMIZING_WHITE = searchType == MAXIMIZE_WHITE;
-    constexpr bool MINIMIZING_BLACK = searchType == MINIMIZE_BLACK;
+    const std::string test_name = "search_searchmoves_test";
 
-    const uint64_t zobrist_key = board.state().get_zobrist_key();
+    const std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-    const uint8_t fifty_move_rule_counter = board.state().fifty_move_rule_counter();
-    const bool fify_move_rule_draw = fifty_move_rule_counter >= 100U;
+    for (size_t s = 0; s < AlgorithmSelection::SEARCH_NAMES.size(); s++) {
+        AlgorithmSelection::select(static_cast<SearchAlgorithm>(s));
 
-    if (History::threefold_repetition_detected(fifty_move_rule_counter) || fify_move_rule_draw) {
-        return 0;
-    }
+        const std::string search_name(AlgorithmSelection::SEARCH_NAMES[s]);
 
-    int static_evaluation = evaluate_position(board);
+        SearchResults results;
+        SearchLimits limits;
+        limits.depth = 4;
+        limits.multiPV = 3;   // more lines than searchmoves, only the searchmoves are reported
+        limits.searchMoves.add(Move(Square::A2, Square::A3));
+        limits.searchMoves.add(Move(Square::H2, Square::H3));
 
-    if (ply >= MAX_PLY) {
-        return static_evaluation;
-    }
+        search_position(fen, limits, results);
 
-    MoveList capture_moves;
-    generate_legal_moves<ONLY_CAPTURES>(capture_moves, board);
+        if (!limits.searchMoves.contains(results.bestLine.move)) {
+            PRINT_TEST_FAILED(test_name, search_name + " best move is not one of the searchmoves");
+        }
 
-    if (capture_moves.size() == 0) {
-        return static_evaluation;   // No captures: return static evaluation
+        SearchInfo info;
+        while (results.infos.pop(info)) {
+            if (!limits.searchMoves.contains(info.move)) {
+                PRINT_TEST_FAILED(test_name, search_name + " searched move " + info.move.to_string());
+            }
+            if (info.type == SearchInfo::Type::ITERATION && info.multiPV > 2) {
+                PRINT_TEST_FAILED(test_name, search_name + " multipv > number of searchmoves");
+            }
+        }
     }
+}
+
+static void search_nodes_limit_test()
+{
+    const std::string test_name = "search_nodes_limit_test";
 
-    const GameState game_state = board.state();
-    int final_node_evaluation = static_evaluation;
+    // the limit is polled in every node, the nodes entered while the search unwinds are the only slack
+    constexpr uint64_t NODES_SLACK = MAX_PLY;
 
-    for (int i = 0; i < capture_moves.size(); i++) {
+    for (size_t s = 0; s < AlgorithmSelection::SEARCH_NAMES.size(); s++) {
+        AlgorithmSelection::select(static_cast<SearchAlgorithm>(s));
 
-        constexpr SearchType nextSearchType = MAXIMIZING_WHITE ? MINIMIZE_BLACK : MAXIMIZE_WHITE;
+        for (const uint64_t nodes_limit : {1000ULL, 20000ULL}) {
+            for (const std::string& fen : SEARCH_TEST_FENS) {
+                const std::string search_fen = std::string(AlgorithmSelection::SEARCH_NAMES[s]) + " nodes " +
+                    std::to_string(nodes_limit) + " " + fen;
 
-        History::push_position(zobrist_key);
-        board.make_move(capture_moves[i]);
-        int eval = quiescence_minimax<nextSearchType>(board, ply + 1, best_global_move, best_global_eval);
-        board.unmake_move(capture_moves[i], game_state);
-        History::pop_position();
+                SearchResults results;
+                SearchLimits limits;
+                limits.nodes = nodes_limit;
 
-        if constexpr (MAXIMIZING_WHITE) {
-            final_node_evaluation = std::max(final_node_evaluation, eval);
+                search_position(fen, limits, results);
+
+                if (results.nodes < nodes_limit || results.nodes > nodes_limit + NODES_SLACK) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " searched " + std::to_string(results.nodes.load()) +
+                                                     " nodes");
+                }
+                if (!results.bestLine.move.is_valid() || !pv_is_legal(fen, &results.bestLine.move, 1)) {
+                    PRINT_TEST_FAILED(test_name, search_fen + " no legal best move");
+                }
+            }
         }
-        else if constexpr (MINIMIZING_BLACK) {
-            final_node_evaluation = std::min(final_node_evaluation, eval);
+    }
+}
+
+/**
+ * @brief play the pv from the position, every move must be legal in the position reached by the previous moves.
+ */
+static bool pv_is_legal(const std::string& fen, const Move* pv, int pv_length)
+{
+    Board board;
+    board.load_fen(fen);
+
+    for (int i = 0; i < pv_length; i++) {
+        MoveList moves;
+        generate_legal_moves<ALL_MOVES>(moves, board);
+
+        if (!moves.contains(pv[i])) {
+            return false;
         }
+
+        board.make_move(pv[i]);
     }
 
-    return final_node_evaluation;
-}
\ No newline at end of file
+    return true;
+}
+
+/**
+ * @brief search the position with the selected algorithms and check that the board is restored.
+ */
+static void search_position(const std::string& fen, const SearchLimits& limits, SearchResults& results)
+{
+    Board board;
+    board.load_fen(fen);
+
+    std::atomic<bool> stop(false);
+
+    search(stop, results, board, limits);
+
+    if (board.fen() != fen) {
+        PRINT_TEST_FAILED("search_position", fen + " board not restored after the search");
+    }
+}
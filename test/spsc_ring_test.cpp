@@ -0,0 +1,140 @@
+#include "test_utils.hpp"
+#include "spsc_ring.hpp"
+#include <thread>
+
+static void spsc_ring_empty_test();
+static void spsc_ring_push_pop_test();
+static void spsc_ring_full_test();
+static void spsc_ring_wrap_around_test();
+static void spsc_ring_two_threads_test();
+
+void spsc_ring_test()
+{
+    std::cout << "---------spsc_ring test---------\n\n";
+
+    spsc_ring_empty_test();
+    spsc_ring_push_pop_test();
+    spsc_ring_full_test();
+    spsc_ring_wrap_around_test();
+    spsc_ring_two_threads_test();
+}
+
+static void spsc_ring_empty_test()
+{
+    const std::string test_name = "spsc_ring_empty_test";
+
+    SpscRing<int, 4> ring;
+    int element = 0;
+
+    if (!ring.empty()) {
+        PRINT_TEST_FAILED(test_name, "!ring.empty()");
+    }
+    if (ring.pop(element)) {
+        PRINT_TEST_FAILED(test_name, "ring.pop(element) in empty ring");
+    }
+}
+
+static void spsc_ring_push_pop_test()
+{
+    const std::string test_name = "spsc_ring_push_pop_test";
+
+    SpscRing<int, 4> ring;
+    int element = 0;
+
+    ring.push(1);
+    ring.push(2);
+
+    if (ring.empty()) {
+        PRINT_TEST_FAILED(test_name, "ring.empty()");
+    }
+    if (!ring.pop(element) || element != 1) {
+        PRINT_TEST_FAILED(test_name, "first pop != 1");
+    }
+    if (!ring.pop(element) || element != 2) {
+        PRINT_TEST_FAILED(test_name, "second pop != 2");
+    }
+    if (!ring.empty()) {
+        PRINT_TEST_FAILED(test_name, "!ring.empty()");
+    }
+}
+
+static void spsc_ring_full_test()
+{
+    const std::string test_name = "spsc_ring_full_test";
+
+    SpscRing<int, 4> ring;
+    int element = 0;
+
+    for (int i = 0; i < 4; i++) {
+        if (!ring.push(i)) {
+            PRINT_TEST_FAILED(test_name, "push failed before the ring is full");
+        }
+    }
+    if (ring.push(4)) {
+        PRINT_TEST_FAILED(test_name, "push succeeded in a full ring");
+    }
+
+    ring.pop(element);
+
+    if (!ring.push(4)) {
+        PRINT_TEST_FAILED(test_name, "push failed after pop");
+    }
+}
+
+static void spsc_ring_wrap_around_test()
+{
+    const std::string test_name = "spsc_ring_wrap_around_test";
+
+    SpscRing<int, 4> ring;
+    int element = 0;
+
+    for (int i = 0; i < 100; i++) {
+        ring.push(i);
+        ring.push(i + 1000);
+
+        if (!ring.pop(element) || element != i) {
+            PRINT_TEST_FAILED(test_name, "pop != " + std::to_string(i));
+        }
+        if (!ring.pop(element) || element != i + 1000) {
+            PRINT_TEST_FAILED(test_name, "pop != " + std::to_string(i + 1000));
+        }
+    }
+}
+
+static void spsc_ring_two_threads_test()
+{
+    const std::string test_name = "spsc_ring_two_threads_test";
+
+    constexpr int NUM_ELEMENTS = 100000;
+    SpscRing<int, 64> ring;
+
+    std::thread producer([&ring]() {
+        for (int i = 0; i < NUM_ELEMENTS; i++) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int element = 0;
+    bool in_order = true;
+
+    while (expected < NUM_ELEMENTS) {
+        if (ring.pop(element)) {
+            in_order = in_order && element == expected;
+            expected++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    if (!in_order) {
+        PRINT_TEST_FAILED(test_name, "elements received out of order");
+    }
+    if (!ring.empty()) {
+        PRINT_TEST_FAILED(test_name, "!ring.empty()");
+    }
+}
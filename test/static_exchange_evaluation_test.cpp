@@ -0,0 +1,83 @@
+#include "static_exchange_evaluation.hpp"
+#include "test_utils.hpp"
+
+static void static_exchange_evaluation_free_capture_test();
+static void static_exchange_evaluation_defended_capture_test();
+static void static_exchange_evaluation_xray_test();
+static void static_exchange_evaluation_king_recapture_test();
+
+void static_exchange_evaluation_test()
+{
+
+    std::cout << "---------static exchange evaluation test---------\n\n";
+
+    static_exchange_evaluation_free_capture_test();
+    static_exchange_evaluation_defended_capture_test();
+    static_exchange_evaluation_xray_test();
+    static_exchange_evaluation_king_recapture_test();
+}
+
+static void static_exchange_evaluation_free_capture_test()
+{
+    const std::string test_name = "static_exchange_evaluation_free_capture_test";
+
+    Board board;
+    board.load_fen("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+
+    const Move rook_takes_pawn(Square::E1, Square::E5);
+
+    if (static_exchange_evaluation(board, rook_takes_pawn) != 100) {
+        PRINT_TEST_FAILED(test_name, "static_exchange_evaluation(Re1xe5) != 100");
+    }
+    if (!see_greater_equal(board, rook_takes_pawn, 0)) {
+        PRINT_TEST_FAILED(test_name, "!see_greater_equal(Re1xe5, 0)");
+    }
+}
+
+static void static_exchange_evaluation_defended_capture_test()
+{
+    const std::string test_name = "static_exchange_evaluation_defended_capture_test";
+
+    Board board;
+    board.load_fen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+
+    const Move knight_takes_pawn(Square::D3, Square::E5);
+
+    // NxP, NxN, RxN, BxR, QxB, RxQ... white loses the knight for a pawn
+    if (static_exchange_evaluation(board, knight_takes_pawn) != -220) {
+        PRINT_TEST_FAILED(test_name, "static_exchange_evaluation(Nd3xe5) != -220");
+    }
+    if (see_greater_equal(board, knight_takes_pawn, 0)) {
+        PRINT_TEST_FAILED(test_name, "see_greater_equal(Nd3xe5, 0)");
+    }
+}
+
+static void static_exchange_evaluation_xray_test()
+{
+    const std::string test_name = "static_exchange_evaluation_xray_test";
+
+    Board board;
+    board.load_fen("3rk3/8/3n4/8/8/8/3R4/3RK3 w - - 0 1");
+
+    const Move rook_takes_knight(Square::D2, Square::D6);
+
+    // the second rook recaptures through x-ray
+    if (static_exchange_evaluation(board, rook_takes_knight) != 320) {
+        PRINT_TEST_FAILED(test_name, "static_exchange_evaluation(Rd2xd6) != 320");
+    }
+}
+
+static void static_exchange_evaluation_king_recapture_test()
+{
+    const std::string test_name = "static_exchange_evaluation_king_recapture_test";
+
+    Board board;
+    board.load_fen("8/8/8/3k4/4p3/8/4R3/4RK2 w - - 0 1");
+
+    const Move rook_takes_pawn(Square::E2, Square::E4);
+
+    // the king can not recapture because the square is defended by the other rook
+    if (static_exchange_evaluation(board, rook_takes_pawn) != 100) {
+        PRINT_TEST_FAILED(test_name, "static_exchange_evaluation(Re2xe4) != 100");
+    }
+}
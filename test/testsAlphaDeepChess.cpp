@@ -11,7 +11,20 @@
 #include "diagonal_test.cpp"
 #include "zobrist_test.cpp"
 #include "transposition_table_test.cpp"
-//#include "search_test.cpp"
+#include "static_exchange_evaluation_test.cpp"
+#include "mate_search_test.cpp"
+#include "spsc_ring_test.cpp"
+#include "eval_cache_test.cpp"
+#include "material_test.cpp"
+#include "pawn_structure_test.cpp"
+#include "lazy_evaluation_test.cpp"
+#include "nnue_test.cpp"
+#include "batch_evaluation_test.cpp"
+#include "algorithm_selection_test.cpp"
+#include "time_manager_test.cpp"
+#include "uci_output_test.cpp"
+#include "uci_test.cpp"
+#include "search_test.cpp"
 
 int main()
 {
@@ -28,7 +41,20 @@ int main()
     zobrist_test();
     transposition_table_test();
     move_generator_test();
-    //search_test();
+    static_exchange_evaluation_test();
+    mate_search_test();
+    spsc_ring_test();
+    eval_cache_test();
+    material_test();
+    pawn_structure_test();
+    lazy_evaluation_test();
+    nnue_test();
+    batch_evaluation_test();
+    algorithm_selection_test();
+    time_manager_test();
+    uci_output_test();
+    uci_test();
+    search_test();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "time_manager.hpp"
+#include "test_utils.hpp"
+#include <thread>
+
+static void time_manager_sudden_death_test();
+static void time_manager_moves_to_go_test();
+static void time_manager_max_time_fraction_test();
+static void time_manager_movetime_test();
+static void time_manager_single_legal_move_test();
+
+void time_manager_test()
+{
+    std::cout << "---------time manager test---------\n\n";
+
+    time_manager_sudden_death_test();
+    time_manager_moves_to_go_test();
+    time_manager_max_time_fraction_test();
+    time_manager_movetime_test();
+    time_manager_single_legal_move_test();
+}
+
+static void time_manager_sudden_death_test()
+{
+    const std::string test_name = "time_manager_sudden_death_test";
+
+    TimeManager time_manager;
+
+    // 40 moves to go: (60000 - 10 * 41) / 40 = 1489, maximum 5 optimum times
+    time_manager.init(60000U, 0U, 0U, 0U, 10U, false);
+
+    if (time_manager.optimum() != 1489ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 1489");
+    }
+    if (time_manager.maximum() != 7445ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 7445");
+    }
+
+    // increment of the 39 next moves: (60000 + 1000 * 39 - 10 * 41) / 40 = 2464
+    time_manager.init(60000U, 1000U, 0U, 0U, 10U, false);
+
+    if (time_manager.optimum() != 2464ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 2464 with increment");
+    }
+    if (time_manager.maximum() != 12320ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 12320 with increment");
+    }
+}
+
+static void time_manager_moves_to_go_test()
+{
+    const std::string test_name = "time_manager_moves_to_go_test";
+
+    TimeManager time_manager;
+
+    // (10000 - 100 * 11) / 10 = 890
+    time_manager.init(10000U, 0U, 10U, 0U, 100U, false);
+
+    if (time_manager.optimum() != 890ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 890");
+    }
+    if (time_manager.maximum() != 4450ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 4450");
+    }
+
+    // moves to go is limited to 50: (100000 - 10 * 51) / 50 = 1989
+    time_manager.init(100000U, 0U, 80U, 0U, 10U, false);
+
+    if (time_manager.optimum() != 1989ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 1989 with 80 moves to go");
+    }
+
+    // the overhead is bigger than the clock, at least 1 ms
+    time_manager.init(50U, 0U, 10U, 0U, 100U, false);
+
+    if (time_manager.optimum() != 1ULL || time_manager.maximum() != 1ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 1 || maximum() != 1 without time");
+    }
+}
+
+static void time_manager_max_time_fraction_test()
+{
+    const std::string test_name = "time_manager_max_time_fraction_test";
+
+    TimeManager time_manager;
+
+    // optimum (10000 + 1000 * 9) / 10 = 1900, maximum 5 * 1900 capped to 0.8 * 10000
+    time_manager.init(10000U, 1000U, 10U, 0U, 0U, false);
+
+    if (time_manager.optimum() != 1900ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 1900");
+    }
+    if (time_manager.maximum() != 8000ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 8000");
+    }
+
+    // last move before the time control, the optimum is limited by the maximum: 0.8 * 1000 - 10
+    time_manager.init(1000U, 0U, 1U, 0U, 10U, false);
+
+    if (time_manager.maximum() != 790ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 790 with 1 move to go");
+    }
+    if (time_manager.optimum() != 790ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 790 with 1 move to go");
+    }
+}
+
+static void time_manager_movetime_test()
+{
+    const std::string test_name = "time_manager_movetime_test";
+
+    TimeManager time_manager;
+
+    // movetime ignores the clock
+    time_manager.init(60000U, 1000U, 0U, 5000U, 10U, false);
+
+    if (time_manager.optimum() != 4990ULL || time_manager.maximum() != 4990ULL) {
+        PRINT_TEST_FAILED(test_name, "optimum() != 4990 || maximum() != 4990");
+    }
+    if (time_manager.stop_after_iteration(Move(Square::E2, Square::E4), 0, 10ULL, 100ULL, 20)) {
+        PRINT_TEST_FAILED(test_name, "stop_after_iteration with movetime");
+    }
+
+    // the overhead is bigger than the movetime, at least 1 ms
+    time_manager.init(0U, 0U, 0U, 5U, 10U, false);
+
+    if (time_manager.maximum() != 1ULL) {
+        PRINT_TEST_FAILED(test_name, "maximum() != 1");
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    if (!time_manager.hard_limit_reached()) {
+        PRINT_TEST_FAILED(test_name, "!hard_limit_reached()");
+    }
+}
+
+static void time_manager_single_legal_move_test()
+{
+    const std::string test_name = "time_manager_single_legal_move_test";
+
+    TimeManager time_manager;
+    const Move move(Square::E1, Square::F1);
+
+    time_manager.init(60000U, 0U, 0U, 0U, 10U, false);
+
+    if (time_manager.stop_after_iteration(move, 0, 10ULL, 100ULL, 20)) {
+        PRINT_TEST_FAILED(test_name, "stop_after_iteration with 20 legal moves");
+    }
+
+    time_manager.init(60000U, 0U, 0U, 0U, 10U, false);
+
+    if (!time_manager.stop_after_iteration(move, 0, 100ULL, 100ULL, 1)) {
+        PRINT_TEST_FAILED(test_name, "!stop_after_iteration with 1 legal move");
+    }
+
+    // pondering, the time limits apply after ponderhit
+    time_manager.init(60000U, 0U, 0U, 0U, 10U, true);
+
+    if (time_manager.stop_after_iteration(move, 0, 100ULL, 100ULL, 1)) {
+        PRINT_TEST_FAILED(test_name, "stop_after_iteration with 1 legal move while pondering");
+    }
+
+    time_manager.ponderhit();
+
+    if (!time_manager.stop_after_iteration(move, 0, 100ULL, 100ULL, 1)) {
+        PRINT_TEST_FAILED(test_name, "!stop_after_iteration with 1 legal move after ponderhit");
+    }
+}
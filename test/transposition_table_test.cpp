@@ -4,6 +4,8 @@
 static void transposition_table_resize_test();
 static void transposition_entry_test();
 static void transposition_table_get_entry_test();
+static void transposition_table_quiescence_entry_test();
+static void transposition_table_clear_test();
 
 void transposition_table_test()
 {
@@ -13,6 +15,8 @@ void transposition_table_test()
     transposition_table_resize_test();
     transposition_entry_test();
     transposition_table_get_entry_test();
+    transposition_table_quiescence_entry_test();
+    transposition_table_clear_test();
 }
 
 static void transposition_table_resize_test()
@@ -107,4 +111,63 @@ static void transposition_table_get_entry_test()
             PRINT_TEST_FAILED(test_name, "readed_entry != test_entry");
         }
     }
-}
\ No newline at end of file
+}
+static void transposition_table_quiescence_entry_test()
+{
+    const std::string test_name = "transposition_table_quiescence_entry_test";
+
+    const uint64_t num_entries = TranspositionTable::get_num_entries();
+    const uint64_t key = 0x1234ULL;
+    const uint64_t same_index_key = key + num_entries;   // different key, same index in the table
+
+    const TranspositionTable::Entry main_entry(key, 50, Move(3ULL), TranspositionTable::NodeType::EXACT, 5);
+    TranspositionTable::store_entry(main_entry);
+
+    // quiescence entries of the same position and of a colliding position
+    TranspositionTable::store_quiescence_entry(key, 10, Move::null(), TranspositionTable::NodeType::LOWER_BOUND, 0);
+    TranspositionTable::store_quiescence_entry(same_index_key, 20, Move::null(),
+                                               TranspositionTable::NodeType::UPPER_BOUND, -1);
+
+    if (TranspositionTable::get_entry(key) != main_entry) {
+        PRINT_TEST_FAILED(test_name, "depth 5 entry replaced by a quiescence entry");
+    }
+    if (TranspositionTable::get_entry(same_index_key).is_valid()) {
+        PRINT_TEST_FAILED(test_name, "colliding quiescence entry stored");
+    }
+
+    // quiescence entries replace other quiescence entries
+    const TranspositionTable::Entry qs_entry(key, 10, Move::null(), TranspositionTable::NodeType::EXACT, 0);
+    TranspositionTable::store_entry(qs_entry);
+    TranspositionTable::store_quiescence_entry(same_index_key, 20, Move::null(),
+                                               TranspositionTable::NodeType::UPPER_BOUND, -1, 15);
+
+    const TranspositionTable::Entry readed_entry = TranspositionTable::get_entry(same_index_key);
+
+    if (!readed_entry.is_valid() || readed_entry.evaluation != 20 || readed_entry.static_eval != 15) {
+        PRINT_TEST_FAILED(test_name, "quiescence entry not stored over a depth 0 entry");
+    }
+
+    // the main search always replaces
+    TranspositionTable::store_entry(main_entry);
+
+    if (TranspositionTable::get_entry(key) != main_entry) {
+        PRINT_TEST_FAILED(test_name, "get_entry(key) != main_entry");
+    }
+}
+
+static void transposition_table_clear_test()
+{
+    const std::string test_name = "transposition_table_clear_test";
+
+    const uint64_t key = 0x5678ULL;
+
+    TranspositionTable::store_entry(key, 100, Move(Square::E2, Square::E4), TranspositionTable::NodeType::EXACT, 5);
+    TranspositionTable::clear();
+
+    if (TranspositionTable::get_entry(key).is_valid()) {
+        PRINT_TEST_FAILED(test_name, "tt.get_entry(key).is_valid() after clear");
+    }
+    if (TranspositionTable::hashfull() != 0) {
+        PRINT_TEST_FAILED(test_name, "tt.hashfull() != 0 after clear");
+    }
+}
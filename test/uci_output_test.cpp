@@ -0,0 +1,123 @@
+#include "uci_output.hpp"
+#include "test_utils.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define fileno _fileno
+#define close _close
+#else
+#include <unistd.h>
+#endif
+
+static void uci_output_two_threads_test();
+
+static std::string read_file(const std::string& path);
+
+void uci_output_test()
+{
+    std::cout << "---------uci output test---------\n\n";
+
+    uci_output_two_threads_test();
+}
+
+static void uci_output_two_threads_test()
+{
+    const std::string test_name = "uci_output_two_threads_test";
+
+    constexpr int NUM_LINES = 2000;
+    const std::string path = "uci_output_test.txt";
+
+    // the writer thread writes to stdout, redirect it to a file
+    std::cout.flush();
+    std::fflush(stdout);
+    const int stdout_fd = dup(fileno(stdout));
+
+    if (stdout_fd < 0 || std::freopen(path.c_str(), "w", stdout) == nullptr) {
+        PRINT_TEST_FAILED(test_name, "stdout can not be redirected");
+        return;
+    }
+
+    UciOutput::start();
+
+    // both threads write long lines in several pieces, the lines must not be split or mixed
+    auto writer = [](char thread_id) {
+        for (int i = 0; i < NUM_LINES; i++) {
+            uci_out() << "info thread " << thread_id << " line " << i << " pv";
+            for (int j = 0; j < 16; j++) {
+                uci_out() << " e2e4";
+            }
+            uci_out() << std::endl;
+        }
+    };
+
+    std::thread thread_a(writer, 'a');
+    std::thread thread_b(writer, 'b');
+    thread_a.join();
+    thread_b.join();
+
+    // every line was handed to the writer, after flush all of them are in the file
+    UciOutput::flush();
+    const std::string flushed_text = read_file(path);
+
+    UciOutput::stop();
+
+    std::fflush(stdout);
+    dup2(stdout_fd, fileno(stdout));
+    close(stdout_fd);
+
+    const std::string text = read_file(path);
+    std::remove(path.c_str());
+
+    if (flushed_text != text) {
+        PRINT_TEST_FAILED(test_name, "text written after flush()");
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    int next_line[2] = {0, 0};
+
+    while (std::getline(lines, line)) {
+        char thread_id = ' ';
+        int line_number = -1;
+        std::string pv;
+
+        std::istringstream tokens(line);
+        std::string info, thread, line_token;
+        tokens >> info >> thread >> thread_id >> line_token >> line_number >> pv;
+
+        int num_moves = 0;
+        std::string move;
+        while (tokens >> move) {
+            num_moves += move == "e2e4" ? 1 : 0;
+        }
+
+        if (info != "info" || (thread_id != 'a' && thread_id != 'b') || pv != "pv" || num_moves != 16) {
+            PRINT_TEST_FAILED(test_name, "split or mixed line: " + line);
+            return;
+        }
+
+        // the lines of each thread keep their order
+        if (line_number != next_line[thread_id - 'a']) {
+            PRINT_TEST_FAILED(test_name, "line out of order: " + line);
+            return;
+        }
+        next_line[thread_id - 'a']++;
+    }
+
+    if (next_line[0] != NUM_LINES || next_line[1] != NUM_LINES) {
+        PRINT_TEST_FAILED(test_name, "lines lost");
+    }
+}
+
+static std::string read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
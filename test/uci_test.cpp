@@ -0,0 +1,135 @@
+#include "uci.hpp"
+#include "history.hpp"
+#include "test_utils.hpp"
+#include <vector>
+
+static void uci_position_extend_moves_test();
+static void uci_position_different_fen_test();
+static void uci_position_shorter_moves_test();
+static void uci_position_startpos_fen_test();
+static void uci_position_repetition_test();
+
+static void check_incremental_position(const std::string& test_name, const std::vector<std::string>& commands);
+
+static const std::string KIWIPETE_FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+void uci_test()
+{
+    std::cout << "---------uci test---------\n\n";
+
+    uci_position_extend_moves_test();
+    uci_position_different_fen_test();
+    uci_position_shorter_moves_test();
+    uci_position_startpos_fen_test();
+    uci_position_repetition_test();
+}
+
+static void uci_position_extend_moves_test()
+{
+    const std::string test_name = "uci_position_extend_moves_test";
+
+    check_incremental_position(test_name, {"position startpos moves e2e4",
+                                           "position startpos moves e2e4 e7e5 g1f3"});
+
+    check_incremental_position(test_name, {"position startpos",
+                                           "position startpos moves d2d4",
+                                           "position startpos moves d2d4 g8f6 c2c4 e7e6"});
+
+    check_incremental_position(test_name, {"position fen " + KIWIPETE_FEN + " moves e1g1",
+                                           "position fen " + KIWIPETE_FEN + " moves e1g1 e8c8 d5e6"});
+}
+
+static void uci_position_different_fen_test()
+{
+    const std::string test_name = "uci_position_different_fen_test";
+
+    check_incremental_position(test_name, {"position startpos moves e2e4 e7e5",
+                                           "position fen " + KIWIPETE_FEN + " moves e1g1"});
+
+    check_incremental_position(test_name, {"position fen " + KIWIPETE_FEN + " moves e1g1",
+                                           "position startpos moves e2e4 e7e5"});
+}
+
+static void uci_position_shorter_moves_test()
+{
+    const std::string test_name = "uci_position_shorter_moves_test";
+
+    // the board is rebuilt, the moves can not be undone
+    check_incremental_position(test_name, {"position startpos moves e2e4 e7e5 g1f3",
+                                           "position startpos moves e2e4 e7e5"});
+
+    check_incremental_position(test_name, {"position startpos moves e2e4 e7e5 g1f3", "position startpos"});
+
+    // same number of moves but a different game
+    check_incremental_position(test_name, {"position startpos moves e2e4 e7e5",
+                                           "position startpos moves d2d4 d7d5"});
+
+    check_incremental_position(test_name, {"position startpos moves e2e4 e7e5",
+                                           "position startpos moves d2d4 d7d5 c2c4"});
+}
+
+static void uci_position_startpos_fen_test()
+{
+    const std::string test_name = "uci_position_startpos_fen_test";
+
+    const std::string start_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    check_incremental_position(test_name, {"position startpos moves e2e4",
+                                           "position fen " + start_fen + " moves e2e4 e7e5"});
+
+    check_incremental_position(test_name, {"position fen " + start_fen + " moves e2e4",
+                                           "position startpos moves e2e4 e7e5"});
+
+    // extra spaces between the tokens
+    check_incremental_position(test_name, {"position startpos moves e2e4",
+                                           "position  fen " + start_fen + "  moves  e2e4 e7e5"});
+}
+
+static void uci_position_repetition_test()
+{
+    const std::string test_name = "uci_position_repetition_test";
+
+    // the history of the positions is extended like the board, the repetition must be detected
+    check_incremental_position(test_name, {"position startpos moves g1f3 g8f6",
+                                           "position startpos moves g1f3 g8f6 f3g1 f6g8",
+                                           "position startpos moves g1f3 g8f6 f3g1 f6g8 g1f3 g8f6"});
+
+    check_incremental_position(test_name, {"position startpos moves g1f3 g8f6 f3g1 f6g8 g1f3 g8f6",
+                                           "position startpos moves g1f3 g8f6"});
+}
+
+/**
+ * @brief send the position commands to the same uci, the board must be equal to the board of a new uci
+ *        that only receives the last command.
+ */
+static void check_incremental_position(const std::string& test_name, const std::vector<std::string>& commands)
+{
+    std::string fen;
+    uint64_t zobrist;
+    bool repetition;
+
+    {
+        Uci uci;
+        for (const std::string& command : commands) {
+            uci.execute_command(command);
+        }
+        fen = uci.get_board().fen();
+        zobrist = uci.get_board().state().get_zobrist_key();
+        repetition = History::threefold_repetition_detected(uci.get_board().state().fifty_move_rule_counter());
+    }
+
+    Uci uci;
+    uci.execute_command(commands.back());
+
+    const Board& board = uci.get_board();
+
+    if (board.fen() != fen) {
+        PRINT_TEST_FAILED(test_name, commands.back() + " fen " + fen + " != " + board.fen());
+    }
+    if (board.state().get_zobrist_key() != zobrist) {
+        PRINT_TEST_FAILED(test_name, commands.back() + " zobrist key != zobrist key of a new position");
+    }
+    if (History::threefold_repetition_detected(board.state().fifty_move_rule_counter()) != repetition) {
+        PRINT_TEST_FAILED(test_name, commands.back() + " history != history of a new position");
+    }
+}